@@ -0,0 +1,85 @@
+// Cost of passing assertions in a tight loop (native).
+//
+// Every benchmark operation checks the same eight values:
+//   compare_only           the floor: eight compares feeding one counter
+//   assert_equal_int       eight TEST_ASSERT_EQUAL_INT_DEBUG; failure handling
+//                          is out of line, the pass path is a compare and a
+//                          counter increment
+//   inline_failure_branch  eight assertions written the old way, with the
+//                          failure handling (counters, Unity flag toggle,
+//                          printf) expanded at every call site
+//
+// Build from the library root (one command):
+//   g++ -O2 -std=c++17 -pthread -DCONFIGMGR_NATIVE -I<unity>/src -Isrc
+//       examples/assertion_cost/assertion_cost.cpp src/enhanced_unity.cpp
+//       <unity>/src/unity.c -o assertion_cost
+//   ./assertion_cost
+//
+// The fast path is identical in the last two; the difference is the code the
+// failure branches put between the compares, which is what a loop of many
+// assertions pays for in I-cache and branch predictor entries.
+
+#include <enhanced_unity.hpp>
+
+extern "C" void setUp(void) {}
+extern "C" void tearDown(void) {}
+
+// Reloaded from memory by every operation (DO_NOT_OPTIMIZE clobbers memory)
+static int source[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+static int inlineFailures = 0;
+
+// The pre-outlining assertion shape, kept here only for comparison
+#define INLINE_FAILURE_ASSERT_EQUAL_INT(expected, actual) \
+    do { \
+        ::enhanced_unity::countAssertion(); \
+        int _expected = (expected); \
+        int _actual = (actual); \
+        if (_expected != _actual) { \
+            ::enhanced_unity::countAssertionFailure(); \
+            inlineFailures++; \
+            Unity.CurrentTestFailed = 1; \
+            Unity.CurrentTestFailed = 0; \
+            printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_EQUAL_INT(%d, %d)\n", __LINE__, _expected, _actual); \
+            printf("             expected %d, actual %d (%s:%d)\n", _expected, _actual, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+ENHANCED_UNITY_BENCHMARK(compare_only) {
+    ENHANCED_UNITY_DO_NOT_OPTIMIZE(source);
+    int matches = 0;
+    matches += source[0] == 1;
+    matches += source[1] == 2;
+    matches += source[2] == 3;
+    matches += source[3] == 4;
+    matches += source[4] == 5;
+    matches += source[5] == 6;
+    matches += source[6] == 7;
+    matches += source[7] == 8;
+    ENHANCED_UNITY_DO_NOT_OPTIMIZE(matches);
+}
+
+ENHANCED_UNITY_BENCHMARK(assert_equal_int) {
+    ENHANCED_UNITY_DO_NOT_OPTIMIZE(source);
+    TEST_ASSERT_EQUAL_INT_DEBUG(1, source[0]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(2, source[1]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(3, source[2]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(4, source[3]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(5, source[4]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(6, source[5]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(7, source[6]);
+    TEST_ASSERT_EQUAL_INT_DEBUG(8, source[7]);
+}
+
+ENHANCED_UNITY_BENCHMARK(inline_failure_branch) {
+    ENHANCED_UNITY_DO_NOT_OPTIMIZE(source);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(1, source[0]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(2, source[1]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(3, source[2]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(4, source[3]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(5, source[4]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(6, source[5]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(7, source[6]);
+    INLINE_FAILURE_ASSERT_EQUAL_INT(8, source[7]);
+}
+
+ENHANCED_UNITY_MAIN()
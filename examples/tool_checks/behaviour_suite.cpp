@@ -0,0 +1,99 @@
+// Registered suite for the behaviour checks in run.sh (native).
+//
+// run.sh builds it three ways (plain, ENHANCED_UNITY_PARALLEL and
+// ENHANCED_UNITY_PROCESS_POOL) together with behaviour_suite_more.cpp, and
+// picks the tests of each check by tag; the results it asserts on are noted
+// next to the tests. Several tests fail, crash or hang on purpose, so no run
+// selects everything.
+
+#include <enhanced_unity.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+extern "C" void setUp(void) {}
+extern "C" void tearDown(void) {}
+
+// ---- parallel: 8 tests of 3 assertions each, all counted once ----
+
+#define BEHAVIOUR_PARALLEL_TEST(name, value) \
+    ENHANCED_UNITY_TEST_TAGGED(name, "parallel") { \
+        std::this_thread::sleep_for(std::chrono::milliseconds(5)); \
+        TEST_ASSERT_EQUAL_INT_DEBUG((value), (value)); \
+        TEST_ASSERT_TRUE_DEBUG((value) > 0); \
+        TEST_ASSERT_NOT_EQUAL_DEBUG(0, (value)); \
+    }
+
+BEHAVIOUR_PARALLEL_TEST(parallel_1, 1)
+BEHAVIOUR_PARALLEL_TEST(parallel_2, 2)
+BEHAVIOUR_PARALLEL_TEST(parallel_3, 3)
+BEHAVIOUR_PARALLEL_TEST(parallel_4, 4)
+BEHAVIOUR_PARALLEL_TEST(parallel_5, 5)
+BEHAVIOUR_PARALLEL_TEST(parallel_6, 6)
+BEHAVIOUR_PARALLEL_TEST(parallel_7, 7)
+BEHAVIOUR_PARALLEL_TEST(parallel_8, 8)
+
+// ---- process pool: one crash and one hang booked as aborted, one pass ----
+
+ENHANCED_UNITY_TEST_TAGGED(pool_crash, "pool") {
+    TEST_ASSERT_TRUE_DEBUG(true);
+    abort();
+}
+
+ENHANCED_UNITY_TEST_TAGGED(pool_hang, "pool,timeout=200") {
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+ENHANCED_UNITY_TEST_TAGGED(pool_pass, "pool") { TEST_ASSERT_EQUAL_INT_DEBUG(4, 2 + 2); }
+
+// ---- result cache: the keyed passing test is skipped on the second run ----
+
+ENHANCED_UNITY_TEST_KEYED(cache_keyed_pass, "cache", "behaviour-1") { TEST_ASSERT_TRUE_DEBUG(true); }
+ENHANCED_UNITY_TEST_KEYED(cache_keyed_fail, "cache", "behaviour-1") { TEST_ASSERT_EQUAL_INT_DEBUG(1, 2); }
+ENHANCED_UNITY_TEST_TAGGED(cache_unkeyed, "cache") { TEST_ASSERT_TRUE_DEBUG(true); }
+
+// ---- bulk scope: 1000 checks, 20 failing; 2 recorded inline plus the
+// ENHANCED_UNITY_BULK_SAMPLES (8) sampled at the end, one assertion ----
+
+ENHANCED_UNITY_TEST_TAGGED(bulk_scope, "bulk") {
+    ENHANCED_UNITY_BULK_SCOPE("every_value", 2);
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_NOT_EQUAL_DEBUG(7, i % 50);
+    }
+}
+
+// ---- property: x < 100 over [0, 1000] shrinks to x = 100 ----
+
+static void below_one_hundred(enhanced_unity::PropertyInput& input) {
+    int x = input.integer<int>(0, 1000);
+    TEST_ASSERT_LESS_THAN_DEBUG(100, x);
+}
+
+ENHANCED_UNITY_TEST_TAGGED(property_shrinks, "property") { TEST_ASSERT_PROPERTY_DEBUG(below_one_hundred, 500); }
+
+// ---- stress: under --repeat=6 one test passes, one fails every third run ----
+
+ENHANCED_UNITY_TEST_TAGGED(stress_stable, "stress") { TEST_ASSERT_TRUE_DEBUG(true); }
+
+ENHANCED_UNITY_TEST_TAGGED(stress_flaky, "stress") {
+    static int runs = 0;
+    TEST_ASSERT_TRUE_DEBUG(++runs % 3 != 0);
+}
+
+// ---- history: BEHAVIOUR_EXTRA_MS in the environment slows this test down ----
+
+ENHANCED_UNITY_TEST_TAGGED(history_sleep, "history") {
+    const char* extra = getenv("BEHAVIOUR_EXTRA_MS");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2 + (extra != nullptr ? atoi(extra) : 0)));
+    TEST_ASSERT_TRUE_DEBUG(true);
+}
+
+// ---- shuffle: two tests here, two in behaviour_suite_more.cpp ----
+
+ENHANCED_UNITY_TEST_TAGGED(shuffle_first_a, "shuffle") { TEST_ASSERT_TRUE_DEBUG(true); }
+ENHANCED_UNITY_TEST_TAGGED(shuffle_first_b, "shuffle") { TEST_ASSERT_TRUE_DEBUG(true); }
+
+ENHANCED_UNITY_MAIN()
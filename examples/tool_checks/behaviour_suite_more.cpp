@@ -0,0 +1,7 @@
+// Second source file of the behaviour suite (see behaviour_suite.cpp), so
+// shuffled runs span two test files.
+
+#include <enhanced_unity.hpp>
+
+ENHANCED_UNITY_TEST_TAGGED(shuffle_second_a, "shuffle") { TEST_ASSERT_TRUE_DEBUG(true); }
+ENHANCED_UNITY_TEST_TAGGED(shuffle_second_b, "shuffle") { TEST_ASSERT_TRUE_DEBUG(true); }
@@ -0,0 +1,246 @@
+#!/bin/sh
+# ============================================================================
+# Checks for the host tools (native)
+# ============================================================================
+# Builds tools/enhanced_unity_decode.cpp, tools/enhanced_unity_merge.cpp and
+# the suites in this directory, then checks:
+#
+#   wire round trip   wire_round_trip.cpp passes as a text build; built with
+#                     ENHANCED_UNITY_WIRE_PROTOCOL 1 its stream decodes to the
+#                     same text, a stream with one damaged byte still decodes
+#                     (the frame is skipped and counted), and a truncated
+#                     stream exits 2
+#   shard split       shard_suite.cpp passes and --list --shard=I/3 puts each
+#                     test where fixtures/shard_lists.expected says
+#   merge             the fixture shards merge to fixtures/merged.expected; a
+#                     missing, duplicated, mismatched or unfinished shard and
+#                     an unreadable file exit 2 with their message
+#   behaviour         behaviour_suite.cpp, built plain, parallel and as a
+#                     process pool, gives the outcomes its features promise:
+#                     parallel tests overlap yet print and count in order;
+#                     a crashing and a hanging pool test are booked as
+#                     aborted; a passing keyed test is [CACHED] on the next
+#                     run; a bulk scope counts once and caps what it records;
+#                     a property failure shrinks to its boundary; stress runs
+#                     tell flaky from stable; shuffled runs count each file
+#                     once; a slower test warns, and with --history-fail
+#                     fails the run
+#
+# Run from anywhere, with UNITY pointing at a Unity checkout:
+#   UNITY=<unity> sh examples/tool_checks/run.sh
+# CC and CXX pick the compilers. Exit status: 0 when every check passed.
+# ============================================================================
+
+set -u
+
+if [ -z "${UNITY:-}" ] || [ ! -f "$UNITY/src/unity.c" ]; then
+    echo "usage: UNITY=<unity checkout> sh $0" >&2
+    exit 2
+fi
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+HERE=$ROOT/examples/tool_checks
+FIXTURES=$HERE/fixtures
+CC=${CC:-cc}
+CXX=${CXX:-g++}
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/enhanced_unity_checks.XXXXXX") || exit 2
+trap 'rm -rf "$WORK"' EXIT
+
+failed=0
+
+pass() { echo "ok - $1"; }
+fail() { echo "not ok - $1"; failed=1; }
+
+# check NAME COMMAND...: passes when COMMAND succeeds
+check() {
+    name=$1
+    shift
+    if "$@"; then pass "$name"; else fail "$name"; fi
+}
+
+# build OUTPUT SOURCE [FLAGS or more sources...]
+build() {
+    output=$1
+    source=$2
+    shift 2
+    $CXX -std=c++17 -O1 -DCONFIGMGR_NATIVE "$@" -I"$UNITY/src" -I"$ROOT/src" \
+        "$source" "$ROOT/src/enhanced_unity.cpp" "$WORK/unity.o" -pthread -o "$WORK/$output" \
+        || { fail "build $output"; return 1; }
+}
+
+# expect_status EXPECTED COMMAND...: the command's exit status, output kept
+expect_status() {
+    expected=$1
+    shift
+    "$@" > "$WORK/out.txt" 2> "$WORK/err.txt"
+    [ $? -eq "$expected" ]
+}
+
+# printed TEXT: the last command's output has a line containing TEXT
+printed() {
+    grep -qF -- "$1" "$WORK/out.txt"
+}
+
+# printed_times COUNT TEXT: it has exactly COUNT lines containing TEXT
+printed_times() {
+    [ "$(grep -cF -- "$2" "$WORK/out.txt")" -eq "$1" ]
+}
+
+# overlapped: the summary's wall time is below its summed method time
+overlapped() {
+    set -- $(sed -n 's/.*wall \([0-9]*\)\.[0-9]* ms | methods \([0-9]*\)\.[0-9]* ms.*/\1 \2/p' "$WORK/out.txt")
+    [ $# -eq 2 ] && [ "$1" -lt "$2" ]
+}
+
+$CC -c "$UNITY/src/unity.c" -I"$UNITY/src" -o "$WORK/unity.o" || { echo "cannot build Unity" >&2; exit 2; }
+
+# ---- wire round trip ----
+
+# Timing and resource figures differ between runs; leave them out of both
+# builds so the decoded text must match byte for byte
+STEADY="-DENHANCED_UNITY_THREAD_SAFE=0 -DENHANCED_UNITY_TIMING=0 -DENHANCED_UNITY_RUSAGE=0"
+if build decode "$ROOT/tools/enhanced_unity_decode.cpp" \
+    && build wire_text "$HERE/wire_round_trip.cpp" $STEADY \
+    && build wire_frames "$HERE/wire_round_trip.cpp" $STEADY -DENHANCED_UNITY_WIRE_PROTOCOL=1; then
+    check "wire round trip: text build passes" expect_status 0 "$WORK/wire_text"
+    cp "$WORK/out.txt" "$WORK/text.txt"
+
+    check "wire round trip: device stream ends cleanly" expect_status 0 "$WORK/wire_frames"
+    cp "$WORK/out.txt" "$WORK/stream.bin"
+    check "wire round trip: decoder exits 0" expect_status 0 "$WORK/decode" "$WORK/stream.bin"
+    check "wire round trip: decoded text matches the text build" cmp -s "$WORK/out.txt" "$WORK/text.txt"
+
+    # Replace one byte mid-stream with a different value
+    size=$(wc -c < "$WORK/stream.bin")
+    middle=$((size / 2))
+    original=$(od -An -tu1 -j "$middle" -N1 "$WORK/stream.bin" | tr -d ' ')
+    if [ "$original" = 255 ]; then damage='\376'; else damage='\377'; fi
+    { head -c "$middle" "$WORK/stream.bin"; printf "$damage"; tail -c +$((middle + 2)) "$WORK/stream.bin"; } \
+        > "$WORK/damaged.bin"
+    check "wire round trip: damaged stream still decodes" expect_status 0 "$WORK/decode" "$WORK/damaged.bin"
+    check "wire round trip: damaged frame is reported" grep -q "damaged frame(s) skipped" "$WORK/err.txt"
+    check "wire round trip: summary survives the damage" grep -q "Summary of test files" "$WORK/out.txt"
+
+    head -c "$middle" "$WORK/stream.bin" > "$WORK/truncated.bin"
+    check "wire round trip: truncated stream exits 2" expect_status 2 "$WORK/decode" "$WORK/truncated.bin"
+    check "wire round trip: truncation is reported" grep -q "ended before the run summary" "$WORK/err.txt"
+fi
+
+# ---- shard split ----
+
+if build shard_suite "$HERE/shard_suite.cpp"; then
+    check "shard split: suite passes" expect_status 0 "$WORK/shard_suite"
+    : > "$WORK/lists.txt"
+    for index in 0 1 2; do
+        "$WORK/shard_suite" --list --shard=$index/3 | awk -v shard=$index '{ print shard, $1 }' >> "$WORK/lists.txt"
+    done
+    check "shard split: assignment matches fixtures/shard_lists.expected" \
+        cmp -s "$WORK/lists.txt" "$FIXTURES/shard_lists.expected"
+fi
+
+# ---- merge ----
+
+if build merge "$ROOT/tools/enhanced_unity_merge.cpp"; then
+    MERGE=$WORK/merge
+    S0=$FIXTURES/shard0-of-3.jsonl
+    S1=$FIXTURES/shard1-of-3.jsonl
+    S2=$FIXTURES/shard2-of-3.jsonl
+
+    check "merge: complete set exits 0" expect_status 0 "$MERGE" --jsonl="$WORK/merged.jsonl" "$S0" "$S1" "$S2"
+    sed -E 's/wall [0-9.]+ ms/wall - ms/' "$WORK/out.txt" > "$WORK/merged.txt"
+    check "merge: summary matches fixtures/merged.expected" cmp -s "$WORK/merged.txt" "$FIXTURES/merged.expected"
+    check "merge: merged file ends in one run event for 8 methods" \
+        sh -c 'grep -c "\"event\":\"run\"" "$1" | grep -qx 1 && tail -n 1 "$1" | grep -q "\"methods\":8,"' \
+        sh "$WORK/merged.jsonl"
+
+    check "merge: missing shard exits 2" expect_status 2 "$MERGE" "$S0" "$S2"
+    check "merge: missing shard is named" grep -q "shard 1/3 is missing" "$WORK/err.txt"
+    check "merge: duplicate shard exits 2" expect_status 2 "$MERGE" "$S0" "$S0" "$S1" "$S2"
+    check "merge: duplicate shard is named" grep -q "shard 0/3 given twice" "$WORK/err.txt"
+    check "merge: mismatched shard count exits 2" \
+        expect_status 2 "$MERGE" "$S0" "$S1" "$S2" "$FIXTURES/shard1-of-2.jsonl"
+    check "merge: mismatched shard count is named" grep -q "is shard 1/2, others are of 3" "$WORK/err.txt"
+    check "merge: unfinished shard exits 2" expect_status 2 "$MERGE" "$S0" "$S1" "$FIXTURES/unfinished.jsonl"
+    check "merge: unfinished shard is named" grep -q "unfinished.jsonl has no run event" "$WORK/err.txt"
+    check "merge: unreadable file exits 2" expect_status 2 "$MERGE" "$S0" "$WORK/absent.jsonl"
+    check "merge: no arguments exits 2" expect_status 2 "$MERGE"
+fi
+
+# ---- behaviour ----
+
+SUITE="$HERE/behaviour_suite.cpp $HERE/behaviour_suite_more.cpp"
+if build behaviour $SUITE; then
+    RUN=$WORK/behaviour
+
+    check "behaviour: bulk scope fails" expect_status 1 "$RUN" --tags=bulk
+    check "behaviour: bulk scope is one assertion" \
+        printed "[FAILED]     - assertions [tot     1 | pass     0 | fail     1]"
+    check "behaviour: bulk scope totals its checks" printed "ENHANCED_UNITY_BULK_SCOPE(every_value, 1000, 980)"
+    check "behaviour: bulk scope records 2 failures and 8 samples of 20" \
+        printed_times 10 "TEST_ASSERT_NOT_EQUAL(7, 7)"
+
+    check "behaviour: property fails" expect_status 1 "$RUN" --tags=property --seed=1
+    check "behaviour: property counterexample shrinks to the boundary" printed "TEST_ASSERT_LESS_THAN(100, 100)"
+    check "behaviour: property names its seed" printed "seed 0x0000000000000001"
+
+    check "behaviour: stress run fails" expect_status 1 "$RUN" --tags=stress --repeat=6
+    check "behaviour: stress flaky test is classified" \
+        sh -c 'grep "\[FLAKY   \] stress_flaky" "$1" | grep -qF "runs      6 | pass  66.7% | first failure #3 "' \
+        sh "$WORK/out.txt"
+    check "behaviour: stress stable test is classified" printed "[STABLE  ] stress_stable"
+    check "behaviour: stress iterations are methods" printed "[FAILED]     - methods    [tot    12 | pass    10 | fail     2]"
+
+    check "behaviour: shuffled run passes" expect_status 0 "$RUN" --tags=shuffle --shuffle=7 --repeat=3
+    check "behaviour: shuffled run prints its seed" printed "=== Shuffled stress rounds, seed 0x0000000000000007"
+    check "behaviour: shuffled run counts each file once" printed "[PASSED]     - files      [tot     2 | pass     2 | fail     0]"
+    check "behaviour: shuffled run counts every iteration" \
+        printed "[PASSED]     - methods    [tot    12 | pass    12 | fail     0]"
+
+    check "behaviour: cache first run fails" expect_status 1 "$RUN" --tags=cache --cache="$WORK/results.cache"
+    check "behaviour: cache first run executes everything" printed "[FAILED]     - methods    [tot     3 | pass     2 | fail     1]"
+    check "behaviour: cache second run fails" expect_status 1 "$RUN" --tags=cache --cache="$WORK/results.cache"
+    check "behaviour: cache skips the keyed pass" printed "[CACHED]      - cache_keyed_pass ("
+    check "behaviour: cache reruns the keyed failure" printed "[RUN] cache_keyed_fail"
+    check "behaviour: cache counts executed and cached" printed "- cache      [executed     2 | cached     1]"
+
+    HISTORY=$WORK/timings.bin
+    for run in 1 2 3 4 5; do
+        "$RUN" --tags=history --history="$HISTORY" > /dev/null 2>&1
+    done
+    check "behaviour: slower test only warns" \
+        expect_status 0 env BEHAVIOUR_EXTRA_MS=50 "$RUN" --tags=history --history="$HISTORY" --jsonl="$WORK/slower.jsonl"
+    check "behaviour: slower test is listed" printed "[SLOWER] history_sleep"
+    check "behaviour: slower run status stays passed" grep -q "\"event\":\"run\",\"status\":\"passed\"" "$WORK/slower.jsonl"
+    check "behaviour: --history-fail exits 1" \
+        expect_status 1 env BEHAVIOUR_EXTRA_MS=50 "$RUN" --tags=history --history="$HISTORY" --history-fail \
+        --jsonl="$WORK/history.jsonl"
+    check "behaviour: --history-fail shows in the summary" printed "[FAILED]     - history    [slower     1]"
+    check "behaviour: --history-fail run status is failed" \
+        grep -q "\"event\":\"run\",\"status\":\"failed\".*\"history_failures\":1" "$WORK/history.jsonl"
+    check "behaviour: --history-fail lists the test" \
+        grep -q "\"event\":\"history\",\"method\":\"history_sleep\",\"status\":\"failed\"" "$WORK/history.jsonl"
+fi
+
+if build behaviour_parallel $SUITE -DENHANCED_UNITY_PARALLEL; then
+    check "behaviour: parallel run passes" \
+        expect_status 0 env ENHANCED_UNITY_THREADS=4 "$WORK/behaviour_parallel" --tags=parallel
+    check "behaviour: parallel run counts every test" printed "[PASSED]     - methods    [tot     8 | pass     8 | fail     0]"
+    check "behaviour: parallel run counts every assertion" \
+        printed "[PASSED]     - assertions [tot    24 | pass    24 | fail     0]"
+    check "behaviour: parallel output is in submission order" \
+        sh -c '[ "$(grep "^\[RUN\]" "$1" | tr "\n" " ")" = "$2" ]' sh "$WORK/out.txt" \
+        "$(for n in 1 2 3 4 5 6 7 8; do printf "[RUN] parallel_%s " $n; done)"
+    check "behaviour: parallel tests overlap" overlapped
+fi
+
+if build behaviour_pool $SUITE -DENHANCED_UNITY_PROCESS_POOL; then
+    check "behaviour: pool run fails" expect_status 1 "$WORK/behaviour_pool" --tags=pool
+    check "behaviour: pool books the crash" \
+        sh -c 'grep -q "^\[ABORTED\]     - pool_crash (.*) : worker crashed: signal 6" "$1"' sh "$WORK/out.txt"
+    check "behaviour: pool books the hang" \
+        sh -c 'grep -q "^\[ABORTED\]     - pool_hang (.*) : timed out after .* (limit 200 ms)" "$1"' sh "$WORK/out.txt"
+    check "behaviour: pool counts the survivor" printed "[FAILED]     - methods    [tot     3 | pass     1 | fail     2]"
+    check "behaviour: pool lists the timeout" printed "=== Timed-out test methods: 1"
+fi
+
+exit $failed
@@ -0,0 +1,43 @@
+// Small registered suite for the sharding checks in run.sh (native).
+//
+// The JSON Lines files in fixtures/ were written by this suite with
+// --shard=I/N --jsonl=PATH, and fixtures/shard_lists.expected pins which
+// shard each test lands in (--list --shard=I/3). stable_hash_vectors checks
+// the FNV-1a hash behind that split against published test vectors, so a
+// change to it shows up here before shards written by two builds disagree.
+
+#include <enhanced_unity.hpp>
+
+extern "C" void setUp(void) {}
+extern "C" void tearDown(void) {}
+
+ENHANCED_UNITY_TEST(stable_hash_vectors) {
+    TEST_ASSERT_EQUAL_DEBUG(0xcbf29ce484222325ULL, ::enhanced_unity::stableHash(""));
+    TEST_ASSERT_EQUAL_DEBUG(0xaf63dc4c8601ec8cULL, ::enhanced_unity::stableHash("a"));
+    TEST_ASSERT_EQUAL_DEBUG(0x85944171f73967e8ULL, ::enhanced_unity::stableHash("foobar"));
+    // Chained strings hash like their concatenation
+    TEST_ASSERT_EQUAL_DEBUG(::enhanced_unity::stableHash("foobar"),
+                            ::enhanced_unity::stableHash("bar", ::enhanced_unity::stableHash("foo")));
+}
+
+ENHANCED_UNITY_TEST(parse_empty) { TEST_ASSERT_EQUAL_INT_DEBUG(0, (int)strlen("")); }
+ENHANCED_UNITY_TEST(parse_number) { TEST_ASSERT_EQUAL_INT_DEBUG(42, atoi("42")); }
+ENHANCED_UNITY_TEST(parse_negative) { TEST_ASSERT_EQUAL_INT_DEBUG(-7, atoi("-7")); }
+ENHANCED_UNITY_TEST_TAGGED(format_hex, "fast") {
+    char text[8];
+    snprintf(text, sizeof(text), "%x", 255);
+    TEST_ASSERT_EQUAL_STRING_DEBUG("ff", text);
+}
+ENHANCED_UNITY_TEST_TAGGED(format_padding, "fast") {
+    char text[8];
+    snprintf(text, sizeof(text), "%4d", 7);
+    TEST_ASSERT_EQUAL_STRING_DEBUG("   7", text);
+}
+ENHANCED_UNITY_TEST(compare_strings) { TEST_ASSERT_TRUE_DEBUG(strcmp("abc", "abd") < 0); }
+ENHANCED_UNITY_TEST(compare_memory) {
+    static const uint8_t left[4] = {1, 2, 3, 4};
+    static const uint8_t right[4] = {1, 2, 3, 4};
+    TEST_ASSERT_EQUAL_MEMORY_DEBUG(left, right, sizeof(left));
+}
+
+ENHANCED_UNITY_MAIN()
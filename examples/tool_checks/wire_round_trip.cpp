@@ -0,0 +1,139 @@
+// Round trip of the binary wire protocol (native).
+//
+// The tests encode frames with the device-side CobsEncoder / WireWriter and
+// decode them with the host-side decodeWireFrame / WireReader that
+// tools/enhanced_unity_decode.cpp uses:
+//   cobs_round_trip        payloads around the 254-byte COBS block limit,
+//                          with and without zeros, come back unchanged
+//   field_round_trip       varints, reals and strings read back as written
+//   corrupted_frame        every single-bit error in a frame is rejected
+//   truncated_frame        every cut-short frame is rejected
+//
+// Built with ENHANCED_UNITY_WIRE_PROTOCOL 1 the report itself leaves as
+// frames, so piping it through the decoder checks the whole stream; run.sh
+// in this directory does that, with a corrupted and a truncated stream too.
+
+#include <enhanced_unity.hpp>
+
+#include <string>
+#include <vector>
+
+extern "C" void setUp(void) {}
+extern "C" void tearDown(void) {}
+
+namespace {
+
+using namespace enhanced_unity;
+
+class CaptureSink : public OutputSink {
+public:
+    void write(const char* data, size_t length) override { bytes.append(data, length); }
+    std::string bytes;
+};
+
+// Encoded frame, delimiter included
+std::string encodeFrame(uint8_t type, const std::vector<uint8_t>& fields) {
+    CaptureSink sink;
+    CobsEncoder(sink).frame(type, fields.data(), fields.size());
+    return sink.bytes;
+}
+
+// decodeWireFrame on the frame without its delimiter; type + fields, or
+// empty when the frame was rejected
+std::vector<uint8_t> decodeFrame(const std::string& encoded) {
+    std::vector<uint8_t> out(encoded.size() + 1);
+    size_t length = decodeWireFrame(reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size() - 1, out.data());
+    out.resize(length);
+    return out;
+}
+
+std::vector<uint8_t> payload(size_t length, uint8_t zeroEvery) {
+    std::vector<uint8_t> fields(length);
+    for (size_t i = 0; i < length; i++) {
+        fields[i] = zeroEvery != 0 && i % zeroEvery == 0 ? 0 : (uint8_t)(i * 7 + 1);
+    }
+    return fields;
+}
+
+// A frame like the device sends: method end with a few counts
+std::string sampleFrame() {
+    WireWriter writer(WIRE_METHOD_END);
+    writer.unsignedVarint(3).unsignedVarint(1).byte(0).unsignedVarint(1000).unsignedVarint(2).signedVarint(-123456);
+    return encodeFrame(writer.data[0], std::vector<uint8_t>(writer.data + 1, writer.data + writer.length));
+}
+
+} // namespace
+
+ENHANCED_UNITY_TEST(cobs_round_trip) {
+    static const size_t lengths[] = {0, 1, 252, 253, 254, 255, 508, 600};
+    static const uint8_t zeroEvery[] = {0, 1, 3, 200};
+    for (size_t length : lengths) {
+        for (uint8_t every : zeroEvery) {
+            std::vector<uint8_t> fields = payload(length, every);
+            std::string encoded = encodeFrame(WIRE_TEXT, fields);
+            // One delimiter, at the end
+            TEST_ASSERT_EQUAL_UINT32_DEBUG((uint32_t)encoded.size() - 1, (uint32_t)encoded.find('\0'));
+            std::vector<uint8_t> decoded = decodeFrame(encoded);
+            TEST_ASSERT_EQUAL_UINT32_DEBUG((uint32_t)length + 1, (uint32_t)decoded.size());
+            if (decoded.size() == length + 1) {
+                TEST_ASSERT_EQUAL_UINT8_DEBUG(WIRE_TEXT, decoded[0]);
+                for (size_t i = 0; i < length; i++) {
+                    TEST_ASSERT_EQUAL_UINT8_DEBUG(fields[i], decoded[i + 1]);
+                }
+            }
+        }
+    }
+}
+
+ENHANCED_UNITY_TEST(field_round_trip) {
+    WireWriter writer(WIRE_ASSERTION);
+    writer.unsignedVarint(0).unsignedVarint(127).unsignedVarint(128).unsignedVarint(UINT64_MAX);
+    writer.signedVarint(-1).signedVarint(INT64_MIN).signedVarint(INT64_MAX);
+    writer.real(-0.15625).string("name\0hidden", false).string("", false);
+    std::vector<uint8_t> decoded = decodeFrame(
+        encodeFrame(writer.data[0], std::vector<uint8_t>(writer.data + 1, writer.data + writer.length)));
+    TEST_ASSERT_EQUAL_UINT32_DEBUG((uint32_t)writer.length, (uint32_t)decoded.size());
+    if (decoded.size() != writer.length) {
+        return;
+    }
+    WireReader reader(decoded.data() + 1, decoded.size() - 1);
+    TEST_ASSERT_EQUAL_DEBUG((uint64_t)0, reader.unsignedVarint());
+    TEST_ASSERT_EQUAL_DEBUG((uint64_t)127, reader.unsignedVarint());
+    TEST_ASSERT_EQUAL_DEBUG((uint64_t)128, reader.unsignedVarint());
+    TEST_ASSERT_EQUAL_DEBUG(UINT64_MAX, reader.unsignedVarint());
+    TEST_ASSERT_EQUAL_DEBUG((int64_t)-1, reader.signedVarint());
+    TEST_ASSERT_EQUAL_DEBUG(INT64_MIN, reader.signedVarint());
+    TEST_ASSERT_EQUAL_DEBUG(INT64_MAX, reader.signedVarint());
+    TEST_ASSERT_EQUAL_DEBUG(-0.15625, reader.real(false));
+    TEST_ASSERT_EQUAL_STRING_DEBUG("name", reader.string().c_str());
+    TEST_ASSERT_EQUAL_STRING_DEBUG("", reader.string().c_str());
+    TEST_ASSERT_TRUE_DEBUG(reader.ok && reader.atEnd());
+    reader.byte();
+    TEST_ASSERT_FALSE_DEBUG(reader.ok);  // reading past the end is flagged
+}
+
+ENHANCED_UNITY_TEST(corrupted_frame) {
+    std::string frame = sampleFrame();
+    TEST_ASSERT_FALSE_DEBUG(decodeFrame(frame).empty());
+    int accepted = 0;
+    for (size_t i = 0; i + 1 < frame.size(); i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            std::string damaged = frame;
+            damaged[i] = (char)(damaged[i] ^ (1 << bit));
+            accepted += decodeFrame(damaged).empty() ? 0 : 1;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT_DEBUG(0, accepted);
+}
+
+ENHANCED_UNITY_TEST(truncated_frame) {
+    std::string frame = sampleFrame();
+    int accepted = 0;
+    for (size_t kept = 0; kept + 1 < frame.size(); kept++) {
+        std::string cut = frame.substr(0, kept) + '\0';
+        accepted += decodeFrame(cut).empty() ? 0 : 1;
+    }
+    TEST_ASSERT_EQUAL_INT_DEBUG(0, accepted);
+}
+
+ENHANCED_UNITY_MAIN()
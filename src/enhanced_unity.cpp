@@ -10,23 +10,100 @@
 // Define global variables for enhanced Unity framework
 bool _serialInitialized = false;
 
-int _enhancedUnityAssertionCount = 0;
-int _enhancedUnityAssertionFailureCount = 0;
-int _enhancedUnityAssertionFileCount = 0;
-int _enhancedUnityAssertionFileFailureCount = 0;
-int _enhancedUnityAssertionTotalCount = 0;
-int _enhancedUnityAssertionTotalFailureCount = 0;
-
-int _enhancedUnityMethodCount = 0;
-int _enhancedUnityMethodFailureCount = 0;
-int _enhancedUnityMethodFileCount = 0;
-int _enhancedUnityMethodFileFailureCount = 0;
-int _enhancedUnityMethodTotalCount = 0;
-int _enhancedUnityMethodTotalFailureCount = 0;
-
-int _enhancedUnityTestCount = 0;
-int _enhancedUnityTestFailureCount = 0;
-int _enhancedUnityFailureCount = 0;
+// Debug mode (ENHANCED_UNITY_SET_DEBUG_MODE)
+bool _enhancedUnityDebugMode = ENHANCED_UNITY_DEBUG_MODE;
+
+// Default counter context; assertion counts live in its per-thread shards
+enhanced_unity::CounterContext _enhancedUnityCounters;
+
+// Write-combining buffer in front of the output sink
+enhanced_unity::OutputBuffer _enhancedUnityOutput;
+
+// Attached result reporters (JSON Lines, TAP, JUnit)
+enhanced_unity::ResultReporter* _enhancedUnityReporters[ENHANCED_UNITY_MAX_REPORTERS];
+int _enhancedUnityReporterCount = 0;
+
+// Deferred assertion record buffer and file-name table
+enhanced_unity::RecordBuffer _enhancedUnityRecords;
+const char* _enhancedUnityFileTable[ENHANCED_UNITY_MAX_FILES];
+int _enhancedUnityFileTableCount = 0;
+enhanced_unity::SpinLock _enhancedUnityFileTableLock;
+
+// Self-registered tests (ENHANCED_UNITY_TEST)
+enhanced_unity::TestRegistration* _enhancedUnityRegistryHead = nullptr;
+enhanced_unity::TestRegistration* _enhancedUnityRegistryTail = nullptr;
+
+#if ENHANCED_UNITY_TASK_WATCHDOG
+// Test watchdog state; RTC memory survives the task watchdog's reboot
+RTC_NOINIT_ATTR enhanced_unity::WatchdogMemory _enhancedUnityWatchdog;
+#endif
+
+#if ENHANCED_UNITY_MEMORY && defined(CONFIGMGR_NATIVE)
+// Heap accounting stand-in for a malloc hook: every operator new/delete,
+// aligned or not, goes through here and adjusts the live byte count by the
+// block's usable size
+#include <new>
+#include <stdlib.h>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#define ENHANCED_UNITY_BLOCK_SIZE(block) malloc_size(block)
+#else
+#include <malloc.h>
+#define ENHANCED_UNITY_BLOCK_SIZE(block) malloc_usable_size(block)
+#endif
+
+std::atomic<int64_t> _enhancedUnityHeapUsed{0};
+std::atomic<int64_t> _enhancedUnityHeapPeak{0};
+
+static void* enhancedUnityCount(void* block) {
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    int64_t used = _enhancedUnityHeapUsed.fetch_add((int64_t)ENHANCED_UNITY_BLOCK_SIZE(block), std::memory_order_relaxed) +
+                   (int64_t)ENHANCED_UNITY_BLOCK_SIZE(block);
+    int64_t peak = _enhancedUnityHeapPeak.load(std::memory_order_relaxed);
+    while (used > peak && !_enhancedUnityHeapPeak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+    }
+    return block;
+}
+
+static void* enhancedUnityAllocate(size_t size) {
+    return enhancedUnityCount(malloc(size != 0 ? size : 1));
+}
+
+#ifdef __cpp_aligned_new
+// Over-aligned types (alignas beyond the default, e.g. the counter shards)
+static void* enhancedUnityAllocateAligned(size_t size, std::align_val_t alignment) {
+    void* block = nullptr;
+    if (posix_memalign(&block, (size_t)alignment, size != 0 ? size : 1) != 0) {
+        block = nullptr;
+    }
+    return enhancedUnityCount(block);
+}
+#endif
+
+static void enhancedUnityRelease(void* block) {
+    if (block != nullptr) {
+        _enhancedUnityHeapUsed.fetch_sub((int64_t)ENHANCED_UNITY_BLOCK_SIZE(block), std::memory_order_relaxed);
+        free(block);
+    }
+}
+
+void* operator new(size_t size) { return enhancedUnityAllocate(size); }
+void* operator new[](size_t size) { return enhancedUnityAllocate(size); }
+void operator delete(void* block) noexcept { enhancedUnityRelease(block); }
+void operator delete[](void* block) noexcept { enhancedUnityRelease(block); }
+void operator delete(void* block, size_t) noexcept { enhancedUnityRelease(block); }
+void operator delete[](void* block, size_t) noexcept { enhancedUnityRelease(block); }
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t alignment) { return enhancedUnityAllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return enhancedUnityAllocateAligned(size, alignment); }
+void operator delete(void* block, std::align_val_t) noexcept { enhancedUnityRelease(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { enhancedUnityRelease(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { enhancedUnityRelease(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { enhancedUnityRelease(block); }
+#endif
+#endif
 
 // Linker anchor to ensure this compilation unit is linked
 extern "C" void enhancedUnityLinkAnchor() {}
@@ -9,9 +9,11 @@
 #include <unity.h>
 #include <cstdio>
 #include <cstring>
+#include <stdint.h>
+#include <stdarg.h>
 
 // NOTE: This header is migrated from the project's test/enhanced_unity.hpp
-// Any project-specific types referenced (e.g., validationResult, sm) are expected
+// Any project-specific types referenced (e.g., validationResult) are expected
 // to be declared by the including test harness prior to including this header.
 
 // ============================================================================
@@ -35,609 +37,3151 @@
 #define ENHANCED_UNITY_LOG_FILE nullptr  // No logging by default
 #endif
 
+// Baud rate ENHANCED_UNITY_INIT_SERIAL() opens the serial port with
+#ifndef ENHANCED_UNITY_SERIAL_BAUD
+#define ENHANCED_UNITY_SERIAL_BAUD 115200
+#endif
+
+// ============================================================================
+// THREADING CONFIGURATION
+// ============================================================================
+// 1 = counters and records may be touched from several threads
+#ifndef ENHANCED_UNITY_THREAD_SAFE
+#ifdef CONFIGMGR_NATIVE
+#define ENHANCED_UNITY_THREAD_SAFE 1
+#else
+#define ENHANCED_UNITY_THREAD_SAFE 0
+#endif
+#endif
+
+#ifndef ENHANCED_UNITY_CACHE_LINE_SIZE
+#define ENHANCED_UNITY_CACHE_LINE_SIZE 64
+#endif
+
+// ============================================================================
+// BRANCH HINTS
+// ============================================================================
+// Assertions pass almost always: the pass path stays inline at the call site,
+// everything a failure needs lives in ENHANCED_UNITY_COLD functions, which
+// the compiler keeps out of line and away from hot code.
+#if defined(__GNUC__) || defined(__clang__)
+#define ENHANCED_UNITY_LIKELY(condition) __builtin_expect(!!(condition), 1)
+#define ENHANCED_UNITY_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#define ENHANCED_UNITY_COLD __attribute__((noinline, cold))
+#else
+#define ENHANCED_UNITY_LIKELY(condition) (condition)
+#define ENHANCED_UNITY_UNLIKELY(condition) (condition)
+#define ENHANCED_UNITY_COLD
+#endif
+
+#if ENHANCED_UNITY_THREAD_SAFE
+#include <atomic>
+#include <string>
+#define ENHANCED_UNITY_SHARD_ALIGN alignas(ENHANCED_UNITY_CACHE_LINE_SIZE)
+#else
+#define ENHANCED_UNITY_SHARD_ALIGN
+#endif
+
 // USE_BASELINE_UNITY defined means use the original Unity macros
 #ifdef USE_BASELINE_UNITY
+#include <math.h>
+
+// Use original Unity macros - these will terminate tests on failure
+#define TEST_ASSERT_TRUE_DEBUG(condition) TEST_ASSERT_TRUE(condition)
+
+// Use standard Unity RUN_TEST macro when using baseline Unity
+#define RUN_TEST_DEBUG(testFunction) RUN_TEST(testFunction)
+#define RUN_TEST_CACHED_DEBUG(testFunction, contentKey) RUN_TEST(testFunction)
+#define RUN_TEST_TIMEOUT_DEBUG(testFunction, timeoutMillis) RUN_TEST(testFunction)
+#define TEST_ASSERT_FALSE_DEBUG(condition) TEST_ASSERT_FALSE(condition)
+#define TEST_ASSERT_EQUAL_INT_DEBUG(expected, actual) TEST_ASSERT_EQUAL_INT(expected, actual)
+#define TEST_ASSERT_EQUAL_UINT32_DEBUG(expected, actual) TEST_ASSERT_EQUAL_UINT32(expected, actual)
+#define TEST_ASSERT_EQUAL_UINT8_DEBUG(expected, actual) TEST_ASSERT_EQUAL_UINT8(expected, actual)
+#define TEST_ASSERT_NOT_EQUAL_DEBUG(expected, actual) TEST_ASSERT_NOT_EQUAL(expected, actual)
+#define TEST_ASSERT_GREATER_THAN_DEBUG(expected, actual) TEST_ASSERT_GREATER_THAN(expected, actual)
+#define TEST_ASSERT_GREATER_THAN_UINT32_DEBUG(expected, actual) TEST_ASSERT_GREATER_THAN_UINT32(expected, actual)
+#define TEST_ASSERT_LESS_THAN_DEBUG(expected, actual) TEST_ASSERT_LESS_THAN(expected, actual)
+#define TEST_ASSERT_NULL_DEBUG(pointer) TEST_ASSERT_NULL(pointer)
+#define TEST_ASSERT_NOT_NULL_DEBUG(pointer) TEST_ASSERT_NOT_NULL(pointer)
+#define TEST_ASSERT_EQUAL_STRING_DEBUG(expected, actual) TEST_ASSERT_EQUAL_STRING(expected, actual)
+#define TEST_ASSERT_EQUAL_STRING_LEN_DEBUG(expected, actual, length) TEST_ASSERT_EQUAL_STRING_LEN(expected, actual, length)
+#define TEST_ASSERT_EQUAL_PAYLOAD_DEBUG(expected, expectedLength, actual, actualLength) do { \
+    TEST_ASSERT_EQUAL_UINT32((expectedLength), (actualLength)); \
+    TEST_ASSERT_EQUAL_MEMORY((expected), (actual), (expectedLength)); \
+} while(0)
+#define TEST_ASSERT_FLOAT_WITHIN_DEBUG(delta, expected, actual) TEST_ASSERT_FLOAT_WITHIN(delta, expected, actual)
+#define TEST_ASSERT_EQUAL_DEBUG(expected, actual) TEST_ASSERT_EQUAL(expected, actual)
+#define TEST_ASSERT_GREATER_OR_EQUAL_DEBUG(expected, actual) TEST_ASSERT_GREATER_OR_EQUAL(expected, actual)
+#define TEST_ASSERT_LESS_OR_EQUAL_DEBUG(expected, actual) TEST_ASSERT_LESS_OR_EQUAL(expected, actual)
+#define TEST_ASSERT_DOUBLE_WITHIN_DEBUG(delta, expected, actual) TEST_ASSERT_DOUBLE_WITHIN(delta, expected, actual)
+#define TEST_ASSERT_EQUAL_MEMORY_DEBUG(expected, actual, length) TEST_ASSERT_EQUAL_MEMORY(expected, actual, length)
+#define TEST_ASSERT_EQUAL_UINT8_ARRAY_DEBUG(expected, actual, count) TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, count)
+#define TEST_ASSERT_EQUAL_INT16_ARRAY_DEBUG(expected, actual, count) TEST_ASSERT_EQUAL_INT16_ARRAY(expected, actual, count)
+#define TEST_ASSERT_EQUAL_UINT32_ARRAY_DEBUG(expected, actual, count) TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, actual, count)
+#define TEST_ASSERT_EQUAL_INT64_ARRAY_DEBUG(expected, actual, count) TEST_ASSERT_EQUAL_INT64_ARRAY(expected, actual, count)
+#define TEST_ASSERT_FLOAT_ARRAY_WITHIN_DEBUG(delta, expected, actual, count) TEST_ASSERT_FLOAT_ARRAY_WITHIN(delta, expected, actual, count)
+#define TEST_ASSERT_DOUBLE_ARRAY_WITHIN_DEBUG(delta, expected, actual, count) TEST_ASSERT_DOUBLE_ARRAY_WITHIN(delta, expected, actual, count)
+// Checks stock Unity cannot make end the test as ignored rather than pass
+#define ENHANCED_UNITY_BASELINE_UNSUPPORTED(assertName) \
+    TEST_IGNORE_MESSAGE(assertName " is not supported with USE_BASELINE_UNITY")
+// Relative tolerances become one WITHIN check per element
+#define TEST_ASSERT_FLOAT_ARRAY_RELATIVE_DEBUG(tolerance, expected, actual, count) do { \
+    for (uint32_t _index = 0; _index < (uint32_t)(count); _index++) { \
+        TEST_ASSERT_FLOAT_WITHIN((float)((tolerance) * fabs((double)(expected)[_index])), (expected)[_index], (actual)[_index]); \
+    } \
+} while(0)
+#define TEST_ASSERT_DOUBLE_ARRAY_RELATIVE_DEBUG(tolerance, expected, actual, count) do { \
+    for (uint32_t _index = 0; _index < (uint32_t)(count); _index++) { \
+        TEST_ASSERT_DOUBLE_WITHIN((tolerance) * fabs((double)(expected)[_index]), (expected)[_index], (actual)[_index]); \
+    } \
+} while(0)
+// Stock Unity has no ULP or RMS array checks
+#define TEST_ASSERT_FLOAT_ARRAY_ULPS_DEBUG(maxUlps, expected, actual, count) do { \
+    (void)(maxUlps); (void)(expected); (void)(actual); (void)(count); \
+    ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_FLOAT_ARRAY_ULPS"); \
+} while(0)
+#define TEST_ASSERT_DOUBLE_ARRAY_ULPS_DEBUG(maxUlps, expected, actual, count) do { \
+    (void)(maxUlps); (void)(expected); (void)(actual); (void)(count); \
+    ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_DOUBLE_ARRAY_ULPS"); \
+} while(0)
+#define TEST_ASSERT_FLOAT_ARRAY_RMS_DEBUG(maxRms, expected, actual, count) do { \
+    (void)(maxRms); (void)(expected); (void)(actual); (void)(count); \
+    ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_FLOAT_ARRAY_RMS"); \
+} while(0)
+#define TEST_ASSERT_DOUBLE_ARRAY_RMS_DEBUG(maxRms, expected, actual, count) do { \
+    (void)(maxRms); (void)(expected); (void)(actual); (void)(count); \
+    ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_DOUBLE_ARRAY_RMS"); \
+} while(0)
+// Stock Unity has no memory probes
+#define TEST_ASSERT_HEAP_DELTA_LE_DEBUG(maxBytes) do { \
+    (void)(maxBytes); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_HEAP_DELTA_LE"); \
+} while(0)
+#define TEST_ASSERT_HEAP_PEAK_LE_DEBUG(maxBytes) do { \
+    (void)(maxBytes); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_HEAP_PEAK_LE"); \
+} while(0)
+#define TEST_ASSERT_STACK_FREE_GE_DEBUG(minBytes) do { \
+    (void)(minBytes); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_STACK_FREE_GE"); \
+} while(0)
+// Stock Unity has no resource probes
+#define TEST_ASSERT_CPU_MS_LE_DEBUG(maxMillis) do { \
+    (void)(maxMillis); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_CPU_MS_LE"); \
+} while(0)
+#define TEST_ASSERT_MINOR_FAULTS_LE_DEBUG(maxFaults) do { \
+    (void)(maxFaults); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_MINOR_FAULTS_LE"); \
+} while(0)
+#define TEST_ASSERT_MAJOR_FAULTS_LE_DEBUG(maxFaults) do { \
+    (void)(maxFaults); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_MAJOR_FAULTS_LE"); \
+} while(0)
+#define TEST_ASSERT_CONTEXT_SWITCHES_LE_DEBUG(maxSwitches) do { \
+    (void)(maxSwitches); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_CONTEXT_SWITCHES_LE"); \
+} while(0)
+#define TEST_ASSERT_RSS_GROWTH_KB_LE_DEBUG(maxKilobytes) do { \
+    (void)(maxKilobytes); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_RSS_GROWTH_KB_LE"); \
+} while(0)
+// Assertions inside run as plain Unity assertions
+#define ENHANCED_UNITY_BULK_SCOPE(name, maxReported)
+// Stock Unity has no property engine; property functions themselves take an
+// enhanced_unity::PropertyInput and need their own #ifndef USE_BASELINE_UNITY
+#define TEST_ASSERT_PROPERTY_DEBUG(property, cases) do { \
+    (void)(cases); ENHANCED_UNITY_BASELINE_UNSUPPORTED("TEST_ASSERT_PROPERTY"); \
+} while(0)
+#define ENHANCED_UNITY_SET_PROPERTY_SEED(seed) do { (void)(seed); } while(0)
+// Queued and isolated tests run in place
+#define RUN_TEST_PARALLEL_DEBUG(testFunction) RUN_TEST(testFunction)
+#define RUN_TEST_EXCLUSIVE_DEBUG(testFunction) RUN_TEST(testFunction)
+#define RUN_TEST_ISOLATED_DEBUG(testFunction) RUN_TEST(testFunction)
+#define ENHANCED_UNITY_RUN_QUEUED_TESTS() do { } while(0)
+#define ENHANCED_UNITY_RUN_ISOLATED_TESTS() do { } while(0)
+
+// Registered tests are plain Unity test functions, run in registration order
+// the way RUN_TEST runs them; tags, content keys and filters are ignored
+namespace enhanced_unity {
+
+class BaselineTest {
+public:
+    BaselineTest(UnityTestFunction testFunction, const char* testName, int testLine)
+        : function(testFunction), name(testName), line(testLine) {
+        *tail() = this;
+        tail() = &next;
+    }
+    static BaselineTest*& head() {
+        static BaselineTest* first = nullptr;
+        return first;
+    }
+    static BaselineTest**& tail() {
+        static BaselineTest** last = &head();
+        return last;
+    }
+    UnityTestFunction function;
+    const char* name;
+    int line;
+    BaselineTest* next = nullptr;
+};
+
+// Returns how many ran
+inline int runBaselineTests() {
+    int count = 0;
+    for (BaselineTest* test = BaselineTest::head(); test != nullptr; test = test->next) {
+        UnityDefaultTestRun(test->function, test->name, test->line);
+        count++;
+    }
+    return count;
+}
+
+} // namespace enhanced_unity
+
+#define ENHANCED_UNITY_TEST_KEYED(testName, testTags, contentKey) \
+    static void testName(void); \
+    static ::enhanced_unity::BaselineTest testName##_enhancedUnityRegistration(testName, #testName, __LINE__); \
+    static void testName(void)
+#define ENHANCED_UNITY_TEST_TAGGED(testName, testTags) ENHANCED_UNITY_TEST_KEYED(testName, testTags, nullptr)
+#define ENHANCED_UNITY_TEST(testName) ENHANCED_UNITY_TEST_TAGGED(testName, "")
+#define ENHANCED_UNITY_RUN_REGISTERED_TESTS(filter, tags) \
+    ((void)(filter), (void)(tags), ::enhanced_unity::runBaselineTests())
+#define ENHANCED_UNITY_MAIN() \
+    int main(void) { UNITY_BEGIN(); ::enhanced_unity::runBaselineTests(); return UNITY_END(); }
+// Benchmarks register as tests that end as ignored; the body is never timed
+#define ENHANCED_UNITY_BENCHMARK_MAX_NS(benchName, maxNanosPerOp) \
+    static void benchName##_benchmarkOperation(); \
+    ENHANCED_UNITY_TEST(benchName) { \
+        (void)(maxNanosPerOp); (void)benchName##_benchmarkOperation; \
+        ENHANCED_UNITY_BASELINE_UNSUPPORTED("ENHANCED_UNITY_BENCHMARK"); \
+    } \
+    static void benchName##_benchmarkOperation()
+#define ENHANCED_UNITY_BENCHMARK(benchName) ENHANCED_UNITY_BENCHMARK_MAX_NS(benchName, 0)
+#define ENHANCED_UNITY_DO_NOT_OPTIMIZE(value) ((void)(value))
+
+// ============================================================================
+// ENHANCED UNITY MACROS (non-terminating, with failure counting)
+// ============================================================================
+#define ENHANCED_UNITY_INIT()
+#define ENHANCED_UNITY_GET_FAILURES()
+#define ENHANCED_UNITY_RESET()
+#define ENHANCED_UNITY_FINAL_REPORT()
+#define ENHANCED_UNITY_SET_DEBUG_MODE(enabled)
+#define ENHANCED_UNITY_ASSERT_NO_FAILURES()
+#define ENHANCED_UNITY_START_TEST_METHOD(methodName, fileName, lineNumber)
+#define ENHANCED_UNITY_END_TEST_METHOD()
+
+#else
+
+// Runs tests that were queued rather than run in place (native runners)
+#define ENHANCED_UNITY_RUN_PENDING_TESTS() do { } while(0)
+
+#define ENHANCED_UNITY_FINAL_SUMMARY() do { \
+    ENHANCED_UNITY_RUN_PENDING_TESTS(); \
+    ::enhanced_unity::flushRecords(); \
+    ::enhanced_unity::reportFinalSummary(); \
+    ::enhanced_unity::flushOutput(true); \
+} while(0)
+
+// Global flag to prevent multiple Serial initializations
+extern bool _serialInitialized;
+
+// Safe Serial initialization macro
+#define ENHANCED_UNITY_INIT_SERIAL() do { \
+    if (!_serialInitialized) { \
+        Serial.begin(ENHANCED_UNITY_SERIAL_BAUD); \
+        while(!Serial) { \
+            delay(100); \
+        } \
+        Serial.flush(); \
+        _serialInitialized = true; \
+    } \
+} while(0)
+
+// Debug mode: at VERBOSITY_ALL_ASSERTIONS passing assertions are recorded only
+// while it is on, and ENHANCED_UNITY_FINAL_REPORT() confirms a clean run.
+// Starts as ENHANCED_UNITY_DEBUG_MODE (on at VERBOSITY_ALL_ASSERTIONS);
+// ENHANCED_UNITY_SET_DEBUG_MODE() switches it at run time.
+#ifndef ENHANCED_UNITY_DEBUG_MODE
+#define ENHANCED_UNITY_DEBUG_MODE (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS)
+#endif
+
+extern bool _enhancedUnityDebugMode;
+
+namespace enhanced_unity {
+inline bool debugMode() { return _enhancedUnityDebugMode; }
+} // namespace enhanced_unity
+
+#define ENHANCED_UNITY_SET_DEBUG_MODE(enabled) do { _enhancedUnityDebugMode = (enabled); } while(0)
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+// Every report line goes through enhanced_unity::print(), which collects it
+// in the buffered output sink (enhanced_unity_output.hpp). On thread-safe
+// builds a thread can divert its output into an OutputCapture, which lets
+// parallel runs print each test's output as one block in a fixed order.
+//
+// With ENHANCED_UNITY_PROGMEM the report's format strings, assertion names
+// and the method/file names given to ENHANCED_UNITY_START_TEST_METHOD stay
+// in flash: ENHANCED_UNITY_PRINT() wraps its format in PSTR() and prints it
+// with vsnprintf_P, and "%" ENHANCED_UNITY_FLASH_S formats a flash string
+// argument ("%S" on AVR/ESP8266).
+// ============================================================================
+
+// 1 = keep report strings in flash; default on AVR and ESP8266, where string
+// literals are otherwise copied into SRAM at startup
+#ifndef ENHANCED_UNITY_PROGMEM
+#if defined(__AVR__) || defined(ESP8266)
+#define ENHANCED_UNITY_PROGMEM 1
+#else
+#define ENHANCED_UNITY_PROGMEM 0
+#endif
+#endif
+
+#if ENHANCED_UNITY_PROGMEM
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#include <pgmspace.h>
+#endif
+#define ENHANCED_UNITY_FLASH(literal) PSTR(literal)
+#define ENHANCED_UNITY_FLASH_DATA PROGMEM
+#define ENHANCED_UNITY_FLASH_S "S"
+#define ENHANCED_UNITY_PRINT(format, ...) \
+    ::enhanced_unity::printFlash(ENHANCED_UNITY_FLASH(format), ##__VA_ARGS__)
+#else
+#define ENHANCED_UNITY_FLASH(literal) (literal)
+#define ENHANCED_UNITY_FLASH_DATA
+#define ENHANCED_UNITY_FLASH_S "s"
+#define ENHANCED_UNITY_PRINT(format, ...) ::enhanced_unity::print(format, ##__VA_ARGS__)
+#endif
+
+#if ENHANCED_UNITY_PROGMEM && ENHANCED_UNITY_THREAD_SAFE
+#error "ENHANCED_UNITY_PROGMEM output bypasses the thread-safe output capture"
+#endif
+
+// 1 = send the report as COBS-framed binary records (enhanced_unity_wire.hpp)
+// for tools/enhanced_unity_decode to turn back into text and result reports
+#ifndef ENHANCED_UNITY_WIRE_PROTOCOL
+#define ENHANCED_UNITY_WIRE_PROTOCOL 0
+#endif
+
+#if ENHANCED_UNITY_WIRE_PROTOCOL && ENHANCED_UNITY_THREAD_SAFE
+#error "ENHANCED_UNITY_WIRE_PROTOCOL needs a single-threaded build (ENHANCED_UNITY_THREAD_SAFE 0)"
+#endif
+
+// Result reporters (JSON Lines, TAP, JUnit, and the timing history on
+// native) that can be attached at once
+#ifndef ENHANCED_UNITY_MAX_REPORTERS
+#ifdef CONFIGMGR_NATIVE
+#define ENHANCED_UNITY_MAX_REPORTERS 4
+#else
+#define ENHANCED_UNITY_MAX_REPORTERS 3
+#endif
+#endif
+
+namespace enhanced_unity {
+
+#if ENHANCED_UNITY_THREAD_SAFE
+
+class SpinLock {
+public:
+    void lock() { while (flag_.test_and_set(std::memory_order_acquire)) {} }
+    void unlock() { flag_.clear(std::memory_order_release); }
+private:
+    std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+};
+
+struct OutputCapture {
+    std::string text;
+    std::string reports[ENHANCED_UNITY_MAX_REPORTERS];  // per attached reporter
+};
+
+inline OutputCapture*& threadOutputCapture() {
+    static thread_local OutputCapture* capture = nullptr;
+    return capture;
+}
+
+#else
+
+class SpinLock {
+public:
+    void lock() {}
+    void unlock() {}
+};
+
+#endif
+
+class SpinLockGuard {
+public:
+    explicit SpinLockGuard(SpinLock& lock) : lock_(lock) { lock_.lock(); }
+    ~SpinLockGuard() { lock_.unlock(); }
+    SpinLockGuard(const SpinLockGuard&) = delete;
+    SpinLockGuard& operator=(const SpinLockGuard&) = delete;
+private:
+    SpinLock& lock_;
+};
+
+} // namespace enhanced_unity
+
+#include "enhanced_unity_output.hpp"
+
+namespace enhanced_unity {
+
+inline void print(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+inline void print(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+#if ENHANCED_UNITY_THREAD_SAFE
+    if (OutputCapture* capture = threadOutputCapture()) {
+        char line[256];
+        va_list copy;
+        va_copy(copy, args);
+        int length = vsnprintf(line, sizeof(line), format, args);
+        if (length >= (int)sizeof(line)) {
+            size_t offset = capture->text.size();
+            capture->text.resize(offset + length + 1);
+            vsnprintf(&capture->text[offset], length + 1, format, copy);
+            capture->text.resize(offset + length);
+        } else if (length > 0) {
+            capture->text.append(line, length);
+        }
+        va_end(copy);
+        va_end(args);
+        return;
+    }
+#endif
+    writeFormatted(vsnprintf, format, args);
+    va_end(args);
+}
+
+#if ENHANCED_UNITY_PROGMEM
+
+// print() with a format string in flash
+inline void printFlash(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    writeFormatted(vsnprintf_P, format, args);
+    va_end(args);
+}
+
+inline uint8_t readFlashByte(const void* address) { return pgm_read_byte(address); }
+
+#else
+
+inline uint8_t readFlashByte(const void* address) { return *static_cast<const uint8_t*>(address); }
+
+#endif
+
+// strcmp() for two strings that may both live in flash
+inline bool flashStringsEqual(const char* a, const char* b) {
+    for (;; a++, b++) {
+        uint8_t c = readFlashByte(a);
+        if (c != readFlashByte(b)) {
+            return false;
+        }
+        if (c == 0) {
+            return true;
+        }
+    }
+}
+
+// Status word for report lines; a flash string ("%" ENHANCED_UNITY_FLASH_S)
+inline const char* statusText(bool passed) {
+    return passed ? ENHANCED_UNITY_FLASH("PASSED") : ENHANCED_UNITY_FLASH("FAILED");
+}
+
+} // namespace enhanced_unity
+
+// ============================================================================
+// DEFERRED ASSERTION RECORDS
+// ============================================================================
+// Assertion results are captured as compact records (kind, line, file id and
+// raw values) in a fixed, statically allocated buffer. Text is only rendered
+// at ENHANCED_UNITY_END_TEST_METHOD() / ENHANCED_UNITY_END_TEST_FILE(), or
+// when the buffer fills, so a failing assertion no longer blocks on the UART.
+// ============================================================================
+
+// Number of records held before the buffer has to be rendered
+#ifndef ENHANCED_UNITY_RECORD_CAPACITY
+#ifdef __AVR__
+#define ENHANCED_UNITY_RECORD_CAPACITY 8
+#else
+#define ENHANCED_UNITY_RECORD_CAPACITY 64
+#endif
+#endif
+
+// Bytes kept from each string operand (including the terminator); text
+// assertions keep this many bytes of each text around the first divergence
+#ifndef ENHANCED_UNITY_RECORD_STRING_LENGTH
+#ifdef __AVR__
+#define ENHANCED_UNITY_RECORD_STRING_LENGTH 12
+#else
+#define ENHANCED_UNITY_RECORD_STRING_LENGTH 32
+#endif
+#endif
+
+// Bytes of each array around its first mismatch kept by an array assertion
+#ifndef ENHANCED_UNITY_ARRAY_WINDOW
+#if defined(__AVR__)
+#define ENHANCED_UNITY_ARRAY_WINDOW 4
+#elif defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_ARRAY_WINDOW 16
+#else
+#define ENHANCED_UNITY_ARRAY_WINDOW 8
+#endif
+#endif
+
+// Distinct __FILE__ values that can be given a file id
+#ifndef ENHANCED_UNITY_MAX_FILES
+#define ENHANCED_UNITY_MAX_FILES 16
+#endif
+
+// 1 = render early when the buffer fills, 0 = drop (and count) further records
+#ifndef ENHANCED_UNITY_RECORD_FLUSH_ON_FULL
+#define ENHANCED_UNITY_RECORD_FLUSH_ON_FULL 1
+#endif
+
+#define ENHANCED_UNITY_UNKNOWN_FILE_ID 0xFF
+
+namespace enhanced_unity {
+
+enum AssertKind : uint8_t {
+    ASSERT_TRUE,
+    ASSERT_FALSE,
+    ASSERT_EQUAL_INT,
+    ASSERT_EQUAL_UINT32,
+    ASSERT_EQUAL_UINT8,
+    ASSERT_NOT_EQUAL,
+    ASSERT_GREATER_THAN,
+    ASSERT_GREATER_THAN_UINT32,
+    ASSERT_LESS_THAN_UINT32,
+    ASSERT_LE_UINT32,
+    ASSERT_GE_UINT32,
+    ASSERT_LESS_THAN,
+    ASSERT_NULL,
+    ASSERT_NOT_NULL,
+    ASSERT_EQUAL_STRING,
+    ASSERT_FLOAT_WITHIN,
+    ASSERT_SCOREBOARD_INCREASED,
+    ASSERT_VALIDATION_RESULT,
+    ASSERT_BENCHMARK_MAX_NS,
+    ASSERT_HEAP_DELTA_LE,
+    ASSERT_HEAP_PEAK_LE,
+    ASSERT_STACK_FREE_GE,
+    ASSERT_EQUAL,
+    ASSERT_GREATER_OR_EQUAL,
+    ASSERT_LESS_OR_EQUAL,
+    ASSERT_DOUBLE_WITHIN,
+    ASSERT_EQUAL_MEMORY,
+    ASSERT_EQUAL_UINT8_ARRAY,
+    ASSERT_EQUAL_INT16_ARRAY,
+    ASSERT_EQUAL_UINT32_ARRAY,
+    ASSERT_EQUAL_INT64_ARRAY,
+    ASSERT_FLOAT_ARRAY_WITHIN,
+    ASSERT_DOUBLE_ARRAY_WITHIN,
+    ASSERT_FLOAT_ARRAY_RELATIVE,
+    ASSERT_DOUBLE_ARRAY_RELATIVE,
+    ASSERT_FLOAT_ARRAY_ULPS,
+    ASSERT_DOUBLE_ARRAY_ULPS,
+    ASSERT_FLOAT_ARRAY_RMS,
+    ASSERT_DOUBLE_ARRAY_RMS,
+    ASSERT_EQUAL_STRING_LEN,
+    ASSERT_EQUAL_PAYLOAD,
+    ASSERT_BULK_SCOPE,
+    ASSERT_PROPERTY,
+    ASSERT_CPU_MS_LE,
+    ASSERT_MINOR_FAULTS_LE,
+    ASSERT_MAJOR_FAULTS_LE,
+    ASSERT_CONTEXT_SWITCHES_LE,
+    ASSERT_RSS_GROWTH_KB_LE,
+    ASSERT_KIND_COUNT
+};
+
+// How the raw values of a record are rendered
+enum ValueFormat : uint8_t {
+    FORMAT_BOOL,        // actual as true/false
+    FORMAT_INT,         // expected, actual as decimal (RECORD_*_UNSIGNED flags)
+    FORMAT_HEX32,       // expected, actual as 0x%08x
+    FORMAT_POINTER,     // pointer
+    FORMAT_STRING,      // first divergence and a window of both texts, quoted
+    FORMAT_FLOAT,       // expected, delta, actual
+    FORMAT_SCOREBOARD,  // index, initial, final
+    FORMAT_VALIDATION,  // operation, expected, actual
+    FORMAT_REAL,        // expected, actual as floating point
+    FORMAT_ARRAY,       // first mismatch, mismatch count, hex window of both arrays
+    FORMAT_TOLERANCE,   // limit, worst element, error statistics of two real arrays
+    FORMAT_SCALAR       // kind table only: chosen from the operand types when recorded
+};
+
+// AssertRecord::flags
+enum RecordFlags : uint8_t {
+    RECORD_EXPECTED_UNSIGNED = 0x01,
+    RECORD_ACTUAL_UNSIGNED = 0x02,
+    RECORD_DOUBLE_PRECISION = 0x04
+};
+
+// How a real-array assertion judges its elements
+enum ToleranceMode : uint8_t {
+    TOLERANCE_ABSOLUTE,  // |actual - expected| <= limit, element by element
+    TOLERANCE_RELATIVE,  // |actual - expected| <= limit * |expected|
+    TOLERANCE_ULPS,      // at most `limit` representable values apart
+    TOLERANCE_RMS        // root mean square of all errors <= limit
+};
+
+// AssertRecord::value.s.nulls
+enum TextNulls : uint8_t {
+    TEXT_EXPECTED_NULL = 0x01,
+    TEXT_ACTUAL_NULL = 0x02
+};
+
+// Text lengths and offsets; AVR RAM never holds more than 64 KiB
+#ifdef __AVR__
+typedef uint16_t TextLength;
+#else
+typedef uint32_t TextLength;
+#endif
+
+// Longest assertion name plus terminator
+#define ENHANCED_UNITY_KIND_NAME_LENGTH 40
+
+// Names are stored inline so the whole table can live in flash
+struct AssertKindInfo {
+    char name[ENHANCED_UNITY_KIND_NAME_LENGTH];
+    uint8_t format;
+};
+
+inline const AssertKindInfo& assertKindInfo(uint8_t kind) {
+    static const AssertKindInfo table[ASSERT_KIND_COUNT] ENHANCED_UNITY_FLASH_DATA = {
+        { "TEST_ASSERT_TRUE",                FORMAT_BOOL },
+        { "TEST_ASSERT_FALSE",               FORMAT_BOOL },
+        { "TEST_ASSERT_EQUAL_INT",           FORMAT_INT },
+        { "TEST_ASSERT_EQUAL_UINT32",        FORMAT_HEX32 },
+        { "TEST_ASSERT_EQUAL_UINT8",         FORMAT_INT },
+        { "TEST_ASSERT_NOT_EQUAL",           FORMAT_SCALAR },
+        { "TEST_ASSERT_GREATER_THAN",        FORMAT_SCALAR },
+        { "TEST_ASSERT_GREATER_THAN_UINT32", FORMAT_HEX32 },
+        { "TEST_ASSERT_LESS_THAN_UINT32",    FORMAT_HEX32 },
+        { "TEST_ASSERT_LE_UINT32",           FORMAT_HEX32 },
+        { "TEST_ASSERT_GE_UINT32",           FORMAT_HEX32 },
+        { "TEST_ASSERT_LESS_THAN",           FORMAT_SCALAR },
+        { "TEST_ASSERT_NULL",                FORMAT_POINTER },
+        { "TEST_ASSERT_NOT_NULL",            FORMAT_POINTER },
+        { "TEST_ASSERT_EQUAL_STRING",        FORMAT_STRING },
+        { "TEST_ASSERT_FLOAT_WITHIN",        FORMAT_FLOAT },
+        { "TEST_ASSERT_SCOREBOARD_INCREASED", FORMAT_SCOREBOARD },
+        { "TEST_ASSERT_VALIDATION_RESULT",   FORMAT_VALIDATION },
+        { "ENHANCED_UNITY_BENCHMARK_MAX_NS", FORMAT_INT },
+        { "TEST_ASSERT_HEAP_DELTA_LE",       FORMAT_INT },
+        { "TEST_ASSERT_HEAP_PEAK_LE",        FORMAT_INT },
+        { "TEST_ASSERT_STACK_FREE_GE",       FORMAT_INT },
+        { "TEST_ASSERT_EQUAL",               FORMAT_SCALAR },
+        { "TEST_ASSERT_GREATER_OR_EQUAL",    FORMAT_SCALAR },
+        { "TEST_ASSERT_LESS_OR_EQUAL",       FORMAT_SCALAR },
+        { "TEST_ASSERT_DOUBLE_WITHIN",       FORMAT_FLOAT },
+        { "TEST_ASSERT_EQUAL_MEMORY",        FORMAT_ARRAY },
+        { "TEST_ASSERT_EQUAL_UINT8_ARRAY",   FORMAT_ARRAY },
+        { "TEST_ASSERT_EQUAL_INT16_ARRAY",   FORMAT_ARRAY },
+        { "TEST_ASSERT_EQUAL_UINT32_ARRAY",  FORMAT_ARRAY },
+        { "TEST_ASSERT_EQUAL_INT64_ARRAY",   FORMAT_ARRAY },
+        { "TEST_ASSERT_FLOAT_ARRAY_WITHIN",  FORMAT_TOLERANCE },
+        { "TEST_ASSERT_DOUBLE_ARRAY_WITHIN", FORMAT_TOLERANCE },
+        { "TEST_ASSERT_FLOAT_ARRAY_RELATIVE", FORMAT_TOLERANCE },
+        { "TEST_ASSERT_DOUBLE_ARRAY_RELATIVE", FORMAT_TOLERANCE },
+        { "TEST_ASSERT_FLOAT_ARRAY_ULPS",    FORMAT_TOLERANCE },
+        { "TEST_ASSERT_DOUBLE_ARRAY_ULPS",   FORMAT_TOLERANCE },
+        { "TEST_ASSERT_FLOAT_ARRAY_RMS",     FORMAT_TOLERANCE },
+        { "TEST_ASSERT_DOUBLE_ARRAY_RMS",    FORMAT_TOLERANCE },
+        { "TEST_ASSERT_EQUAL_STRING_LEN",    FORMAT_STRING },
+        { "TEST_ASSERT_EQUAL_PAYLOAD",       FORMAT_STRING },
+        { "ENHANCED_UNITY_BULK_SCOPE",       FORMAT_VALIDATION },
+        { "TEST_ASSERT_PROPERTY",            FORMAT_VALIDATION },
+        { "TEST_ASSERT_CPU_MS_LE",           FORMAT_INT },
+        { "TEST_ASSERT_MINOR_FAULTS_LE",     FORMAT_INT },
+        { "TEST_ASSERT_MAJOR_FAULTS_LE",     FORMAT_INT },
+        { "TEST_ASSERT_CONTEXT_SWITCHES_LE", FORMAT_INT },
+        { "TEST_ASSERT_RSS_GROWTH_KB_LE",    FORMAT_INT },
+    };
+    return table[kind < ASSERT_KIND_COUNT ? kind : 0];
+}
+
+// Default ValueFormat of an assertion kind
+inline uint8_t assertKindFormat(uint8_t kind) { return readFlashByte(&assertKindInfo(kind).format); }
+
+// Assertion name; a flash string ("%" ENHANCED_UNITY_FLASH_S)
+inline const char* assertKindName(uint8_t kind) { return assertKindInfo(kind).name; }
+
+struct AssertRecord {
+    uint8_t kind;
+    uint8_t passed;
+    uint8_t fileId;
+    uint8_t format;  // ValueFormat
+    uint8_t flags;   // RecordFlags
+    uint16_t line;
+    union {
+        // Integers widened to 64 bits; unsigned operands are flagged, not converted
+        struct { int64_t expected; int64_t actual; int32_t extra; } i;
+        struct { double expected; double delta; double actual; } f;
+        const void* pointer;
+        // Bytes [offset - lead, offset - lead + *Kept) of both texts; not terminated
+        struct {
+            TextLength expectedLength;
+            TextLength actualLength;
+            TextLength offset;      // first differing byte (0 on a pass)
+            TextLength line;        // 1-based line and column of `offset` in expected
+            TextLength column;
+            uint8_t lead;           // kept bytes before `offset`
+            uint8_t expectedKept;
+            uint8_t actualKept;
+            uint8_t nulls;          // TextNulls
+            char expected[ENHANCED_UNITY_RECORD_STRING_LENGTH];
+            char actual[ENHANCED_UNITY_RECORD_STRING_LENGTH];
+        } s;
+        struct {
+            int32_t expected;
+            int32_t actual;
+            char operation[ENHANCED_UNITY_RECORD_STRING_LENGTH];
+        } v;
+        // Elements [windowStart, windowStart + windowBytes / elementSize) of both arrays
+        struct {
+            uint32_t count;        // elements compared
+            uint32_t mismatch;     // first mismatching element
+            uint32_t mismatches;   // mismatching elements in total
+            uint32_t windowStart;
+            uint8_t elementSize;
+            uint8_t windowBytes;
+            uint8_t expected[ENHANCED_UNITY_ARRAY_WINDOW];
+            uint8_t actual[ENHANCED_UNITY_ARRAY_WINDOW];
+        } a;
+        // Real arrays compared under a ToleranceMode
+        struct {
+            uint32_t count;
+            uint32_t worst;       // element with the largest error
+            uint32_t outside;     // elements beyond the limit (0 in TOLERANCE_RMS)
+            uint8_t mode;         // ToleranceMode
+            double limit;
+            double expected;      // the elements at `worst`
+            double actual;
+            double worstError;    // absolute, relative or in ULPs, by mode
+            double rms;           // root mean square of the absolute errors
+        } t;
+    } value;
+};
+
+// Records of one counter context, rendered and cleared at each flush
+struct RecordBuffer {
+    AssertRecord records[ENHANCED_UNITY_RECORD_CAPACITY];
+    int count = 0;
+    int overflowCount = 0;
+    SpinLock lock;
+};
+
+} // namespace enhanced_unity
+
+// ============================================================================
+// TIMING
+// ============================================================================
+// Methods, files and the whole run are timestamped at their START/END macros
+// (micros() on Arduino, std::chrono::steady_clock on native). Every finished
+// method is offered to a small min-heap that keeps the slowest N for the
+// final summary. Cost per method: two clock reads and an O(log N) insert.
+// ============================================================================
+
+// 1 = report durations, 0 = no clock reads and the original output
+#ifndef ENHANCED_UNITY_TIMING
+#define ENHANCED_UNITY_TIMING 1
+#endif
+
+// Slowest methods listed by ENHANCED_UNITY_FINAL_SUMMARY() (0 = none)
+#ifndef ENHANCED_UNITY_SLOWEST_METHODS
+#ifdef __AVR__
+#define ENHANCED_UNITY_SLOWEST_METHODS 3
+#else
+#define ENHANCED_UNITY_SLOWEST_METHODS 10
+#endif
+#endif
+
+// Timed-out methods listed by ENHANCED_UNITY_FINAL_SUMMARY(), longest first;
+// all of them are counted (see enhanced_unity_watchdog.hpp)
+#ifndef ENHANCED_UNITY_TIMED_OUT_METHODS
+#if defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_TIMED_OUT_METHODS 16
+#elif defined(ESP32) || defined(ARDUINO_ARCH_ESP32)
+#define ENHANCED_UNITY_TIMED_OUT_METHODS 4
+#else
+#define ENHANCED_UNITY_TIMED_OUT_METHODS 0
+#endif
+#endif
+
+#ifdef CONFIGMGR_NATIVE
+#include <chrono>
+#endif
+
+namespace enhanced_unity {
+
+#ifdef CONFIGMGR_NATIVE
+typedef uint64_t TimeMicros;
+
+inline TimeMicros nowMicros() {
+    return (TimeMicros)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#else
+// micros() wraps after ~71 minutes; unsigned differences stay correct below that
+typedef uint32_t TimeMicros;
+
+inline TimeMicros nowMicros() {
+    return (TimeMicros)micros();
+}
+#endif
+
+// Whole and fractional milliseconds, for "%lu.%03lu ms" (no %f on AVR)
+inline unsigned long wholeMillis(TimeMicros duration) { return (unsigned long)(duration / 1000); }
+inline unsigned long fractionMillis(TimeMicros duration) { return (unsigned long)(duration % 1000); }
+
+// Bounded min-heap keeping the Capacity entries with the largest rank(): the
+// root is the smallest kept entry, so a newcomer only has to beat the root
+template <typename Entry, int Capacity>
+struct TopEntries {
+    Entry entries[Capacity > 0 ? Capacity : 1];
+    int count;
+
+    void clear() { count = 0; }
+
+    void add(const Entry& entry) {
+        if (Capacity <= 0) {
+            return;
+        }
+        if (count < Capacity) {
+            int child = count++;
+            while (child > 0 && entries[(child - 1) / 2].rank() > entry.rank()) {
+                entries[child] = entries[(child - 1) / 2];
+                child = (child - 1) / 2;
+            }
+            entries[child] = entry;
+        } else if (entry.rank() > entries[0].rank()) {
+            int parent = 0;
+            for (;;) {
+                int child = 2 * parent + 1;
+                if (child >= count) {
+                    break;
+                }
+                if (child + 1 < count && entries[child + 1].rank() < entries[child].rank()) {
+                    child++;
+                }
+                if (entries[child].rank() >= entry.rank()) {
+                    break;
+                }
+                entries[parent] = entries[child];
+                parent = child;
+            }
+            entries[parent] = entry;
+        }
+    }
+
+    void merge(const TopEntries& other) {
+        for (int i = 0; i < other.count; i++) {
+            add(other.entries[i]);
+        }
+    }
+
+    // Largest first; destroys the heap order, so sort a copy
+    void sortDescending() {
+        for (int i = 1; i < count; i++) {
+            Entry entry = entries[i];
+            int j = i;
+            for (; j > 0 && entries[j - 1].rank() < entry.rank(); j--) {
+                entries[j] = entries[j - 1];
+            }
+            entries[j] = entry;
+        }
+    }
+};
+
+struct MethodTiming {
+    const char* name;
+    TimeMicros duration;
+
+    TimeMicros rank() const { return duration; }
+};
+
+typedef TopEntries<MethodTiming, ENHANCED_UNITY_SLOWEST_METHODS> SlowestMethods;
+typedef TopEntries<MethodTiming, ENHANCED_UNITY_TIMED_OUT_METHODS> TimedOutMethods;
+
+} // namespace enhanced_unity
+
+// ============================================================================
+// MEMORY
+// ============================================================================
+// Heap use and stack headroom are sampled at START/END_TEST_METHOD:
+//   ESP32   heap_caps free / minimum-ever-free, FreeRTOS stack high-water mark
+//   AVR     __brkval above __heap_start; free stack by painting the gap
+//           between heap and stack pointer and finding the deepest overwrite
+//   native  bytes live through the replaced global operator new/delete
+//           (a stand-in for a malloc hook; plain malloc() is not seen)
+// Each method reports its heap delta (end - start), its heap peak above the
+// start and the lowest free stack seen. The ESP32 minimum-free figure cannot
+// be reset, so there a peak only shows once it goes below the earlier low.
+// ============================================================================
+
+#if defined(ESP32) || defined(ARDUINO_ARCH_ESP32)
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#define ENHANCED_UNITY_MEMORY_SUPPORTED 1
+#elif defined(__AVR__)
+#define ENHANCED_UNITY_MEMORY_SUPPORTED 1
+#elif defined(CONFIGMGR_NATIVE) && (defined(__GLIBC__) || defined(__APPLE__))
+#include <atomic>
+#define ENHANCED_UNITY_MEMORY_SUPPORTED 1
+#else
+#define ENHANCED_UNITY_MEMORY_SUPPORTED 0
+#endif
+
+// 1 = sample and report memory per method (where supported)
+#ifndef ENHANCED_UNITY_MEMORY
+#define ENHANCED_UNITY_MEMORY ENHANCED_UNITY_MEMORY_SUPPORTED
+#endif
+
+// Methods listed in the memory table of ENHANCED_UNITY_FINAL_SUMMARY() (0 = none)
+#ifndef ENHANCED_UNITY_MEMORY_METHODS
+#ifdef __AVR__
+#define ENHANCED_UNITY_MEMORY_METHODS 3
+#else
+#define ENHANCED_UNITY_MEMORY_METHODS 5
+#endif
+#endif
+
+#if ENHANCED_UNITY_MEMORY && defined(CONFIGMGR_NATIVE)
+// Maintained by the operator new/delete replacements in enhanced_unity.cpp
+extern std::atomic<int64_t> _enhancedUnityHeapUsed;
+extern std::atomic<int64_t> _enhancedUnityHeapPeak;
+#endif
+
+#if ENHANCED_UNITY_MEMORY && defined(__AVR__)
+extern "C" {
+extern char __heap_start;
+extern char* __brkval;
+}
+#endif
+
+namespace enhanced_unity {
+
+// -1 = not measurable on this target
+static const int32_t ENHANCED_UNITY_STACK_UNKNOWN = -1;
+
+#if ENHANCED_UNITY_MEMORY && (defined(ESP32) || defined(ARDUINO_ARCH_ESP32))
+
+inline int32_t heapUsedBytes() {
+    return (int32_t)(heap_caps_get_total_size(MALLOC_CAP_DEFAULT) - heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+}
+
+inline int32_t heapPeakBytes() {
+    return (int32_t)(heap_caps_get_total_size(MALLOC_CAP_DEFAULT) - heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT));
+}
+
+inline void resetHeapPeak() {}
+inline void paintStack() {}
+
+// Lowest free stack of the calling task since it started
+inline int32_t stackFreeBytes() {
+    return (int32_t)uxTaskGetStackHighWaterMark(nullptr);
+}
+
+#elif ENHANCED_UNITY_MEMORY && defined(__AVR__)
+
+static const uint8_t ENHANCED_UNITY_STACK_PAINT = 0xA5;
+
+inline char* avrHeapTop() {
+    return __brkval != nullptr ? __brkval : &__heap_start;
+}
+
+inline int32_t heapUsedBytes() {
+    return (int32_t)(avrHeapTop() - &__heap_start);
+}
+
+// The break only moves down when the topmost block is freed
+inline int32_t heapPeakBytes() {
+    return heapUsedBytes();
+}
+
+inline void resetHeapPeak() {}
+
+// Fill the unused gap below the current frame with a known byte
+inline void paintStack() {
+    char marker;
+    for (char* p = avrHeapTop(); p < &marker - 16; p++) {
+        *p = (char)ENHANCED_UNITY_STACK_PAINT;
+    }
+}
+
+// Untouched paint left above the heap = lowest free stack since paintStack()
+inline int32_t stackFreeBytes() {
+    char marker;
+    char* p = avrHeapTop();
+    while (p < &marker && (uint8_t)*p == ENHANCED_UNITY_STACK_PAINT) {
+        p++;
+    }
+    return (int32_t)(p - avrHeapTop());
+}
+
+#elif ENHANCED_UNITY_MEMORY && defined(CONFIGMGR_NATIVE)
+
+inline int32_t heapUsedBytes() {
+    return (int32_t)_enhancedUnityHeapUsed.load(std::memory_order_relaxed);
+}
+
+inline int32_t heapPeakBytes() {
+    return (int32_t)_enhancedUnityHeapPeak.load(std::memory_order_relaxed);
+}
+
+// Process-wide: overlapping parallel tests see each other's allocations
+inline void resetHeapPeak() {
+    _enhancedUnityHeapPeak.store(_enhancedUnityHeapUsed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+inline void paintStack() {}
+inline int32_t stackFreeBytes() { return ENHANCED_UNITY_STACK_UNKNOWN; }
+
+#else
+
+inline int32_t heapUsedBytes() { return 0; }
+inline int32_t heapPeakBytes() { return 0; }
+inline void resetHeapPeak() {}
+inline void paintStack() {}
+inline int32_t stackFreeBytes() { return ENHANCED_UNITY_STACK_UNKNOWN; }
+
+#endif
+
+struct MethodMemory {
+    const char* name;
+    int32_t heapPeak;   // bytes above the heap use at method start
+    int32_t heapDelta;  // heap use at end minus start
+    int32_t stackFree;  // lowest free stack, or ENHANCED_UNITY_STACK_UNKNOWN
+
+    int32_t rank() const { return heapPeak; }
+};
+
+typedef TopEntries<MethodMemory, ENHANCED_UNITY_MEMORY_METHODS> HungriestMethods;
+
+} // namespace enhanced_unity
+
+// ============================================================================
+// RESOURCE USAGE (CONFIGMGR_NATIVE)
+// ============================================================================
+// Sampled at START/END_TEST_METHOD on the thread running the method:
+//   cpu      CLOCK_THREAD_CPUTIME_ID
+//   user/sys, minor/major faults, voluntary/involuntary context switches
+//            getrusage(RUSAGE_THREAD) on Linux; RUSAGE_SELF elsewhere, where
+//            overlapping parallel tests are charged for each other
+//   rss      growth of the process's peak resident set (ru_maxrss), which is
+//            process-wide everywhere and only moves when a new peak is set
+// ============================================================================
+
+#if defined(CONFIGMGR_NATIVE) && (defined(__unix__) || defined(__APPLE__))
+#include <cstdlib>
+#include <sys/resource.h>
+#include <time.h>
+#define ENHANCED_UNITY_RUSAGE_SUPPORTED 1
+#else
+#define ENHANCED_UNITY_RUSAGE_SUPPORTED 0
+#endif
+
+// 1 = sample and report resource use per method (where supported)
+#ifndef ENHANCED_UNITY_RUSAGE
+#define ENHANCED_UNITY_RUSAGE ENHANCED_UNITY_RUSAGE_SUPPORTED
+#endif
+
+// Methods listed in the resource table of ENHANCED_UNITY_FINAL_SUMMARY() (0 = none)
+#ifndef ENHANCED_UNITY_RUSAGE_METHODS
+#define ENHANCED_UNITY_RUSAGE_METHODS 5
+#endif
+
+namespace enhanced_unity {
+
+// Columns of the resource table; the sort column ranks it
+enum ResourceColumn : uint8_t {
+    RESOURCE_CPU,            // µs
+    RESOURCE_USER,           // µs
+    RESOURCE_SYSTEM,         // µs
+    RESOURCE_MINOR_FAULTS,
+    RESOURCE_MAJOR_FAULTS,
+    RESOURCE_VOLUNTARY,      // context switches
+    RESOURCE_INVOLUNTARY,
+    RESOURCE_RSS_GROWTH,     // kB
+    RESOURCE_COLUMN_COUNT
+};
+
+struct MethodResources {
+    const char* name;
+    int32_t values[RESOURCE_COLUMN_COUNT];
+
+    int32_t rank() const;
+};
+
+#if ENHANCED_UNITY_RUSAGE
+
+inline const char* resourceColumnName(ResourceColumn column) {
+    static const char* const names[RESOURCE_COLUMN_COUNT] = {
+        "cpu", "user", "sys", "minflt", "majflt", "vcsw", "ivcsw", "rss"
+    };
+    return names[column < RESOURCE_COLUMN_COUNT ? column : 0];
+}
+
+// False for a name that is no column
+inline bool parseResourceColumn(const char* text, ResourceColumn& column) {
+    for (int i = 0; i < RESOURCE_COLUMN_COUNT; i++) {
+        if (strcmp(text, resourceColumnName((ResourceColumn)i)) == 0) {
+            column = (ResourceColumn)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ENHANCED_UNITY_RUSAGE_SORT from the environment, else cpu; --rusage-sort
+// changes it. Set it before the first method: the table keeps the top
+// entries of the column current when each method ends.
+inline ResourceColumn& resourceSortColumn() {
+    static ResourceColumn column = []() {
+        ResourceColumn initial = RESOURCE_CPU;
+        const char* text = getenv("ENHANCED_UNITY_RUSAGE_SORT");
+        if (text != nullptr && !parseResourceColumn(text, initial)) {
+            initial = RESOURCE_CPU;
+        }
+        return initial;
+    }();
+    return column;
+}
+
+inline int32_t MethodResources::rank() const { return values[resourceSortColumn()]; }
+
+struct ResourceSample {
+    int64_t values[RESOURCE_COLUMN_COUNT];  // running totals; rss = peak in kB
+};
+
+inline int64_t timevalMicros(const struct timeval& time) {
+    return (int64_t)time.tv_sec * 1000000 + time.tv_usec;
+}
+
+inline ResourceSample sampleResources() {
+    ResourceSample sample = {};
+    struct timespec cpu;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu) == 0) {
+        sample.values[RESOURCE_CPU] = (int64_t)cpu.tv_sec * 1000000 + cpu.tv_nsec / 1000;
+    }
+    struct rusage usage;
+#ifdef RUSAGE_THREAD
+    int who = RUSAGE_THREAD;
+#else
+    int who = RUSAGE_SELF;
+#endif
+    bool sampled = getrusage(who, &usage) == 0;
+    if (sampled) {
+        sample.values[RESOURCE_USER] = timevalMicros(usage.ru_utime);
+        sample.values[RESOURCE_SYSTEM] = timevalMicros(usage.ru_stime);
+        sample.values[RESOURCE_MINOR_FAULTS] = usage.ru_minflt;
+        sample.values[RESOURCE_MAJOR_FAULTS] = usage.ru_majflt;
+        sample.values[RESOURCE_VOLUNTARY] = usage.ru_nvcsw;
+        sample.values[RESOURCE_INVOLUNTARY] = usage.ru_nivcsw;
+    }
+    if (who != RUSAGE_SELF) {
+        sampled = getrusage(RUSAGE_SELF, &usage) == 0;
+    }
+    if (sampled) {
+#ifdef __APPLE__
+        sample.values[RESOURCE_RSS_GROWTH] = usage.ru_maxrss / 1024;  // bytes there
+#else
+        sample.values[RESOURCE_RSS_GROWTH] = usage.ru_maxrss;
+#endif
+    }
+    return sample;
+}
+
+// Use between `start` and now
+inline MethodResources resourcesSince(const ResourceSample& start) {
+    ResourceSample now = sampleResources();
+    MethodResources resources = {};
+    for (int i = 0; i < RESOURCE_COLUMN_COUNT; i++) {
+        int64_t delta = now.values[i] - start.values[i];
+        resources.values[i] = delta > 0 ? (int32_t)(delta < INT32_MAX ? delta : INT32_MAX) : 0;
+    }
+    return resources;
+}
+
+#else
+
+inline int32_t MethodResources::rank() const { return 0; }
+
+#endif
+
+typedef TopEntries<MethodResources, ENHANCED_UNITY_RUSAGE_METHODS> BusiestMethods;
+
+} // namespace enhanced_unity
+
+// ============================================================================
+// COUNTER CONTEXT
+// ============================================================================
+// All pass/fail bookkeeping lives in a CounterContext. The per-assertion
+// counters are kept in per-thread shards, each on its own cache line, so
+// assertions never contend; shards only grow and are summed at method, file
+// and summary boundaries. Boundary counters are owned by the thread running
+// the START/END macros.
+// ============================================================================
+
+namespace enhanced_unity {
+
+#if ENHANCED_UNITY_THREAD_SAFE
+// Only the owning thread writes a shard counter, so a relaxed load/store pair
+// is enough and avoids a locked read-modify-write on the hot path
+class ShardCounter {
+public:
+    void increment() { value_.store(value_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    int get() const { return value_.load(std::memory_order_relaxed); }
+    // Back to an earlier value; only the owning thread, and only while no
+    // baseline was taken in between (bulk scopes)
+    void rewind(int value) { value_.store(value, std::memory_order_relaxed); }
+private:
+    std::atomic<int> value_{0};
+};
+#else
+class ShardCounter {
+public:
+    void increment() { value_++; }
+    int get() const { return value_; }
+    void rewind(int value) { value_ = value; }
+private:
+    int value_ = 0;
+};
+#endif
+
+struct ENHANCED_UNITY_SHARD_ALIGN CounterShard {
+    ShardCounter assertions;
+    ShardCounter assertionFailures;
+#if ENHANCED_UNITY_THREAD_SAFE
+    std::atomic<bool> inUse{false};
+    CounterShard* next = nullptr;
+#endif
+};
+
+// Plain copy of a context's totals, e.g. to hand results across processes
+struct CounterSnapshot {
+    int32_t assertions;
+    int32_t assertionFailures;
+    int32_t assertionFileCount;
+    int32_t assertionFileFailureCount;
+    int32_t methodCount;
+    int32_t methodFailureCount;
+    int32_t methodFileCount;
+    int32_t methodFileFailureCount;
+    int32_t methodTotalCount;
+    int32_t methodTotalFailureCount;
+    int32_t testCount;
+    int32_t testFailureCount;
+    int32_t methodCachedCount;
+    int32_t methodTimeoutCount;
+    int32_t extraFailureCount;
+    TimeMicros methodTotalMicros;
+    SlowestMethods slowestMethods;
+    HungriestMethods hungriestMethods;
+    TimedOutMethods timedOutMethods;
+#if ENHANCED_UNITY_RUSAGE
+    BusiestMethods busiestMethods;
+#endif
+};
+
+class CounterContext {
+public:
+    // Current method, resolved from the shards at method boundaries
+    int assertionCount = 0;
+    int assertionFailureCount = 0;
+    // Current file
+    int assertionFileCount = 0;
+    int assertionFileFailureCount = 0;
+    int methodCount = 0;
+    int methodFailureCount = 0;
+    int methodFileCount = 0;
+    int methodFileFailureCount = 0;
+    // Whole run
+    int methodTotalCount = 0;
+    int methodTotalFailureCount = 0;
+    int testCount = 0;
+    int testFailureCount = 0;
+    // Tests skipped because the result cache holds a pass for them
+    int methodCachedCount = 0;
+    // Methods aborted by the watchdog, and the longest of them
+    int methodTimeoutCount = 0;
+    TimedOutMethods timedOutMethods = {};
+    // Tests failed for being slower than their timing history (--history-fail)
+    int historyFailureCount = 0;
+    // Failures recorded outside assertions (aborts, setUp errors)
+    int extraFailureCount = 0;
+    // Assertions absorbed from other contexts (parallel workers)
+    int mergedAssertions = 0;
+    int mergedAssertionFailures = 0;
+
+    // Timing (ENHANCED_UNITY_TIMING); method names must outlive the run
+    const char* methodName = nullptr;
+    uint8_t methodFileId = ENHANCED_UNITY_UNKNOWN_FILE_ID;  // for records without a file
+    TimeMicros methodStartMicros = 0;
+    TimeMicros methodMicros = 0;
+    TimeMicros fileStartMicros = 0;
+    TimeMicros fileMicros = 0;
+    TimeMicros runStartMicros = 0;
+    TimeMicros methodTotalMicros = 0;
+    SlowestMethods slowestMethods = {};
+
+    // Memory (ENHANCED_UNITY_MEMORY), sampled on the method's thread
+    int32_t heapStartUsed = 0;
+    int32_t heapStartPeak = 0;
+    MethodMemory methodMemory = {};
+    HungriestMethods hungriestMethods = {};
+
+#if ENHANCED_UNITY_RUSAGE
+    // Resource use (ENHANCED_UNITY_RUSAGE), sampled on the method's thread
+    ResourceSample resourceStart = {};
+    MethodResources methodResources = {};
+    BusiestMethods busiestMethods = {};
+#endif
+
+    CounterContext();
+    ~CounterContext();
+    CounterContext(const CounterContext&) = delete;
+    CounterContext& operator=(const CounterContext&) = delete;
+
+    // Shards are monotonic; resets move these baselines instead
+    int methodAssertionBase = 0;
+    int methodFailureBase = 0;
+    int runAssertionBase = 0;
+    int runFailureBase = 0;
+    int failureResetBase = 0;
+
+    unsigned id() const { return id_; }
+
+    // Records go to the shared buffer unless the context was given its own
+    RecordBuffer& recordBuffer();
+    void setRecordBuffer(RecordBuffer* buffer) { records_ = buffer; }
+
+    int rawAssertions() const;
+    int rawAssertionFailures() const;
+
+    int totalAssertions() const { return rawAssertions() - runAssertionBase; }
+    int totalAssertionFailures() const { return rawAssertionFailures() - runFailureBase; }
+    int failureCount() const { return rawAssertionFailures() - failureResetBase + extraFailureCount; }
+
+    void resetFailureCount() {
+        failureResetBase = rawAssertionFailures();
+        extraFailureCount = 0;
+    }
+
+    void reset() {
+        assertionCount = assertionFailureCount = 0;
+        assertionFileCount = assertionFileFailureCount = 0;
+        methodCount = methodFailureCount = methodFileCount = methodFileFailureCount = 0;
+        methodTotalCount = methodTotalFailureCount = 0;
+        testCount = testFailureCount = 0;
+        methodCachedCount = methodTimeoutCount = historyFailureCount = 0;
+        timedOutMethods.clear();
+        mergedAssertions = mergedAssertionFailures = 0;
+        methodMicros = fileMicros = methodTotalMicros = 0;
+        slowestMethods.clear();
+        hungriestMethods.clear();
+#if ENHANCED_UNITY_RUSAGE
+        busiestMethods.clear();
+#endif
+        runStartMicros = ENHANCED_UNITY_TIMING ? nowMicros() : 0;
+        runAssertionBase = methodAssertionBase = rawAssertions();
+        runFailureBase = methodFailureBase = rawAssertionFailures();
+        resetFailureCount();
+    }
+
+    CounterSnapshot snapshot() const {
+        CounterSnapshot result;
+        result.assertions = totalAssertions();
+        result.assertionFailures = totalAssertionFailures();
+        result.assertionFileCount = assertionFileCount;
+        result.assertionFileFailureCount = assertionFileFailureCount;
+        result.methodCount = methodCount;
+        result.methodFailureCount = methodFailureCount;
+        result.methodFileCount = methodFileCount;
+        result.methodFileFailureCount = methodFileFailureCount;
+        result.methodTotalCount = methodTotalCount;
+        result.methodTotalFailureCount = methodTotalFailureCount;
+        result.testCount = testCount;
+        result.testFailureCount = testFailureCount;
+        result.methodCachedCount = methodCachedCount;
+        result.methodTimeoutCount = methodTimeoutCount;
+        result.timedOutMethods = timedOutMethods;
+        result.extraFailureCount = extraFailureCount;
+        result.methodTotalMicros = methodTotalMicros;
+        result.slowestMethods = slowestMethods;
+        result.hungriestMethods = hungriestMethods;
+#if ENHANCED_UNITY_RUSAGE
+        result.busiestMethods = busiestMethods;
+#endif
+        return result;
+    }
+
+    // Add the totals of a finished context (worker, process, shard) to this one
+    void absorb(const CounterSnapshot& other) {
+        assertionFileCount += other.assertionFileCount;
+        assertionFileFailureCount += other.assertionFileFailureCount;
+        methodCount += other.methodCount;
+        methodFailureCount += other.methodFailureCount;
+        methodFileCount += other.methodFileCount;
+        methodFileFailureCount += other.methodFileFailureCount;
+        methodTotalCount += other.methodTotalCount;
+        methodTotalFailureCount += other.methodTotalFailureCount;
+        testCount += other.testCount;
+        testFailureCount += other.testFailureCount;
+        methodCachedCount += other.methodCachedCount;
+        methodTimeoutCount += other.methodTimeoutCount;
+        timedOutMethods.merge(other.timedOutMethods);
+        extraFailureCount += other.extraFailureCount;
+        mergedAssertions += other.assertions;
+        mergedAssertionFailures += other.assertionFailures;
+        methodTotalMicros += other.methodTotalMicros;
+        slowestMethods.merge(other.slowestMethods);
+        hungriestMethods.merge(other.hungriestMethods);
+#if ENHANCED_UNITY_RUSAGE
+        busiestMethods.merge(other.busiestMethods);
+#endif
+    }
+
+    CounterShard* acquireShard();
+    static void releaseShard(CounterShard* shard);
+
+private:
+    unsigned id_;
+    RecordBuffer* records_ = nullptr;
+#if ENHANCED_UNITY_THREAD_SAFE
+    std::atomic<CounterShard*> shards_{nullptr};
+#else
+    CounterShard shard_;
+#endif
+};
+
+} // namespace enhanced_unity
+
+// Default context used by every thread that has not selected its own
+extern enhanced_unity::CounterContext _enhancedUnityCounters;
+extern enhanced_unity::RecordBuffer _enhancedUnityRecords;
+
+namespace enhanced_unity {
+
+inline unsigned nextCounterContextId() {
+#if ENHANCED_UNITY_THREAD_SAFE
+    static std::atomic<unsigned> nextId{1};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+#else
+    static unsigned nextId = 1;
+    return nextId++;
+#endif
+}
+
+inline CounterContext::CounterContext() : id_(nextCounterContextId()) {}
+
+inline RecordBuffer& CounterContext::recordBuffer() {
+    return records_ != nullptr ? *records_ : _enhancedUnityRecords;
+}
+
+#if ENHANCED_UNITY_THREAD_SAFE
+
+// A context must outlive every thread that asserted into it
+inline CounterContext::~CounterContext() {
+    CounterShard* shard = shards_.load(std::memory_order_acquire);
+    while (shard != nullptr) {
+        CounterShard* next = shard->next;
+        delete shard;
+        shard = next;
+    }
+}
+
+inline int CounterContext::rawAssertions() const {
+    int total = mergedAssertions;
+    for (CounterShard* shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+        total += shard->assertions.get();
+    }
+    return total;
+}
+
+inline int CounterContext::rawAssertionFailures() const {
+    int total = mergedAssertionFailures;
+    for (CounterShard* shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+        total += shard->assertionFailures.get();
+    }
+    return total;
+}
+
+// Reuse a shard released by an exited (or switched-away) thread, else add one
+inline CounterShard* CounterContext::acquireShard() {
+    for (CounterShard* shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+        bool expected = false;
+        if (!shard->inUse.load(std::memory_order_relaxed) &&
+            shard->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return shard;
+        }
+    }
+    CounterShard* shard = new CounterShard();
+    shard->inUse.store(true, std::memory_order_relaxed);
+    shard->next = shards_.load(std::memory_order_relaxed);
+    while (!shards_.compare_exchange_weak(shard->next, shard, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return shard;
+}
+
+inline void CounterContext::releaseShard(CounterShard* shard) {
+    if (shard != nullptr) {
+        shard->inUse.store(false, std::memory_order_release);
+    }
+}
+
+// Selected context of the calling thread (nullptr = _enhancedUnityCounters)
+inline CounterContext*& threadCounterContext() {
+    static thread_local CounterContext* context = nullptr;
+    return context;
+}
+
+inline CounterContext& counters() {
+    CounterContext* context = threadCounterContext();
+    return context != nullptr ? *context : _enhancedUnityCounters;
+}
+
+// Hands the calling thread's shard back when the thread exits
+struct ShardReleaser {
+    CounterShard* shard = nullptr;
+    ~ShardReleaser() { CounterContext::releaseShard(shard); }
+};
+
+inline CounterShard* acquireThreadShard(CounterContext& context) {
+    static thread_local ShardReleaser releaser;
+    CounterContext::releaseShard(releaser.shard);
+    releaser.shard = context.acquireShard();
+    return releaser.shard;
+}
+
+// Shard of the calling thread's selected context; cleared whenever the
+// selection changes
+inline CounterShard*& cachedThreadShard() {
+    static thread_local CounterShard* shard = nullptr;
+    return shard;
+}
+
+ENHANCED_UNITY_COLD inline CounterShard& acquireLocalShard() {
+    cachedThreadShard() = acquireThreadShard(counters());
+    return *cachedThreadShard();
+}
+
+// One thread-local load on the assertion path
+inline CounterShard& localShard() {
+    CounterShard* shard = cachedThreadShard();
+    if (ENHANCED_UNITY_LIKELY(shard != nullptr)) {
+        return *shard;
+    }
+    return acquireLocalShard();
+}
+
+// Route the calling thread's counters to another context for a scope
+class ScopedCounterContext {
+public:
+    explicit ScopedCounterContext(CounterContext& context) : previous_(threadCounterContext()) {
+        threadCounterContext() = &context;
+        cachedThreadShard() = nullptr;
+    }
+    ~ScopedCounterContext() {
+        threadCounterContext() = previous_;
+        cachedThreadShard() = nullptr;
+    }
+    ScopedCounterContext(const ScopedCounterContext&) = delete;
+    ScopedCounterContext& operator=(const ScopedCounterContext&) = delete;
+private:
+    CounterContext* previous_;
+};
+
+#else
+
+inline CounterContext::~CounterContext() {}
+inline int CounterContext::rawAssertions() const { return mergedAssertions + shard_.assertions.get(); }
+inline int CounterContext::rawAssertionFailures() const { return mergedAssertionFailures + shard_.assertionFailures.get(); }
+inline CounterShard* CounterContext::acquireShard() { return &shard_; }
+inline void CounterContext::releaseShard(CounterShard*) {}
+
+inline CounterContext& counters() { return _enhancedUnityCounters; }
+
+inline CounterShard& localShard() { return *_enhancedUnityCounters.acquireShard(); }
+
+#endif
+
+inline void countAssertion() { localShard().assertions.increment(); }
+inline void countAssertionFailure() { localShard().assertionFailures.increment(); }
+
+} // namespace enhanced_unity
+
+extern const char* _enhancedUnityFileTable[ENHANCED_UNITY_MAX_FILES];
+extern int _enhancedUnityFileTableCount;
+extern enhanced_unity::SpinLock _enhancedUnityFileTableLock;
+
+namespace enhanced_unity {
+
+// Map a __FILE__ literal to a small id; repeated names share one table entry.
+// On ENHANCED_UNITY_PROGMEM builds the names are flash strings.
+inline uint8_t internFile(const char* fileName) {
+    if (fileName == nullptr) {
+        return ENHANCED_UNITY_UNKNOWN_FILE_ID;
+    }
+    SpinLockGuard guard(_enhancedUnityFileTableLock);
+    for (int i = 0; i < _enhancedUnityFileTableCount; i++) {
+        if (_enhancedUnityFileTable[i] == fileName || flashStringsEqual(_enhancedUnityFileTable[i], fileName)) {
+            return (uint8_t)i;
+        }
+    }
+    if (_enhancedUnityFileTableCount >= ENHANCED_UNITY_MAX_FILES) {
+        return ENHANCED_UNITY_UNKNOWN_FILE_ID;
+    }
+    _enhancedUnityFileTable[_enhancedUnityFileTableCount] = fileName;
+    return (uint8_t)_enhancedUnityFileTableCount++;
+}
+
+inline const char* fileNameForId(uint8_t fileId) {
+    if (fileId >= _enhancedUnityFileTableCount) {
+        return ENHANCED_UNITY_FLASH("<unknown>");
+    }
+    return _enhancedUnityFileTable[fileId];
+}
+
+inline void copyRecordString(char* destination, const char* source) {
+    if (source == nullptr) {
+        source = "(null)";
+    }
+    strncpy(destination, source, ENHANCED_UNITY_RECORD_STRING_LENGTH - 1);
+    destination[ENHANCED_UNITY_RECORD_STRING_LENGTH - 1] = '\0';
+}
+
+// Decimal text of a widened integer (no %lld on AVR); returns a pointer into buffer
+inline const char* formatInteger(char (&buffer)[24], int64_t value, bool isUnsigned) {
+    uint64_t magnitude = isUnsigned || value >= 0 ? (uint64_t)value : 0 - (uint64_t)value;
+    char* p = buffer + sizeof(buffer) - 1;
+    *p = '\0';
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (!isUnsigned && value < 0) {
+        *--p = '-';
+    }
+    return p;
+}
+
+// " 0a 0b *ff" for `elements` elements of an array window, most significant
+// byte first, '*' marking elements that differ from `other`
+inline void formatHexWindow(char* out, const uint8_t* bytes, const uint8_t* other, int elementSize, int elements) {
+    static const char digits[] = "0123456789abcdef";
+    for (int e = 0; e < elements; e++) {
+        const uint8_t* element = bytes + e * elementSize;
+        *out++ = ' ';
+        if (memcmp(element, other + e * elementSize, (size_t)elementSize) != 0) {
+            *out++ = '*';
+        }
+        for (int k = elementSize - 1; k >= 0; k--) {  // all targets are little-endian
+            *out++ = digits[element[k] >> 4];
+            *out++ = digits[element[k] & 0x0F];
+        }
+    }
+    *out = '\0';
+}
+
+// Characters escapeText() writes for one byte
+inline size_t escapedWidth(uint8_t c) {
+    if (c == '\n' || c == '\r' || c == '\t' || c == '"' || c == '\\') {
+        return 2;
+    }
+    return c < 0x20 || c == 0x7F ? 4 : 1;
+}
+
+// Text window as the inside of a C string literal (\n, \", \x01, ...), cut
+// so at most `room` characters are written before the terminator. Returns
+// the bytes escaped; *markColumn receives the column of the character that
+// holds byte `mark` (UTF-8 continuation bytes take no column).
+inline size_t escapeText(char* out, size_t room, const uint8_t* bytes, size_t count, size_t mark,
+                         size_t* markColumn) {
+    static const char digits[] = "0123456789abcdef";
+    size_t used = 0;
+    size_t columns = 0;
+    size_t characterColumn = 0;
+    size_t i = 0;
+    *markColumn = 0;
+    for (; i < count; i++) {
+        uint8_t c = bytes[i];
+        if ((c & 0xC0) != 0x80) {
+            characterColumn = columns;
+        }
+        if (i == mark) {
+            *markColumn = characterColumn;
+        }
+        size_t width = escapedWidth(c);
+        char escaped[4] = { '\\', (char)c, digits[c >> 4], digits[c & 0x0F] };
+        if (width == 1) {
+            escaped[0] = (char)c;
+        } else if (width == 4) {
+            escaped[1] = 'x';
+        } else {
+            escaped[1] = c == '\n' ? 'n' : c == '\r' ? 'r' : c == '\t' ? 't' : (char)c;
+        }
+        if (used + width > room) {
+            break;
+        }
+        memcpy(out + used, escaped, width);
+        used += width;
+        columns += (c & 0xC0) == 0x80 ? 0 : width;
+    }
+    if (mark >= i) {
+        *markColumn = columns;
+    }
+    out[used] = '\0';
+    return i;
+}
+
+// snprintf() whose format stays in flash on ENHANCED_UNITY_PROGMEM builds
+#if ENHANCED_UNITY_PROGMEM
+#define ENHANCED_UNITY_FORMAT(buffer, size, format, ...) snprintf_P((buffer), (size), PSTR(format), ##__VA_ARGS__)
+#else
+#define ENHANCED_UNITY_FORMAT(buffer, size, format, ...) snprintf((buffer), (size), format, ##__VA_ARGS__)
+#endif
+
+// Bytes of one rendered assertion ("TEST_ASSERT_EQUAL_INT(3, 4)")
+#ifndef ENHANCED_UNITY_DETAIL_LENGTH
+#if defined(__AVR__)
+#define ENHANCED_UNITY_DETAIL_LENGTH 64
+#elif defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_DETAIL_LENGTH 256
+#else
+#define ENHANCED_UNITY_DETAIL_LENGTH 160
+#endif
+#endif
+
+// "TEST_ASSERT_...(expected, actual)" for a record: name, then the operands
+#define ENHANCED_UNITY_DETAIL_NAME "%" ENHANCED_UNITY_FLASH_S
+
+// One operand of a text record: NULL, or the escaped window in quotes with
+// "..." where the text goes on. Returns the column of byte `mark`.
+inline size_t formatTextOperand(char* out, size_t room, const char* window, size_t kept, size_t start,
+                                size_t length, bool isNull, size_t mark) {
+    size_t markColumn = 0;
+    if (isNull) {
+        strcpy(out, "NULL");
+        return 0;
+    }
+    const char* before = start > 0 ? "..." : "";
+    char* p = out + strlen(before);
+    strcpy(out, before);
+    *p++ = '"';
+    size_t written = escapeText(p, room, reinterpret_cast<const uint8_t*>(window), kept, mark, &markColumn);
+    p += strlen(p);
+    *p++ = '"';
+    strcpy(p, written < kept || start + kept < length ? "..." : "");
+    return strlen(before) + 1 + markColumn;
+}
+
+// Windows of escaped text each line of a FORMAT_STRING detail can take
+#define ENHANCED_UNITY_TEXT_COLUMNS (ENHANCED_UNITY_DETAIL_LENGTH / 3)
+
+// FORMAT_STRING. A pass or a NULL operand is one line,
+//   TEST_ASSERT_EQUAL_STRING("abc", NULL)
+// a failure names the first differing byte, then shows both windows with a
+// caret under it, as wide as `size` allows:
+//   TEST_ASSERT_EQUAL_STRING(differ at byte 22, line 2:9; 30/30 bytes)
+//       expected "  \"id\": 12,\n}"
+//       actual   "  \"id\": 13,\n}"
+//                        ^
+inline void formatTextDetail(const AssertRecord& record, const char* name, char* detail, size_t size) {
+    char expectedText[ENHANCED_UNITY_TEXT_COLUMNS + 8];
+    char actualText[ENHANCED_UNITY_TEXT_COLUMNS + 8];
+    size_t start = (size_t)(record.value.s.offset - record.value.s.lead);
+    bool expectedNull = (record.value.s.nulls & TEXT_EXPECTED_NULL) != 0;
+    bool actualNull = (record.value.s.nulls & TEXT_ACTUAL_NULL) != 0;
+    if (record.passed || expectedNull || actualNull) {
+        int used = ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(", name);
+        size_t left = used > 0 && (size_t)used < size ? size - (size_t)used : 0;
+        size_t room = left > 32 ? (left - 32) / 2 : 0;  // 32: quotes, "...", ", " and ")" of both
+        room = room < ENHANCED_UNITY_TEXT_COLUMNS ? room : ENHANCED_UNITY_TEXT_COLUMNS;
+        formatTextOperand(expectedText, room, record.value.s.expected, record.value.s.expectedKept, start,
+                          record.value.s.expectedLength, expectedNull, 0);
+        formatTextOperand(actualText, room, record.value.s.actual, record.value.s.actualKept, start,
+                          record.value.s.actualLength, actualNull, 0);
+        if (left > 0) {
+            ENHANCED_UNITY_FORMAT(detail + used, left, "%s, %s)", expectedText, actualText);
+        }
+        return;
+    }
+    char lineText[32] = "";
+    if (record.value.s.line > 1) {
+        ENHANCED_UNITY_FORMAT(lineText, sizeof(lineText), ", line %lu:%lu",
+               (unsigned long)record.value.s.line, (unsigned long)record.value.s.column);
+    }
+    int used = ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(differ at byte %lu%s; %lu/%lu bytes)",
+           name, (unsigned long)record.value.s.offset, lineText,
+           (unsigned long)record.value.s.expectedLength, (unsigned long)record.value.s.actualLength);
+    size_t left = used > 0 && (size_t)used < size ? size - (size_t)used : 0;
+    // Three lines of at most 22 fixed characters each around the windows
+    size_t room = left > 64 ? (left - 64) / 3 : 0;
+    room = room < ENHANCED_UNITY_TEXT_COLUMNS ? room : ENHANCED_UNITY_TEXT_COLUMNS;
+    if (room < 8) {
+        return;  // only the position fits
+    }
+    // Drop leading context until the divergence sits in the first third
+    const uint8_t* lead = reinterpret_cast<const uint8_t*>(record.value.s.expected);
+    size_t skip = 0;
+    size_t leadWidth = 0;
+    for (size_t i = 0; i < record.value.s.lead; i++) {
+        leadWidth += escapedWidth(lead[i]);
+    }
+    while (skip < record.value.s.lead && (leadWidth > room / 3 || (lead[skip] & 0xC0) == 0x80)) {
+        leadWidth -= escapedWidth(lead[skip++]);
+    }
+    size_t caret = formatTextOperand(expectedText, room, record.value.s.expected + skip,
+                                     record.value.s.expectedKept - skip, start + skip,
+                                     record.value.s.expectedLength, false, record.value.s.lead - skip);
+    formatTextOperand(actualText, room, record.value.s.actual + skip, record.value.s.actualKept - skip,
+                      start + skip, record.value.s.actualLength, false, record.value.s.lead - skip);
+    ENHANCED_UNITY_FORMAT(detail + used, left, "\n    expected %s\n    actual   %s\n    %*s^",
+           expectedText, actualText, (int)(9 + caret), "");
+}
+
+inline void formatRecordDetail(const AssertRecord& record, char* detail, size_t size) {
+    const char* name = assertKindName(record.kind);
+    char expectedText[24];
+    char actualText[24];
+    switch (record.format) {
+    case FORMAT_BOOL:
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%" ENHANCED_UNITY_FLASH_S ")", name,
+               record.value.i.actual ? ENHANCED_UNITY_FLASH("true") : ENHANCED_UNITY_FLASH("false"));
+        break;
+    case FORMAT_INT:
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%s, %s)", name,
+               formatInteger(expectedText, record.value.i.expected, (record.flags & RECORD_EXPECTED_UNSIGNED) != 0),
+               formatInteger(actualText, record.value.i.actual, (record.flags & RECORD_ACTUAL_UNSIGNED) != 0));
+        break;
+    case FORMAT_HEX32:
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(0x%08lx, 0x%08lx)", name,
+               (unsigned long)(uint32_t)record.value.i.expected, (unsigned long)(uint32_t)record.value.i.actual);
+        break;
+    case FORMAT_POINTER:
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%p)", name, record.value.pointer);
+        break;
+    case FORMAT_STRING:
+        formatTextDetail(record, name, detail, size);
+        break;
+    case FORMAT_FLOAT:
+        if ((record.flags & RECORD_DOUBLE_PRECISION) != 0) {
+            ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%.17g, %.17g, %.17g)", name,
+                   record.value.f.delta, record.value.f.expected, record.value.f.actual);
+        } else {
+            ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%f, %f, %f)", name,
+                   record.value.f.delta, record.value.f.expected, record.value.f.actual);
+        }
+        break;
+    case FORMAT_SCOREBOARD:
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%ld, 0x%08lx, 0x%08lx)", name,
+               (long)record.value.i.extra,
+               (unsigned long)(uint32_t)record.value.i.expected, (unsigned long)(uint32_t)record.value.i.actual);
+        break;
+    case FORMAT_VALIDATION:
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%s, %ld, %ld)", name,
+               record.value.v.operation, (long)record.value.v.expected, (long)record.value.v.actual);
+        break;
+    case FORMAT_REAL: {
+        // Enough digits to tell apart any two distinct values of the operand type
+        int digits = (record.flags & RECORD_DOUBLE_PRECISION) != 0 ? 17 : 9;
+        ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%.*g, %.*g)", name,
+               digits, record.value.f.expected, digits, record.value.f.actual);
+        break;
+    }
+    case FORMAT_ARRAY: {
+        // "(first mismatch [12] of 64, 3 differ; @10 expected 0a 0b 0c, actual 0a 0b *ff)"
+        char expectedWindow[ENHANCED_UNITY_ARRAY_WINDOW * 4 + 1];
+        char actualWindow[ENHANCED_UNITY_ARRAY_WINDOW * 4 + 1];
+        int elementSize = record.value.a.elementSize > 0 ? record.value.a.elementSize : 1;
+        int elements = record.value.a.windowBytes / elementSize;
+        formatHexWindow(expectedWindow, record.value.a.expected, record.value.a.actual, elementSize, elements);
+        formatHexWindow(actualWindow, record.value.a.actual, record.value.a.expected, elementSize, elements);
+        if (record.value.a.mismatches == 0) {
+            ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%lu equal)", name,
+                   (unsigned long)record.value.a.count);
+        } else if (elements == 0) {  // a null pointer, or elements wider than the window
+            ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(first mismatch [%lu] of %lu, %lu differ)",
+                   name, (unsigned long)record.value.a.mismatch, (unsigned long)record.value.a.count,
+                   (unsigned long)record.value.a.mismatches);
+        } else {
+            ENHANCED_UNITY_FORMAT(detail, size,
+                   ENHANCED_UNITY_DETAIL_NAME "(first mismatch [%lu] of %lu, %lu differ; @%lu expected%s, actual%s)",
+                   name, (unsigned long)record.value.a.mismatch, (unsigned long)record.value.a.count,
+                   (unsigned long)record.value.a.mismatches, (unsigned long)record.value.a.windowStart,
+                   expectedWindow, actualWindow);
+        }
+        break;
+    }
+    case FORMAT_TOLERANCE: {
+        // "(0.001, worst [37] of 1000: expected 1, actual 1.2; max |error| 0.2, rms 0.0063, 3 outside)"
+        int digits = (record.flags & RECORD_DOUBLE_PRECISION) != 0 ? 17 : 9;
+        const char* label = record.value.t.mode == TOLERANCE_RELATIVE ? ENHANCED_UNITY_FLASH("max relative error")
+                          : record.value.t.mode == TOLERANCE_ULPS ? ENHANCED_UNITY_FLASH("max ulps")
+                          : ENHANCED_UNITY_FLASH("max |error|");
+        if (record.passed) {
+            ENHANCED_UNITY_FORMAT(detail, size,
+                   ENHANCED_UNITY_DETAIL_NAME "(%g, %lu within; %" ENHANCED_UNITY_FLASH_S " %.3g, rms %.3g)", name,
+                   record.value.t.limit, (unsigned long)record.value.t.count, label,
+                   record.value.t.worstError, record.value.t.rms);
+            break;
+        }
+        if (record.value.t.worst >= record.value.t.count) {  // one null pointer
+            ENHANCED_UNITY_FORMAT(detail, size, ENHANCED_UNITY_DETAIL_NAME "(%g, %lu elements against NULL)", name,
+                   record.value.t.limit, (unsigned long)record.value.t.count);
+            break;
+        }
+        char outsideText[24] = "";
+        if (record.value.t.mode != TOLERANCE_RMS) {
+            ENHANCED_UNITY_FORMAT(outsideText, sizeof(outsideText), ", %lu outside",
+                   (unsigned long)record.value.t.outside);
+        }
+        ENHANCED_UNITY_FORMAT(detail, size,
+               ENHANCED_UNITY_DETAIL_NAME "(%g, worst [%lu] of %lu: expected %.*g, actual %.*g; "
+               "%" ENHANCED_UNITY_FLASH_S " %.3g, rms %.3g%s)", name,
+               record.value.t.limit, (unsigned long)record.value.t.worst, (unsigned long)record.value.t.count,
+               digits, record.value.t.expected, digits, record.value.t.actual, label,
+               record.value.t.worstError, record.value.t.rms, outsideText);
+        break;
+    }
+    default:
+        detail[0] = '\0';
+        break;
+    }
+}
+
+} // namespace enhanced_unity
+
+#include "enhanced_unity_reporters.hpp"
+#include "enhanced_unity_wire.hpp"
+
+// "    [FAILED] [ASSERTION] line   42  TEST_ASSERT_...(3, 4)": status, line, detail
+#define ENHANCED_UNITY_ASSERTION_LINE "    [%" ENHANCED_UNITY_FLASH_S "] [ASSERTION] line %4u  %s\n"
+
+namespace enhanced_unity {
+
+// Print the record's report line and pass it to the attached reporters. On
+// the wire protocol the line is left to the host decoder.
+inline void renderRecord(const AssertRecord& record) {
+    const CounterContext& c = counters();
+    AssertionEvent event(record, c.methodName != nullptr ? c.methodName : ENHANCED_UNITY_FLASH("<unknown>"),
+                         fileNameForId(record.fileId));
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS && !ENHANCED_UNITY_WIRE_PROTOCOL) {
+        ENHANCED_UNITY_PRINT(ENHANCED_UNITY_ASSERTION_LINE, statusText(event.passed), event.line, event.detail());
+    }
+    if (reporterCount() > 0) {
+        notifyAssertion(event);
+    }
+}
+
+// Render and discard everything currently buffered
+inline void renderRecords(RecordBuffer& buffer) {
+    for (int i = 0; i < buffer.count; i++) {
+        renderRecord(buffer.records[i]);
+    }
+    buffer.count = 0;
+}
+
+// Render buffered records and report any overflow since the last flush
+inline void flushRecords() {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    renderRecords(buffer);
+    if (buffer.overflowCount > 0) {
+#if ENHANCED_UNITY_RECORD_FLUSH_ON_FULL
+        ENHANCED_UNITY_PRINT("    [NOTE] assertion record buffer filled %d time(s), rendered early\n",
+               buffer.overflowCount);
+#else
+        ENHANCED_UNITY_PRINT("    [NOTE] %d assertion record(s) dropped, record buffer full\n",
+               buffer.overflowCount);
+#endif
+        buffer.overflowCount = 0;
+    }
+}
+
+class BulkScope;
+
+// Bulk scope open on the calling thread (enhanced_unity_bulk.hpp), the
+// sample slot the next record goes to instead of the buffer, and whether
+// records are suppressed altogether (property cases, enhanced_unity_property.hpp)
+struct BulkState {
+    BulkScope* scope;
+    AssertRecord* sampleSlot;
+    bool quiet;
+};
+
+inline BulkState& threadBulkState() {
+#if ENHANCED_UNITY_THREAD_SAFE
+    static thread_local BulkState state = { nullptr, nullptr, false };
+#else
+    static BulkState state = { nullptr, nullptr, false };
+#endif
+    return state;
+}
+
+// Claim the next slot; returns nullptr when the record has to be dropped.
+// Callers hold the buffer's lock.
+ENHANCED_UNITY_COLD inline AssertRecord* reserveRecord(RecordBuffer& buffer, uint8_t kind, bool passed, int line, const char* fileName) {
+    BulkState& bulk = threadBulkState();
+    AssertRecord* record = bulk.sampleSlot;
+    if (record != nullptr) {
+        bulk.sampleSlot = nullptr;
+    } else {
+        if (buffer.count >= ENHANCED_UNITY_RECORD_CAPACITY) {
+            buffer.overflowCount++;
+#if ENHANCED_UNITY_RECORD_FLUSH_ON_FULL
+            renderRecords(buffer);
+#else
+            return nullptr;
+#endif
+        }
+        record = &buffer.records[buffer.count++];
+    }
+    record->kind = kind;
+    record->passed = passed ? 1 : 0;
+    record->fileId = fileName != nullptr ? internFile(fileName) : counters().methodFileId;
+    record->format = assertKindFormat(kind);
+    record->flags = 0;
+    record->line = (uint16_t)line;
+    return record;
+}
+
+ENHANCED_UNITY_COLD inline void recordInt(uint8_t kind, bool passed, int line, const char* fileName,
+                      int64_t expected, int64_t actual, int32_t extra = 0) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record != nullptr) {
+        record->value.i.expected = expected;
+        record->value.i.actual = actual;
+        record->value.i.extra = extra;
+    }
+}
+
+ENHANCED_UNITY_COLD inline void recordFloat(uint8_t kind, bool passed, int line, const char* fileName,
+                        double expected, double delta, double actual, uint8_t flags = 0) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record != nullptr) {
+        record->flags = flags;
+        record->value.f.expected = expected;
+        record->value.f.delta = delta;
+        record->value.f.actual = actual;
+    }
+}
+
+ENHANCED_UNITY_COLD inline void recordValidation(uint8_t kind, bool passed, int line, const char* fileName,
+                             const char* operation, int32_t expected, int32_t actual) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record != nullptr) {
+        copyRecordString(record->value.v.operation, operation);
+        record->value.v.expected = expected;
+        record->value.v.actual = actual;
+    }
+}
+
+} // namespace enhanced_unity
+
+// ============================================================================
+// TYPED COMPARISON ENGINE
+// ============================================================================
+// Every assertion macro is a thin wrapper around compare<Op>() and friends.
+// The comparison itself is resolved at compile time per operand type and
+// operator: two values of one type are compared natively; mixed integer types
+// are widened to 64 bits and compared sign-correctly (-1 < 0u); anything
+// involving a float or double is compared in double. Enums compare as their
+// underlying type. Only the inline hot path sits at the call site; writing
+// the record is one shared out-of-line function per record shape.
+// ============================================================================
+
+namespace enhanced_unity {
+
+enum CompareOp : uint8_t {
+    OP_EQUAL,
+    OP_NOT_EQUAL,
+    OP_GREATER,        // actual >  expected
+    OP_LESS,           // actual <  expected
+    OP_GREATER_EQUAL,  // actual >= expected
+    OP_LESS_EQUAL      // actual <= expected
+};
+
+enum ValueCategory : uint8_t {
+    CATEGORY_SIGNED,
+    CATEGORY_UNSIGNED,
+    CATEGORY_FLOAT,
+    CATEGORY_DOUBLE,
+    CATEGORY_BOOL,
+    CATEGORY_POINTER
+};
+
+// An operand widened for recording
+struct ScalarValue {
+    uint8_t category;
+    union {
+        int64_t s;
+        uint64_t u;
+        double r;
+        const void* p;
+    } v;
+};
+
+inline ScalarValue signedScalar(int64_t value) { ScalarValue r; r.category = CATEGORY_SIGNED; r.v.s = value; return r; }
+inline ScalarValue unsignedScalar(uint64_t value) { ScalarValue r; r.category = CATEGORY_UNSIGNED; r.v.u = value; return r; }
+inline ScalarValue realScalar(double value, uint8_t category) { ScalarValue r; r.category = category; r.v.r = value; return r; }
+inline ScalarValue boolScalar(bool value) { ScalarValue r; r.category = CATEGORY_BOOL; r.v.u = value ? 1 : 0; return r; }
+inline ScalarValue pointerScalar(const void* value) { ScalarValue r; r.category = CATEGORY_POINTER; r.v.p = value; return r; }
+
+// widen(): the operand as int64_t, uint64_t, double, bool or const void*,
+// which also selects the mixed-type comparison overload below.
+// No <type_traits> on AVR, hence the explicit list and the compiler builtins.
+template <typename T, bool IsEnum = __is_enum(T)>
+struct ValueTraits;
+
+#define ENHANCED_UNITY_VALUE_TRAITS(type, wideType, makeScalar) \
+    template <> struct ValueTraits<type, false> { \
+        typedef wideType Wide; \
+        static Wide widen(type value) { return (Wide)value; } \
+        static ScalarValue scalar(type value) { (void)value; return makeScalar; } \
+    };
+
+ENHANCED_UNITY_VALUE_TRAITS(bool, bool, boolScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(char, int64_t, signedScalar((int64_t)value))
+ENHANCED_UNITY_VALUE_TRAITS(signed char, int64_t, signedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(short, int64_t, signedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(int, int64_t, signedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(long, int64_t, signedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(long long, int64_t, signedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(unsigned char, uint64_t, unsignedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(unsigned short, uint64_t, unsignedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(unsigned int, uint64_t, unsignedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(unsigned long, uint64_t, unsignedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(unsigned long long, uint64_t, unsignedScalar(value))
+ENHANCED_UNITY_VALUE_TRAITS(float, double, realScalar(value, CATEGORY_FLOAT))
+ENHANCED_UNITY_VALUE_TRAITS(double, double, realScalar(value, CATEGORY_DOUBLE))
+ENHANCED_UNITY_VALUE_TRAITS(long double, double, realScalar((double)value, CATEGORY_DOUBLE))
+ENHANCED_UNITY_VALUE_TRAITS(decltype(nullptr), const void*, pointerScalar(nullptr))
+
+#undef ENHANCED_UNITY_VALUE_TRAITS
+
+template <typename T>
+struct ValueTraits<T*, false> {
+    typedef const void* Wide;
+    static Wide widen(T* value) { return (const void*)value; }
+    static ScalarValue scalar(T* value) { return pointerScalar((const void*)value); }
+};
+
+template <typename T>
+struct ValueTraits<T, true> {
+    typedef ValueTraits<__underlying_type(T)> Underlying;
+    typedef typename Underlying::Wide Wide;
+    static Wide widen(T value) { return Underlying::widen((__underlying_type(T))value); }
+    static ScalarValue scalar(T value) { return Underlying::scalar((__underlying_type(T))value); }
+};
+
+// Same type on both sides: the native comparison, nothing widened
+template <CompareOp Op, typename T>
+inline bool holds(const T& expected, const T& actual) {
+    return Op == OP_EQUAL ? actual == expected
+         : Op == OP_NOT_EQUAL ? actual != expected
+         : Op == OP_GREATER ? actual > expected
+         : Op == OP_LESS ? actual < expected
+         : Op == OP_GREATER_EQUAL ? actual >= expected
+         : actual <= expected;
+}
+
+// Sign-correct ordering of actual relative to expected: -1, 0 or 1
+inline int orderOf(int64_t expected, int64_t actual) { return actual < expected ? -1 : (actual > expected ? 1 : 0); }
+inline int orderOf(uint64_t expected, uint64_t actual) { return actual < expected ? -1 : (actual > expected ? 1 : 0); }
+inline int orderOf(int64_t expected, uint64_t actual) { return expected < 0 ? 1 : orderOf((uint64_t)expected, actual); }
+inline int orderOf(uint64_t expected, int64_t actual) { return actual < 0 ? -1 : orderOf(expected, (uint64_t)actual); }
+inline int orderOf(bool expected, bool actual) { return orderOf((uint64_t)expected, (uint64_t)actual); }
+inline int orderOf(bool expected, int64_t actual) { return orderOf((uint64_t)expected, actual); }
+inline int orderOf(int64_t expected, bool actual) { return orderOf(expected, (uint64_t)actual); }
+inline int orderOf(bool expected, uint64_t actual) { return orderOf((uint64_t)expected, actual); }
+inline int orderOf(uint64_t expected, bool actual) { return orderOf(expected, (uint64_t)actual); }
+inline int orderOf(const void* expected, const void* actual) {
+    return orderOf((uint64_t)(uintptr_t)expected, (uint64_t)(uintptr_t)actual);
+}
+
+template <CompareOp Op>
+inline bool holdsWide(double expected, double actual) { return holds<Op>(expected, actual); }
+
+template <CompareOp Op, typename Wide>
+inline bool holdsWide(double expected, Wide actual) { return holds<Op>(expected, (double)actual); }
+
+template <CompareOp Op, typename Wide>
+inline bool holdsWide(Wide expected, double actual) { return holds<Op>((double)expected, actual); }
+
+template <CompareOp Op, typename WideExpected, typename WideActual>
+inline bool holdsWide(WideExpected expected, WideActual actual) { return holds<Op>(0, orderOf(expected, actual)); }
+
+// Different types: widen, then compare sign-correctly (or in double)
+template <CompareOp Op, typename E, typename A>
+inline bool holds(const E& expected, const A& actual) {
+    return holdsWide<Op>(ValueTraits<E>::widen(expected), ValueTraits<A>::widen(actual));
+}
+
+// Write the record of a scalar comparison, choosing the format from the
+// operand categories when the kind leaves it open (FORMAT_SCALAR)
+ENHANCED_UNITY_COLD inline void recordScalars(uint8_t kind, bool passed, int line, const char* fileName,
+                          ScalarValue expected, ScalarValue actual, int32_t extra) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record == nullptr) {
+        return;
+    }
+    bool expectedReal = expected.category == CATEGORY_FLOAT || expected.category == CATEGORY_DOUBLE;
+    bool actualReal = actual.category == CATEGORY_FLOAT || actual.category == CATEGORY_DOUBLE;
+    if (record->format == FORMAT_SCALAR) {
+        if (expectedReal || actualReal) {
+            record->format = FORMAT_REAL;
+        } else if (actual.category == CATEGORY_POINTER) {
+            record->format = FORMAT_POINTER;
+        } else {
+            record->format = FORMAT_INT;
+        }
+    }
+    switch (record->format) {
+    case FORMAT_REAL:
+    case FORMAT_FLOAT:
+        record->value.f.expected = expectedReal ? expected.v.r
+                                 : expected.category == CATEGORY_SIGNED ? (double)expected.v.s : (double)expected.v.u;
+        record->value.f.actual = actualReal ? actual.v.r
+                               : actual.category == CATEGORY_SIGNED ? (double)actual.v.s : (double)actual.v.u;
+        record->value.f.delta = 0;
+        if (expected.category == CATEGORY_DOUBLE || actual.category == CATEGORY_DOUBLE) {
+            record->flags |= RECORD_DOUBLE_PRECISION;
+        }
+        break;
+    case FORMAT_POINTER:
+        record->value.pointer = actual.v.p;
+        break;
+    default:
+        record->value.i.expected = expected.v.s;
+        record->value.i.actual = actual.v.s;
+        record->value.i.extra = extra;
+        if (expected.category != CATEGORY_SIGNED) {
+            record->flags |= RECORD_EXPECTED_UNSIGNED;
+        }
+        if (actual.category != CATEGORY_SIGNED) {
+            record->flags |= RECORD_ACTUAL_UNSIGNED;
+        }
+        break;
+    }
+}
+
+inline bool admitBulkFailure(BulkScope& scope);
+
+// Failure side of countOutcome(); inside a bulk scope the scope decides
+// whether the failure is reported
+ENHANCED_UNITY_COLD inline bool countFailedAssertion() {
+    countAssertionFailure();
+    const BulkState& bulk = threadBulkState();
+    if (bulk.quiet) {
+        return false;
+    }
+    if (bulk.scope != nullptr) {
+        return admitBulkFailure(*bulk.scope);
+    }
+    return recordsFailures();
+}
+
+// Count one assertion; true if its record should be written
+inline bool countOutcome(bool passed, bool recordPasses) {
+    countAssertion();
+    if (ENHANCED_UNITY_LIKELY(passed)) {
+        return recordPasses && threadBulkState().scope == nullptr && !threadBulkState().quiet;
+    }
+    return countFailedAssertion();
+}
+
+// `actual Op expected`, counted and recorded under `kind`
+template <CompareOp Op, typename E, typename A>
+inline void compare(uint8_t kind, const E& expected, const A& actual, int line, const char* fileName,
+                    bool recordPasses, int32_t extra = 0) {
+    bool passed = holds<Op>(expected, actual);
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses))) {
+        recordScalars(kind, passed, line, fileName, ValueTraits<E>::scalar(expected),
+                      ValueTraits<A>::scalar(actual), extra);
+    }
+}
+
+// |actual - expected| <= delta, in T
+template <typename T>
+inline void compareWithin(uint8_t kind, T delta, T expected, T actual, int line, const char* fileName,
+                          bool recordPasses) {
+    T difference = actual > expected ? actual - expected : expected - actual;
+    bool passed = !(difference > delta);
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses))) {
+        recordFloat(kind, passed, line, fileName, expected, delta, actual,
+                    sizeof(T) > sizeof(float) ? RECORD_DOUBLE_PRECISION : 0);
+    }
+}
+
+template <typename T>
+inline void compareValidation(uint8_t kind, const T& expected, const T& actual, const char* operation,
+                              int line, const char* fileName, bool recordPasses) {
+    bool passed = expected == actual;
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses))) {
+        recordValidation(kind, passed, line, fileName, operation, (int32_t)expected, (int32_t)actual);
+    }
+}
+
+} // namespace enhanced_unity
+
+#include "enhanced_unity_arrays.hpp"
+#include "enhanced_unity_text.hpp"
+#include "enhanced_unity_bulk.hpp"
+#include "enhanced_unity_property.hpp"
+
+// ============================================================================
+// TEST BOUNDARIES
+// ============================================================================
+
+namespace enhanced_unity {
+
+inline void initCounters() {
+    counters().reset();
+    {
+        RecordBuffer& buffer = counters().recordBuffer();
+        SpinLockGuard guard(buffer.lock);
+        buffer.count = 0;
+        buffer.overflowCount = 0;
+    }
+#if ENHANCED_UNITY_WIRE_PROTOCOL
+    startWireProtocol();
+#endif
+}
+
+inline void startMethodCounters(const char* methodName, const char* fileName = nullptr) {
+    CounterContext& c = counters();
+    c.methodName = methodName;
+    c.methodFileId = internFile(fileName);
+    c.methodCount++;
+    c.methodTotalCount++;
+    c.methodFileCount++;
+    c.assertionCount = 0;
+    c.assertionFailureCount = 0;
+    // The thread's shard is created on first use; do it now, ahead of the
+    // heap baseline, so the first method on a thread is not charged for it
+    localShard();
+    c.methodAssertionBase = c.rawAssertions();
+    c.methodFailureBase = c.rawAssertionFailures();
+    notifyMethodStart(methodName);
+    if (ENHANCED_UNITY_MEMORY) {
+        resetHeapPeak();
+        paintStack();
+        c.heapStartUsed = heapUsedBytes();
+        c.heapStartPeak = heapPeakBytes();
+    }
+#if ENHANCED_UNITY_RUSAGE
+    c.resourceStart = sampleResources();
+#endif
+    if (ENHANCED_UNITY_TIMING) {
+        c.methodStartMicros = nowMicros();
+    }
+}
+
+// Heap peak of the running method above its start
+inline int32_t methodHeapPeak(const CounterContext& c, int32_t heapUsed) {
+    int32_t peak = heapPeakBytes();
+    int32_t delta = heapUsed - c.heapStartUsed;
+    if (peak > c.heapStartPeak) {
+        return peak - c.heapStartUsed;
+    }
+    return delta > 0 ? delta : 0;
+}
+
+// Called first thing at the end of a method, so rendering is neither timed
+// nor charged to the method's memory
+inline void stopMethodMeasurements() {
+    CounterContext& c = counters();
+    if (ENHANCED_UNITY_TIMING) {
+        c.methodMicros = nowMicros() - c.methodStartMicros;
+    }
+    if (ENHANCED_UNITY_MEMORY) {
+        int32_t heapUsed = heapUsedBytes();
+        c.methodMemory.name = c.methodName != nullptr ? c.methodName : ENHANCED_UNITY_FLASH("<unknown>");
+        c.methodMemory.heapDelta = heapUsed - c.heapStartUsed;
+        c.methodMemory.heapPeak = methodHeapPeak(c, heapUsed);
+        c.methodMemory.stackFree = stackFreeBytes();
+    }
+#if ENHANCED_UNITY_RUSAGE
+    c.methodResources = resourcesSince(c.resourceStart);
+    c.methodResources.name = c.methodName != nullptr ? c.methodName : ENHANCED_UNITY_FLASH("<unknown>");
+#endif
+}
+
+// Resource use of the running method so far; zero where not measured
+inline MethodResources methodResourcesSoFar() {
+#if ENHANCED_UNITY_RUSAGE
+    return resourcesSince(counters().resourceStart);
+#else
+    MethodResources none = {};
+    return none;
+#endif
+}
+
+inline void foldMethodMeasurements() {
+    CounterContext& c = counters();
+    if (ENHANCED_UNITY_TIMING) {
+        c.methodTotalMicros += c.methodMicros;
+        MethodTiming timing = { c.methodName != nullptr ? c.methodName : ENHANCED_UNITY_FLASH("<unknown>"), c.methodMicros };
+        c.slowestMethods.add(timing);
+    }
+    if (ENHANCED_UNITY_MEMORY) {
+        c.hungriestMethods.add(c.methodMemory);
+    }
+#if ENHANCED_UNITY_RUSAGE
+    c.busiestMethods.add(c.methodResources);
+#endif
+}
+
+// Sum the shards into the current method's assertion counts
+inline void resolveMethodCounters() {
+    CounterContext& c = counters();
+    c.assertionCount = c.rawAssertions() - c.methodAssertionBase;
+    c.assertionFailureCount = c.rawAssertionFailures() - c.methodFailureBase;
+}
+
+// Fold the finished method into the file totals; true if it failed
+inline bool endMethodCounters() {
+    resolveMethodCounters();
+    CounterContext& c = counters();
+    bool failed = c.assertionFailureCount > 0;
+    if (failed) {
+        c.methodFailureCount++;
+        c.methodTotalFailureCount++;
+        c.methodFileFailureCount++;
+    }
+    c.assertionFileCount += c.assertionCount;
+    c.assertionFileFailureCount += c.assertionFailureCount;
+    foldMethodMeasurements();
+    return failed;
+}
+
+// " [heap +12 B peak 96 B | stack 1400 B free]", no newline
+inline void reportMethodMemory(const MethodMemory& memory) {
+    ENHANCED_UNITY_PRINT(" [heap %+ld B peak %ld B", (long)memory.heapDelta, (long)memory.heapPeak);
+    if (memory.stackFree != ENHANCED_UNITY_STACK_UNKNOWN) {
+        ENHANCED_UNITY_PRINT(" | stack %ld B free", (long)memory.stackFree);
+    }
+    ENHANCED_UNITY_PRINT("]");
+}
+
+#if ENHANCED_UNITY_RUSAGE
+// " [cpu 1.234 ms user 1.000 sys 0.234 | flt 12+0 | csw 3+1 | rss +0 kB]", no newline
+inline void reportMethodResources(const MethodResources& resources) {
+    const int32_t* v = resources.values;
+    ENHANCED_UNITY_PRINT(" [cpu %ld.%03ld ms user %ld.%03ld sys %ld.%03ld | flt %ld+%ld | csw %ld+%ld | rss +%ld kB]",
+                         (long)(v[RESOURCE_CPU] / 1000), (long)(v[RESOURCE_CPU] % 1000),
+                         (long)(v[RESOURCE_USER] / 1000), (long)(v[RESOURCE_USER] % 1000),
+                         (long)(v[RESOURCE_SYSTEM] / 1000), (long)(v[RESOURCE_SYSTEM] % 1000),
+                         (long)v[RESOURCE_MINOR_FAULTS], (long)v[RESOURCE_MAJOR_FAULTS],
+                         (long)v[RESOURCE_VOLUNTARY], (long)v[RESOURCE_INVOLUNTARY], (long)v[RESOURCE_RSS_GROWTH]);
+}
+#endif
+
+inline void reportMethodResult() {
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+        const CounterContext& c = counters();
+        ENHANCED_UNITY_PRINT("[%" ENHANCED_UNITY_FLASH_S "]     - assertions [tot %5d | pass %5d | fail %5d]",
+               statusText(c.assertionFailureCount == 0),
+               c.assertionCount,
+               c.assertionCount - c.assertionFailureCount,
+               c.assertionFailureCount);
+        if (ENHANCED_UNITY_TIMING) {
+            ENHANCED_UNITY_PRINT(" [%6lu.%03lu ms]", wholeMillis(c.methodMicros), fractionMillis(c.methodMicros));
+        }
+        if (ENHANCED_UNITY_MEMORY) {
+            reportMethodMemory(c.methodMemory);
+        }
+#if ENHANCED_UNITY_RUSAGE
+        reportMethodResources(c.methodResources);
+#endif
+        ENHANCED_UNITY_PRINT("\n");
+    }
+    notifyMethodResult(nullptr);
+}
+
+inline void startFileCounters() {
+    CounterContext& c = counters();
+    c.methodCount = 0;
+    c.methodFailureCount = 0;
+    c.methodFileCount = 0;
+    c.methodFileFailureCount = 0;
+    c.assertionFileCount = 0;
+    c.assertionFileFailureCount = 0;
+    c.testCount++;
+    if (ENHANCED_UNITY_TIMING) {
+        c.fileStartMicros = nowMicros();
+    }
+}
+
+inline void reportFileStart(const char* suiteName, const char* fileName) {
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+        ENHANCED_UNITY_PRINT("\n");
+        ENHANCED_UNITY_PRINT("=======================================================\n");
+        ENHANCED_UNITY_PRINT("--- Running Test Suite: %s ---\n", suiteName);
+        ENHANCED_UNITY_PRINT("---         Test File:  %s ---\n", fileName);
+        ENHANCED_UNITY_PRINT("=======================================================\n");
+    }
+    notifyFileStart(suiteName, fileName);
+}
+
+inline void endFileCounters() {
+    CounterContext& c = counters();
+    if (c.methodFailureCount > 0) {
+        c.testFailureCount++;
+    }
+    if (ENHANCED_UNITY_TIMING) {
+        c.fileMicros = nowMicros() - c.fileStartMicros;
+    }
+}
+
+inline void reportFileResult(const char* suiteName, const char* fileName) {
+    const CounterContext& c = counters();
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+        ENHANCED_UNITY_PRINT("=======================================================\n");
+        ENHANCED_UNITY_PRINT("--- Completed Test Suite: %s ---\n", suiteName);
+        ENHANCED_UNITY_PRINT("=======================================================\n");
+    }
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_FILES) {
+        ENHANCED_UNITY_PRINT("[%" ENHANCED_UNITY_FLASH_S "] - %-20s - %s \n",
+               statusText(c.methodFailureCount == 0),
+               suiteName,
+               fileName);
+        ENHANCED_UNITY_PRINT("              - assertions [tot %5d | pass %5d | fail %5d]\n",
+               c.assertionFileCount,
+               c.assertionFileCount - c.assertionFileFailureCount,
+               c.assertionFileFailureCount);
+        ENHANCED_UNITY_PRINT("              - methods    [tot %5d | pass %5d | fail %5d]\n",
+               c.methodFileCount,
+               c.methodFileCount - c.methodFileFailureCount,
+               c.methodFileFailureCount);
+        if (ENHANCED_UNITY_TIMING) {
+            ENHANCED_UNITY_PRINT("              - time       [%6lu.%03lu ms]\n",
+                   wholeMillis(c.fileMicros), fractionMillis(c.fileMicros));
+        }
+    }
+    if (reporterCount() > 0) {
+        FileEvent event = { suiteName, fileName, c.methodFileCount, c.methodFileFailureCount,
+                            c.assertionFileCount, c.assertionFileFailureCount, c.fileMicros };
+        notifyFileEnd(event);
+    }
+}
+
+inline void reportSlowestMethods() {
+    if (!ENHANCED_UNITY_TIMING) {
+        return;
+    }
+    SlowestMethods slowest = counters().slowestMethods;
+    if (slowest.count == 0) {
+        return;
+    }
+    slowest.sortDescending();
+    ENHANCED_UNITY_PRINT("=== Slowest test methods\n");
+    for (int i = 0; i < slowest.count; i++) {
+        ENHANCED_UNITY_PRINT("  %2d. [%6lu.%03lu ms] %" ENHANCED_UNITY_FLASH_S "\n", i + 1,
+               wholeMillis(slowest.entries[i].duration), fractionMillis(slowest.entries[i].duration),
+               slowest.entries[i].name);
+    }
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+}
+
+inline void reportHungriestMethods() {
+    if (!ENHANCED_UNITY_MEMORY) {
+        return;
+    }
+    HungriestMethods hungriest = counters().hungriestMethods;
+    if (hungriest.count == 0) {
+        return;
+    }
+    hungriest.sortDescending();
+    ENHANCED_UNITY_PRINT("=== Heap peak by test method\n");
+    for (int i = 0; i < hungriest.count; i++) {
+        ENHANCED_UNITY_PRINT("  %2d.", i + 1);
+        reportMethodMemory(hungriest.entries[i]);
+        ENHANCED_UNITY_PRINT(" %" ENHANCED_UNITY_FLASH_S "\n", hungriest.entries[i].name);
+    }
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+}
 
-// Use original Unity macros - these will terminate tests on failure
-#define TEST_ASSERT_TRUE_DEBUG(condition) TEST_ASSERT_TRUE(condition)
+// Top ENHANCED_UNITY_RUSAGE_METHODS methods by the sort column
+inline void reportBusiestMethods() {
+#if ENHANCED_UNITY_RUSAGE
+    BusiestMethods busiest = counters().busiestMethods;
+    if (busiest.count == 0) {
+        return;
+    }
+    busiest.sortDescending();
+    ENHANCED_UNITY_PRINT("=== Resource use by test method (sorted by %s)\n", resourceColumnName(resourceSortColumn()));
+    for (int i = 0; i < busiest.count; i++) {
+        ENHANCED_UNITY_PRINT("  %2d.", i + 1);
+        reportMethodResources(busiest.entries[i]);
+        ENHANCED_UNITY_PRINT(" %" ENHANCED_UNITY_FLASH_S "\n", busiest.entries[i].name);
+    }
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+#endif
+}
 
-// Use standard Unity RUN_TEST macro when using baseline Unity
-#define RUN_TEST_DEBUG(testFunction) RUN_TEST(testFunction)
-#define TEST_ASSERT_FALSE_DEBUG(condition) TEST_ASSERT_FALSE(condition)
-#define TEST_ASSERT_EQUAL_INT_DEBUG(expected, actual) TEST_ASSERT_EQUAL_INT(expected, actual)
-#define TEST_ASSERT_EQUAL_UINT32_DEBUG(expected, actual) TEST_ASSERT_EQUAL_UINT32(expected, actual)
-#define TEST_ASSERT_EQUAL_UINT8_DEBUG(expected, actual) TEST_ASSERT_EQUAL_UINT8(expected, actual)
-#define TEST_ASSERT_NOT_EQUAL_DEBUG(expected, actual) TEST_ASSERT_NOT_EQUAL(expected, actual)
-#define TEST_ASSERT_GREATER_THAN_DEBUG(expected, actual) TEST_ASSERT_GREATER_THAN(expected, actual)
-#define TEST_ASSERT_GREATER_THAN_UINT32_DEBUG(expected, actual) TEST_ASSERT_GREATER_THAN_UINT32(expected, actual)
-#define TEST_ASSERT_LESS_THAN_DEBUG(expected, actual) TEST_ASSERT_LESS_THAN(expected, actual)
-#define TEST_ASSERT_NULL_DEBUG(pointer) TEST_ASSERT_NULL(pointer)
-#define TEST_ASSERT_NOT_NULL_DEBUG(pointer) TEST_ASSERT_NOT_NULL(pointer)
-#define TEST_ASSERT_EQUAL_STRING_DEBUG(expected, actual) TEST_ASSERT_EQUAL_STRING(expected, actual)
-#define TEST_ASSERT_FLOAT_WITHIN_DEBUG(delta, expected, actual) TEST_ASSERT_FLOAT_WITHIN(delta, expected, actual)
+} // namespace enhanced_unity
 
-// ============================================================================
-// ENHANCED UNITY MACROS (non-terminating, with failure counting)
-// ============================================================================
-#define ENHANCED_UNITY_INIT()
-#define ENHANCED_UNITY_GET_FAILURES()
-#define ENHANCED_UNITY_RESET()
-#define ENHANCED_UNITY_FINAL_REPORT()
-#define ENHANCED_UNITY_ASSERT_NO_FAILURES()
-#define ENHANCED_UNITY_START_TEST_METHOD(methodName, fileName, lineNumber)
-#define ENHANCED_UNITY_END_TEST_METHOD()
+#include "enhanced_unity_watchdog.hpp"
 
-#else
+namespace enhanced_unity {
 
-#define ENHANCED_UNITY_FINAL_SUMMARY() do { \
-    printf("=======================================================\n"); \
-    printf("=== Summary of test files\n"); \
-    printf("=======================================================\n"); \
-    printf("[%s]     - files      [tot %5d | pass %5d | fail %5d]\n", \
-               _enhancedUnityTestFailureCount == 0 ? "PASSED" : "FAILED", \
-               _enhancedUnityTestCount, \
-               _enhancedUnityTestCount - _enhancedUnityTestFailureCount, \
-               _enhancedUnityTestFailureCount \
-            ); \
-    printf("[%s]     - assertions [tot %5d | pass %5d | fail %5d]\n", \
-               _enhancedUnityAssertionTotalFailureCount == 0 ? "PASSED" : "FAILED", \
-               _enhancedUnityAssertionTotalCount, \
-               _enhancedUnityAssertionTotalCount - _enhancedUnityAssertionTotalFailureCount, \
-               _enhancedUnityAssertionTotalFailureCount \
-            ); \
-    printf("[%s]     - methods    [tot %5d | pass %5d | fail %5d]\n", \
-               _enhancedUnityMethodTotalFailureCount == 0 ? "PASSED" : "FAILED", \
-               _enhancedUnityMethodTotalCount, \
-               _enhancedUnityMethodTotalCount - _enhancedUnityMethodTotalFailureCount, \
-               _enhancedUnityMethodTotalFailureCount \
-            ); \
-    printf("=======================================================\n"); \
-} while(0)
+#ifdef CONFIGMGR_NATIVE
+// Slice of the suite this process runs: tests whose name hashes to `index`
+// modulo `count`; count 0 = the whole suite
+struct ShardSpec {
+    int index = 0;
+    int count = 0;
+};
 
-// Global flag to prevent multiple Serial initializations
-extern bool _serialInitialized;
+// "I/N" with 0 <= I < N
+inline bool parseShard(const char* text, ShardSpec& spec) {
+    char* end = nullptr;
+    long index = strtol(text, &end, 10);
+    if (end == text || *end != '/' || index < 0) {
+        return false;
+    }
+    const char* countText = end + 1;
+    long count = strtol(countText, &end, 10);
+    if (end == countText || *end != '\0' || count < 1 || index >= count || count > 1000000) {
+        return false;
+    }
+    spec.index = (int)index;
+    spec.count = (int)count;
+    return true;
+}
 
-// Safe Serial initialization macro
-#define ENHANCED_UNITY_INIT_SERIAL() do { \
-    if (!_serialInitialized) { \
-        Serial.begin(115200); \
-        while(!Serial) { \
-            delay(100); \
-        } \
-        Serial.flush(); \
-        _serialInitialized = true; \
-    } \
-} while(0)
+// Set from ENHANCED_UNITY_SHARD on first use, so hand-written runners shard
+// without code changes; ENHANCED_UNITY_MAIN() --shard=I/N overrides it
+inline ShardSpec& shardSpec() {
+    static ShardSpec spec = []() {
+        ShardSpec fromEnvironment;
+        const char* text = getenv("ENHANCED_UNITY_SHARD");
+        if (text != nullptr && *text != '\0' && !parseShard(text, fromEnvironment)) {
+            print("ignoring ENHANCED_UNITY_SHARD=%s (expected INDEX/COUNT)\n", text);
+        }
+        return fromEnvironment;
+    }();
+    return spec;
+}
+
+// FNV-1a (64-bit), identical on every host; pass the previous result as
+// `hash` to chain strings
+inline uint64_t stableHash(const char* text, uint64_t hash = 0xcbf29ce484222325ULL) {
+    for (; text != nullptr && *text != '\0'; text++) {
+        hash = (hash ^ (uint8_t)*text) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Tests are assigned by name alone, so every runner path agrees
+inline bool inShard(const char* testName) {
+    const ShardSpec& spec = shardSpec();
+    return spec.count <= 1 || stableHash(testName) % (uint64_t)spec.count == (uint64_t)spec.index;
+}
+#endif
+
+inline void reportFinalSummary() {
+    const CounterContext& c = counters();
+    int assertions = c.totalAssertions();
+    int assertionFailures = c.totalAssertionFailures();
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+    ENHANCED_UNITY_PRINT("=== Summary of test files\n");
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+    ENHANCED_UNITY_PRINT("[%" ENHANCED_UNITY_FLASH_S "]     - files      [tot %5d | pass %5d | fail %5d]\n",
+           statusText(c.testFailureCount == 0),
+           c.testCount,
+           c.testCount - c.testFailureCount,
+           c.testFailureCount);
+    ENHANCED_UNITY_PRINT("[%" ENHANCED_UNITY_FLASH_S "]     - assertions [tot %5d | pass %5d | fail %5d]\n",
+           statusText(assertionFailures == 0),
+           assertions,
+           assertions - assertionFailures,
+           assertionFailures);
+    ENHANCED_UNITY_PRINT("[%" ENHANCED_UNITY_FLASH_S "]     - methods    [tot %5d | pass %5d | fail %5d]\n",
+           statusText(c.methodTotalFailureCount == 0),
+           c.methodTotalCount,
+           c.methodTotalCount - c.methodTotalFailureCount,
+           c.methodTotalFailureCount);
+#ifdef CONFIGMGR_NATIVE
+    if (c.methodCachedCount > 0) {
+        ENHANCED_UNITY_PRINT("             - cache      [executed %5d | cached %5d]\n",
+               c.methodTotalCount, c.methodCachedCount);
+    }
+    if (shardSpec().count > 0) {
+        ENHANCED_UNITY_PRINT("             - shard      [%d/%d]\n", shardSpec().index, shardSpec().count);
+    }
+    if (c.historyFailureCount > 0) {
+        ENHANCED_UNITY_PRINT("[%" ENHANCED_UNITY_FLASH_S "]     - history    [slower %5d]\n",
+               statusText(false), c.historyFailureCount);
+    }
+#endif
+    if (ENHANCED_UNITY_TIMING) {
+        TimeMicros wall = nowMicros() - c.runStartMicros;
+        ENHANCED_UNITY_PRINT("             - time       [wall %lu.%03lu ms | methods %lu.%03lu ms]\n",
+               wholeMillis(wall), fractionMillis(wall),
+               wholeMillis(c.methodTotalMicros), fractionMillis(c.methodTotalMicros));
+    }
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+    reportSlowestMethods();
+    reportHungriestMethods();
+    reportBusiestMethods();
+    reportTimedOutMethods();
+#if ENHANCED_UNITY_TASK_WATCHDOG
+    watchdogRunFinished();
+#endif
+    if (reporterCount() > 0) {
+        RunEvent event = { c.testCount, c.testFailureCount, c.methodTotalCount, c.methodTotalFailureCount,
+                           assertions, assertionFailures,
+                           ENHANCED_UNITY_TIMING ? nowMicros() - c.runStartMicros : 0, 0, 0,
+                           c.historyFailureCount };
+#ifdef CONFIGMGR_NATIVE
+        event.shardIndex = shardSpec().index;
+        event.shardCount = shardSpec().count;
+#endif
+        notifyRunEnd(event);
+    }
+}
 
-// Global failure counter for non-terminating assertions
-extern int _enhancedUnityAssertionCount;
-extern int _enhancedUnityAssertionFailureCount;
-extern int _enhancedUnityAssertionFileCount;
-extern int _enhancedUnityAssertionFileFailureCount;
-
-extern int _enhancedUnityMethodCount;
-extern int _enhancedUnityMethodFailureCount;
-extern int _enhancedUnityMethodTotalCount;
-extern int _enhancedUnityMethodTotalFailureCount;
-extern int _enhancedUnityMethodFileCount;
-extern int _enhancedUnityMethodFileFailureCount;
-extern int _enhancedUnityAssertionTotalCount;
-extern int _enhancedUnityAssertionTotalFailureCount;
-
-extern int _enhancedUnityTestCount;
-extern int _enhancedUnityTestFailureCount;
-extern int _enhancedUnityFailureCount;
+} // namespace enhanced_unity
 
 // Initialize test tracking system
 #define ENHANCED_UNITY_INIT() do { \
-    _enhancedUnityAssertionCount = 0; \
-    _enhancedUnityAssertionFailureCount = 0; \
-    _enhancedUnityAssertionTotalCount = 0; \
-    _enhancedUnityAssertionTotalFailureCount = 0; \
-    _enhancedUnityAssertionFileCount = 0; \
-    _enhancedUnityAssertionFileFailureCount = 0; \
-    _enhancedUnityAssertionTotalFailureCount = 0; \
-    _enhancedUnityMethodCount = 0; \
-    _enhancedUnityMethodTotalCount = 0; \
-    _enhancedUnityMethodTotalFailureCount = 0; \
-    _enhancedUnityMethodFileCount = 0; \
-    _enhancedUnityMethodFileFailureCount = 0; \
-    _enhancedUnityMethodFailureCount = 0; \
-    _enhancedUnityTestCount = 0; \
-    _enhancedUnityTestFailureCount = 0; \
-    _enhancedUnityFailureCount = 0; \
+    ::enhanced_unity::initCounters(); \
 } while(0)
 
-// Start tracking a test method
+// Start tracking a test method; with ENHANCED_UNITY_PROGMEM, methodName and
+// fileName must be string literals (they are placed in flash)
 #define ENHANCED_UNITY_START_TEST_METHOD(methodName, fileName, lineNumber) do { \
+  const char* _methodName = ENHANCED_UNITY_FLASH(methodName); \
   if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) { \
-   printf("===== %s \n", (methodName)) ; \
+   ENHANCED_UNITY_PRINT("===== %" ENHANCED_UNITY_FLASH_S " \n", _methodName) ; \
+   ::enhanced_unity::flushOutput(); \
    } \
-   _enhancedUnityMethodCount++; \
-   _enhancedUnityMethodTotalCount++; \
-   _enhancedUnityMethodFileCount++; \
-   _enhancedUnityAssertionCount = 0; \
-   _enhancedUnityAssertionFailureCount = 0; \
+   ::enhanced_unity::startMethodCounters(_methodName, ENHANCED_UNITY_FLASH(fileName)); \
 } while(0)
 
 // End tracking a test method and record results
 #define ENHANCED_UNITY_END_TEST_METHOD() do { \
-    if (_enhancedUnityAssertionFailureCount > 0) { \
-        _enhancedUnityMethodFailureCount++; \
-        _enhancedUnityMethodTotalFailureCount++; \
-        _enhancedUnityMethodFileFailureCount++; \
-    } \
-    _enhancedUnityAssertionFileCount += _enhancedUnityAssertionCount; \
-    _enhancedUnityAssertionFileFailureCount += _enhancedUnityAssertionFailureCount; \
-    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) { \
-        printf("[%s]     - assertions [tot %5d | pass %5d | fail %5d]\n", \
-               _enhancedUnityAssertionFailureCount == 0 ? "PASSED" : "FAILED", \
-               _enhancedUnityAssertionCount, \
-               _enhancedUnityAssertionCount - _enhancedUnityAssertionFailureCount, \
-               _enhancedUnityAssertionFailureCount \
-            ); \
-    } \
+    ::enhanced_unity::stopMethodMeasurements(); \
+    ::enhanced_unity::flushRecords(); \
+    ::enhanced_unity::endMethodCounters(); \
+    ::enhanced_unity::reportMethodResult(); \
+    ::enhanced_unity::flushOutput(); \
 } while(0)
 
 // Start tracking a test file
 #define ENHANCED_UNITY_START_TEST_FILE(suiteName, fileName) do { \
-    _enhancedUnityMethodCount = 0; \
-    _enhancedUnityMethodFailureCount = 0; \
-    _enhancedUnityMethodFileCount = 0; \
-    _enhancedUnityMethodFileFailureCount = 0; \
-    _enhancedUnityAssertionFileCount = 0; \
-    _enhancedUnityAssertionFileFailureCount = 0; \
-    _enhancedUnityTestCount++; \
-    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) { \
-        printf("\n"); \
-        printf("=======================================================\n"); \
-        printf("--- Running Test Suite: %s ---\n", suiteName); \
-        printf("---         Test File:  %s ---\n", fileName); \
-        printf("=======================================================\n"); \
-    } \
+    ::enhanced_unity::startFileCounters(); \
+    ::enhanced_unity::reportFileStart((suiteName), (fileName)); \
 } while(0)
 
 // End tracking a test file and record results
 #define ENHANCED_UNITY_END_TEST_FILE(suiteName, fileName) do { \
-    if (_enhancedUnityMethodFailureCount > 0) { \
-        _enhancedUnityTestFailureCount++; \
-    } \
-    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) { \
-        printf("=======================================================\n"); \
-        printf("--- Completed Test Suite: %s ---\n", suiteName); \
-        printf("=======================================================\n"); \
-    } \
-    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_FILES) { \
-        printf("[%s] - %-20s - %s \n", \
-               _enhancedUnityMethodFailureCount == 0 ? "PASSED" : "FAILED", \
-               (suiteName), \
-               (fileName) \
-            ); \
-        printf("              - assertions [tot %5d | pass %5d | fail %5d]\n", \
-               _enhancedUnityAssertionFileCount, \
-               _enhancedUnityAssertionFileCount - _enhancedUnityAssertionFileFailureCount, \
-               _enhancedUnityAssertionFileFailureCount \
-            ); \
-        printf("              - methods    [tot %5d | pass %5d | fail %5d]\n", \
-               _enhancedUnityMethodFileCount, \
-               _enhancedUnityMethodFileCount - _enhancedUnityMethodFileFailureCount, \
-               _enhancedUnityMethodFileFailureCount \
-            ); \
-    } \
+    ENHANCED_UNITY_RUN_PENDING_TESTS(); \
+    ::enhanced_unity::flushRecords(); \
+    ::enhanced_unity::endFileCounters(); \
+    ::enhanced_unity::reportFileResult((suiteName), (fileName)); \
+    ::enhanced_unity::flushOutput(); \
 } while(0)
 
 // Get failure count for current test
-#define ENHANCED_UNITY_GET_FAILURES() _enhancedUnityFailureCount
+#define ENHANCED_UNITY_GET_FAILURES() (::enhanced_unity::counters().failureCount())
 
 // Reset failure counter
-#define ENHANCED_UNITY_RESET() do { _enhancedUnityFailureCount = 0; } while(0)
+#define ENHANCED_UNITY_RESET() do { ::enhanced_unity::counters().resetFailureCount(); } while(0)
+
+// File an assertion site passes to its record. PROGMEM builds pass none, so
+// the per-site __FILE__ literals never reach SRAM; the record takes the
+// running method's file instead.
+#if ENHANCED_UNITY_PROGMEM
+#define ENHANCED_UNITY_SITE_FILE nullptr
+#else
+#define ENHANCED_UNITY_SITE_FILE __FILE__
+#endif
+
+// Passing assertions are recorded only at VERBOSITY_ALL_ASSERTIONS in debug mode
+#define ENHANCED_UNITY_RECORD_PASSES \
+    (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && ::enhanced_unity::debugMode())
 
 // Enhanced: Shows the actual condition that failed, records failure but continues
-// Note: We still call Unity's assertion so it knows about the failure
 #define TEST_ASSERT_TRUE_DEBUG(condition) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        bool _result = (condition); \
-        if (!_result) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_TRUE(%s)\n", __LINE__, _result ? "true" : "false"); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] line %4d  TEST_ASSERT_TRUE(%s)\n", __LINE__, _result ? "true" : "false"); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL, bool, bool>(::enhanced_unity::ASSERT_TRUE, true, static_cast<bool>(condition), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows the actual condition that failed, records failure but continues
 #define TEST_ASSERT_FALSE_DEBUG(condition) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        bool _result = (condition); \
-        if (_result) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_FALSE(%s)\n", __LINE__, _result ? "true" : "false"); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] line %4d  TEST_ASSERT_FALSE(%s)\n", __LINE__, _result ? "true" : "false"); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL, bool, bool>(::enhanced_unity::ASSERT_FALSE, false, static_cast<bool>(condition), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values, records failure but continues
 #define TEST_ASSERT_EQUAL_INT_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        int _expected = (expected); \
-        int _actual = (actual); \
-        if (_expected != _actual) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_EQUAL_INT(%d, %d)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] line %4d  TEST_ASSERT_EQUAL_INT(%d, %d)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL, int, int>(::enhanced_unity::ASSERT_EQUAL_INT, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values for ALL tests, records failure but continues
 #define TEST_ASSERT_EQUAL_UINT32_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint32_t _expected = (expected); \
-        uint32_t _actual = (actual); \
-        if (_expected != _actual) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_EQUAL_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED]  line %4d  TEST_ASSERT_EQUAL_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL, uint32_t, uint32_t>(::enhanced_unity::ASSERT_EQUAL_UINT32, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values for ALL tests, records failure but continues
 #define TEST_ASSERT_EQUAL_UINT8_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint8_t _expected = (expected); \
-        uint8_t _actual = (actual); \
-        if (_expected != _actual) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_EQUAL_UINT8(%d, %d)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] line %4d  TEST_ASSERT_EQUAL_UINT8(%d, %d)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL, uint8_t, uint8_t>(::enhanced_unity::ASSERT_EQUAL_UINT8, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values, records failure but continues
 #define TEST_ASSERT_NOT_EQUAL_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        int _expected = (expected); \
-        int _actual = (actual); \
-        if (_expected == _actual) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] line %4d  TEST_ASSERT_NOT_EQUAL(%d, %d)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] line %4d  TEST_ASSERT_NOT_EQUAL(%d, %d)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_NOT_EQUAL>(::enhanced_unity::ASSERT_NOT_EQUAL, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values, records failure but continues
 #define TEST_ASSERT_GREATER_THAN_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        int _expected = (expected); \
-        int _actual = (actual); \
-        if (!(_actual > _expected)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_GREATER_THAN(%d, %d)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_GREATER_THAN(%d, %d)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_GREATER>(::enhanced_unity::ASSERT_GREATER_THAN, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values, records failure but continues
 #define TEST_ASSERT_GREATER_THAN_UINT32_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint32_t _expected = (expected); \
-        uint32_t _actual = (actual); \
-        if (!(_actual > _expected)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_GREATER_THAN_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_GREATER_THAN_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_GREATER, uint32_t, uint32_t>(::enhanced_unity::ASSERT_GREATER_THAN_UINT32, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: uint32 strictly less-than
 #define TEST_ASSERT_LESS_THAN_UINT32_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint32_t _expected = (expected); \
-        uint32_t _actual = (actual); \
-        if (!(_actual < _expected)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_LESS_THAN_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-            } \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_LESS_THAN_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS, uint32_t, uint32_t>(::enhanced_unity::ASSERT_LESS_THAN_UINT32, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: uint32 less-or-equal
 #define TEST_ASSERT_LE_UINT32_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint32_t _expected = (expected); \
-        uint32_t _actual = (actual); \
-        if (!(_actual <= _expected)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_LE_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-            } \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_LE_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, uint32_t, uint32_t>(::enhanced_unity::ASSERT_LE_UINT32, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows both expected and actual values, records failure but continues
 #define TEST_ASSERT_LESS_THAN_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        int _expected = (expected); \
-        int _actual = (actual); \
-        if (!(_actual < _expected)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_LESS_THAN(%d, %d)\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_LESS_THAN(%d, %d)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS>(::enhanced_unity::ASSERT_LESS_THAN, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows the actual pointer value, records failure but continues
 #define TEST_ASSERT_NULL_DEBUG(pointer) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        if ((pointer) != nullptr) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_NULL(%p)\n", __LINE__, (pointer)); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_NULL(%p)\n", __LINE__, (pointer)); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL, const void*, const void*>(::enhanced_unity::ASSERT_NULL, nullptr, (pointer), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows the actual pointer value, records failure but continues
 #define TEST_ASSERT_NOT_NULL_DEBUG(pointer) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        if ((pointer) == nullptr) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_NOT_NULL(%p)\n", __LINE__, (pointer)); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_NOT_NULL(%p)\n", __LINE__, (pointer)); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_NOT_EQUAL, const void*, const void*>(::enhanced_unity::ASSERT_NOT_NULL, nullptr, (pointer), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
-// Enhanced: Shows both expected and actual strings, records failure but continues
+// Enhanced: NULL-safe; a failure shows the first differing byte with its line
+// and column and a window of both strings, records failure but continues
 #define TEST_ASSERT_EQUAL_STRING_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        const char* _expected = (expected); \
-        const char* _actual = (actual); \
-        if (strcmp(_expected, _actual) != 0) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_EQUAL_STRING(\"%s\", \"%s\")\n", __LINE__, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_EQUAL_STRING(\"%s\", \"%s\")\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compareStrings(::enhanced_unity::ASSERT_EQUAL_STRING, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Strings compared up to their terminators, but never beyond `length` bytes
+#define TEST_ASSERT_EQUAL_STRING_LEN_DEBUG(expected, actual, length) \
+    do { \
+        ::enhanced_unity::compareStrings(::enhanced_unity::ASSERT_EQUAL_STRING_LEN, (expected), (actual), \
+            (size_t)(length), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Byte buffers of their own lengths (NUL is an ordinary byte); equal when the
+// lengths and every byte match. Reported like TEST_ASSERT_EQUAL_STRING_DEBUG.
+#define TEST_ASSERT_EQUAL_PAYLOAD_DEBUG(expected, expectedLength, actual, actualLength) \
+    do { \
+        ::enhanced_unity::compareTexts(::enhanced_unity::ASSERT_EQUAL_PAYLOAD, (expected), (size_t)(expectedLength), \
+            (actual), (size_t)(actualLength), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced: Shows all three values, records failure but continues
 #define TEST_ASSERT_FLOAT_WITHIN_DEBUG(delta, expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        float _delta = (delta); \
-        float _expected = (expected); \
-        float _actual = (actual); \
-        float _diff = (_actual > _expected) ? (_actual - _expected) : (_expected - _actual); \
-        if (_diff > _delta) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_FLOAT_WITHIN(%f, %f, %f)\n", __LINE__, _expected, _delta, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_FLOAT_WITHIN(%f, %f, %f)\n", __LINE__, _expected, _delta, _actual); \
-        } \
+        ::enhanced_unity::compareWithin<float>(::enhanced_unity::ASSERT_FLOAT_WITHIN, (delta), (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Custom assertion for scoreboard values that should increase, records failure but continues
 #define TEST_ASSERT_SCOREBOARD_INCREASED_DEBUG(initial, final, index) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint32_t _initial = (initial); \
-        uint32_t _final = (final); \
-        if (!(_final > _initial)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_SCOREBOARD_INCREASED(%d, 0x%08x, 0x%08x)\n", __LINE__, index, _initial, _final); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_SCOREBOARD_INCREASED(%d, 0x%08x, 0x%08x)\n", __LINE__, index, _initial, _final); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_GREATER, uint32_t, uint32_t>(::enhanced_unity::ASSERT_SCOREBOARD_INCREASED, (initial), (final), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES, (int32_t)(index)); \
     } while(0)
 
 // Custom assertion for validation results, records failure but continues
 #define TEST_ASSERT_VALIDATION_RESULT_DEBUG(expected, actual, operation) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        validationResult _expected = (expected); \
-        validationResult _actual = (actual); \
-        if (_expected != _actual) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_VALIDATION_RESULT(%s, %d, %d)\n", __LINE__, operation, _expected, _actual); \
-            } \
-            /* Call Unity's assertion but don't let it terminate the test */ \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; /* Reset immediately to prevent termination */ \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_VALIDATION_RESULT(%s, %d, %d)\n", __LINE__, operation, _expected, _actual); \
-        } \
+        ::enhanced_unity::compareValidation<validationResult>(::enhanced_unity::ASSERT_VALIDATION_RESULT, (expected), (actual), (operation), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Memory budget: heap use grew by at most maxBytes since the method started
+#define TEST_ASSERT_HEAP_DELTA_LE_DEBUG(maxBytes) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_HEAP_DELTA_LE, (int32_t)(maxBytes), ::enhanced_unity::heapUsedBytes() - ::enhanced_unity::counters().heapStartUsed, \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Memory budget: heap use peaked at most maxBytes above the method start so far
+#define TEST_ASSERT_HEAP_PEAK_LE_DEBUG(maxBytes) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_HEAP_PEAK_LE, (int32_t)(maxBytes), ::enhanced_unity::methodHeapPeak(::enhanced_unity::counters(), ::enhanced_unity::heapUsedBytes()), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Memory budget: free stack never fell below minBytes (passes where unmeasurable)
+#define TEST_ASSERT_STACK_FREE_GE_DEBUG(minBytes) \
+    do { \
+        int32_t _stackFree = ::enhanced_unity::stackFreeBytes(); \
+        ::enhanced_unity::compare<::enhanced_unity::OP_GREATER_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_STACK_FREE_GE, (int32_t)(minBytes), \
+            _stackFree == ::enhanced_unity::ENHANCED_UNITY_STACK_UNKNOWN ? (int32_t)(minBytes) : _stackFree, \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Resource budgets, measured since the method started (pass where not
+// measured). CPU time is the thread's, rounded up to whole ms.
+#define TEST_ASSERT_CPU_MS_LE_DEBUG(maxMillis) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_CPU_MS_LE, (int32_t)(maxMillis), \
+            (::enhanced_unity::methodResourcesSoFar().values[::enhanced_unity::RESOURCE_CPU] + 999) / 1000, \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_MINOR_FAULTS_LE_DEBUG(maxFaults) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_MINOR_FAULTS_LE, (int32_t)(maxFaults), \
+            ::enhanced_unity::methodResourcesSoFar().values[::enhanced_unity::RESOURCE_MINOR_FAULTS], \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_MAJOR_FAULTS_LE_DEBUG(maxFaults) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_MAJOR_FAULTS_LE, (int32_t)(maxFaults), \
+            ::enhanced_unity::methodResourcesSoFar().values[::enhanced_unity::RESOURCE_MAJOR_FAULTS], \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Voluntary plus involuntary
+#define TEST_ASSERT_CONTEXT_SWITCHES_LE_DEBUG(maxSwitches) \
+    do { \
+        ::enhanced_unity::MethodResources _resources = ::enhanced_unity::methodResourcesSoFar(); \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_CONTEXT_SWITCHES_LE, (int32_t)(maxSwitches), \
+            _resources.values[::enhanced_unity::RESOURCE_VOLUNTARY] + _resources.values[::enhanced_unity::RESOURCE_INVOLUNTARY], \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_RSS_GROWTH_KB_LE_DEBUG(maxKilobytes) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL, int32_t, int32_t>(::enhanced_unity::ASSERT_RSS_GROWTH_KB_LE, (int32_t)(maxKilobytes), \
+            ::enhanced_unity::methodResourcesSoFar().values[::enhanced_unity::RESOURCE_RSS_GROWTH], \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Any integer width, enum, bool, float or double; mixed signedness compares by value
+#define TEST_ASSERT_EQUAL_DEBUG(expected, actual) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_EQUAL>(::enhanced_unity::ASSERT_EQUAL, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// actual >= expected, compared like TEST_ASSERT_EQUAL_DEBUG
+#define TEST_ASSERT_GREATER_OR_EQUAL_DEBUG(expected, actual) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_GREATER_EQUAL>(::enhanced_unity::ASSERT_GREATER_OR_EQUAL, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// actual <= expected, compared like TEST_ASSERT_EQUAL_DEBUG
+#define TEST_ASSERT_LESS_OR_EQUAL_DEBUG(expected, actual) \
+    do { \
+        ::enhanced_unity::compare<::enhanced_unity::OP_LESS_EQUAL>(::enhanced_unity::ASSERT_LESS_OR_EQUAL, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Double-precision counterpart of TEST_ASSERT_FLOAT_WITHIN_DEBUG
+#define TEST_ASSERT_DOUBLE_WITHIN_DEBUG(delta, expected, actual) \
+    do { \
+        ::enhanced_unity::compareWithin<double>(::enhanced_unity::ASSERT_DOUBLE_WITHIN, (delta), (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Whole buffers as one assertion; a failure reports the first mismatching
+// element, how many differ and the bytes around the first one
+#define TEST_ASSERT_EQUAL_MEMORY_DEBUG(expected, actual, length) \
+    do { \
+        ::enhanced_unity::compareArrays(::enhanced_unity::ASSERT_EQUAL_MEMORY, (expected), (actual), (length), 1, \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL_UINT8_ARRAY_DEBUG(expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareArrays(::enhanced_unity::ASSERT_EQUAL_UINT8_ARRAY, (expected), (actual), (count), \
+            sizeof(uint8_t), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL_INT16_ARRAY_DEBUG(expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareArrays(::enhanced_unity::ASSERT_EQUAL_INT16_ARRAY, (expected), (actual), (count), \
+            sizeof(int16_t), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL_UINT32_ARRAY_DEBUG(expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareArrays(::enhanced_unity::ASSERT_EQUAL_UINT32_ARRAY, (expected), (actual), (count), \
+            sizeof(uint32_t), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL_INT64_ARRAY_DEBUG(expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareArrays(::enhanced_unity::ASSERT_EQUAL_INT64_ARRAY, (expected), (actual), (count), \
+            sizeof(int64_t), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+// Real arrays as one assertion. WITHIN bounds every absolute error (the
+// max-abs check), RELATIVE every error relative to |expected|, ULPS the
+// distance in representable values, RMS the root mean square of all errors.
+// A failure reports the worst element and the error statistics.
+#define TEST_ASSERT_FLOAT_ARRAY_WITHIN_DEBUG(delta, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<float>(::enhanced_unity::ASSERT_FLOAT_ARRAY_WITHIN, \
+            ::enhanced_unity::TOLERANCE_ABSOLUTE, (delta), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_ARRAY_WITHIN_DEBUG(delta, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<double>(::enhanced_unity::ASSERT_DOUBLE_ARRAY_WITHIN, \
+            ::enhanced_unity::TOLERANCE_ABSOLUTE, (delta), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_FLOAT_ARRAY_RELATIVE_DEBUG(tolerance, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<float>(::enhanced_unity::ASSERT_FLOAT_ARRAY_RELATIVE, \
+            ::enhanced_unity::TOLERANCE_RELATIVE, (tolerance), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_ARRAY_RELATIVE_DEBUG(tolerance, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<double>(::enhanced_unity::ASSERT_DOUBLE_ARRAY_RELATIVE, \
+            ::enhanced_unity::TOLERANCE_RELATIVE, (tolerance), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_FLOAT_ARRAY_ULPS_DEBUG(maxUlps, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<float>(::enhanced_unity::ASSERT_FLOAT_ARRAY_ULPS, \
+            ::enhanced_unity::TOLERANCE_ULPS, (maxUlps), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_ARRAY_ULPS_DEBUG(maxUlps, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<double>(::enhanced_unity::ASSERT_DOUBLE_ARRAY_ULPS, \
+            ::enhanced_unity::TOLERANCE_ULPS, (maxUlps), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_FLOAT_ARRAY_RMS_DEBUG(maxRms, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<float>(::enhanced_unity::ASSERT_FLOAT_ARRAY_RMS, \
+            ::enhanced_unity::TOLERANCE_RMS, (maxRms), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_ARRAY_RMS_DEBUG(maxRms, expected, actual, count) \
+    do { \
+        ::enhanced_unity::compareRealArrays<double>(::enhanced_unity::ASSERT_DOUBLE_ARRAY_RMS, \
+            ::enhanced_unity::TOLERANCE_RMS, (maxRms), (expected), (actual), (count), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 // Enhanced RUN_TEST macro that suppresses Unity's default output when using enhanced framework
-#define RUN_TEST_DEBUG(testFunction) do { \
+#define RUN_TEST_DEBUG(testFunction) RUN_TEST_TIMEOUT_DEBUG(testFunction, ENHANCED_UNITY_TEST_TIMEOUT_MS)
+
+// RUN_TEST_DEBUG with its own deadline in ms (0 = none); on ESP32 the task
+// watchdog enforces it, elsewhere on the MCU it is ignored
+#define RUN_TEST_TIMEOUT_DEBUG(testFunction, timeoutMillis) do { \
     /* Call the test function directly without Unity's output formatting */ \
     /* The test will still run and assertions will be tracked by enhanced framework */ \
-    setUp(); \
-    testFunction(); \
-    tearDown(); \
+    if (ENHANCED_UNITY_WATCHDOG_BEGIN(#testFunction, (timeoutMillis))) { \
+        setUp(); \
+        testFunction(); \
+        tearDown(); \
+        ENHANCED_UNITY_WATCHDOG_END(); \
+    } \
 } while(0)
 
+// Result caching is native-only (enhanced_unity_cache.hpp); elsewhere the test always runs
+#define RUN_TEST_CACHED_DEBUG(testFunction, contentKey) RUN_TEST_DEBUG(testFunction)
+
 // ============================================================================
 // ADDITIONAL UTILITY MACROS
 // ============================================================================
 
 // Report test summary at the end
 #define ENHANCED_UNITY_FINAL_REPORT() do { \
-    if (_enhancedUnityFailureCount > 0) { \
-        printf("=== TEST SUMMARY: %d failures recorded ===\n", _enhancedUnityFailureCount); \
+    if (ENHANCED_UNITY_GET_FAILURES() > 0) { \
+        ENHANCED_UNITY_PRINT("=== TEST SUMMARY: %d failures recorded ===\n", ENHANCED_UNITY_GET_FAILURES()); \
         /* Ensure Unity knows this test had failures */ \
         Unity.CurrentTestFailed = 1; \
-    } else if (sm->getDebugMode()) { \
-        printf("=== TEST SUMMARY: All assertions passed ===\n"); \
+    } else if (::enhanced_unity::debugMode()) { \
+        ENHANCED_UNITY_PRINT("=== TEST SUMMARY: All assertions passed ===\n"); \
     } \
+    ::enhanced_unity::flushOutput(); \
 } while(0)
 
 // Assert that no failures occurred (useful for test teardown)
 #define ENHANCED_UNITY_ASSERT_NO_FAILURES() do { \
-    if (_enhancedUnityFailureCount > 0) { \
-        printf("CRITICAL: Test had %d assertion failures!\n", _enhancedUnityFailureCount); \
+    if (ENHANCED_UNITY_GET_FAILURES() > 0) { \
+        ENHANCED_UNITY_PRINT("CRITICAL: Test had %d assertion failures!\n", ENHANCED_UNITY_GET_FAILURES()); \
         /* Ensure Unity knows this test had failures */ \
         Unity.CurrentTestFailed = 1; \
     } \
+    ::enhanced_unity::flushOutput(); \
 } while(0)
 
 // Report current test statistics
 #define ENHANCED_UNITY_REPORT() do { \
-    printf("Enhanced Unity Report: %d total assertions, %d failures\n", \
-           _enhancedUnityAssertionTotalCount, _enhancedUnityAssertionTotalFailureCount); \
+    ENHANCED_UNITY_PRINT("Enhanced Unity Report: %d total assertions, %d failures\n", \
+           ::enhanced_unity::counters().totalAssertions(), \
+           ::enhanced_unity::counters().totalAssertionFailures()); \
+    ::enhanced_unity::flushOutput(); \
 } while(0)
 
 // Compatibility aliases (Unity-style names)
@@ -649,22 +3193,8 @@ extern int _enhancedUnityFailureCount;
 // Enhanced: uint32 greater-or-equal
 #define TEST_ASSERT_GE_UINT32_DEBUG(expected, actual) \
     do { \
-        _enhancedUnityAssertionCount++; \
-        _enhancedUnityAssertionTotalCount++; \
-        uint32_t _expected = (expected); \
-        uint32_t _actual = (actual); \
-        if (!(_actual >= _expected)) { \
-            _enhancedUnityFailureCount++; \
-            _enhancedUnityAssertionFailureCount++; \
-            _enhancedUnityAssertionTotalFailureCount++; \
-            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS) { \
-                printf("    [FAILED] [ASSERTION] at line %d TEST_ASSERT_GE_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-            } \
-            Unity.CurrentTestFailed = 1; \
-            Unity.CurrentTestFailed = 0; \
-        } else if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_ALL_ASSERTIONS && sm->getDebugMode()) { \
-            printf("    [PASSED] [ASSERTION] at line %d TEST_ASSERT_GE_UINT32(0x%08x, 0x%08x)\n", __LINE__, _expected, _actual); \
-        } \
+        ::enhanced_unity::compare<::enhanced_unity::OP_GREATER_EQUAL, uint32_t, uint32_t>(::enhanced_unity::ASSERT_GE_UINT32, (expected), (actual), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
     } while(0)
 
 #endif
@@ -680,6 +3210,17 @@ extern int _enhancedUnityFailureCount;
 #ifdef CONFIGMGR_NATIVE
 
 #include <exception>
+#if ENHANCED_UNITY_THREAD_SAFE
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "enhanced_unity_cache.hpp"
+#include "enhanced_unity_stress.hpp"
+#include "enhanced_unity_history.hpp"
 
 namespace enhanced_unity_host {
 
@@ -718,59 +3259,71 @@ inline void recordAbortedMethod(const char* reason, bool force = false) {
         return;
     }
 
+    ::enhanced_unity::CounterContext& counters = ::enhanced_unity::counters();
     if (!failureRecorded) {
         failureRecorded = true;
-        _enhancedUnityMethodFailureCount++;
-        _enhancedUnityMethodTotalFailureCount++;
-        _enhancedUnityMethodFileFailureCount++;
-        _enhancedUnityFailureCount++;
+        counters.methodFailureCount++;
+        counters.methodTotalFailureCount++;
+        counters.methodFileFailureCount++;
+        counters.extraFailureCount++;
     }
 
+    bool reported = methodFinalized;
     if (!methodFinalized) {
-        _enhancedUnityAssertionFileCount += _enhancedUnityAssertionCount;
-        _enhancedUnityAssertionFileFailureCount += _enhancedUnityAssertionFailureCount;
+        ::enhanced_unity::stopMethodMeasurements();
+        ::enhanced_unity::resolveMethodCounters();
+        counters.assertionFileCount += counters.assertionCount;
+        counters.assertionFileFailureCount += counters.assertionFailureCount;
+        ::enhanced_unity::foldMethodMeasurements();
     }
 
     methodFinalized = true;
+    ::enhanced_unity::flushRecords();
 
     if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
-        printf("[ABORTED]     - %s (%s:%d) : %s\n",
+        ::enhanced_unity::print("[ABORTED]     - %s (%s:%d) : %s\n",
                currentMethodName ? currentMethodName : "<unknown>",
                currentFileName ? currentFileName : "<unknown>",
                currentLineNumber,
                reason ? reason : "unexpected failure");
     }
+    if (!reported) {
+        ::enhanced_unity::notifyMethodResult(reason ? reason : "unexpected failure");
+    }
+    ::enhanced_unity::flushOutput(true);
 }
 
 inline void handleUnexpectedException(const char* testName, const std::exception& ex) {
     recordAbortedMethod(ex.what(), true);
-    printf("    [EXCEPTION] test %s threw std::exception: %s\n", testName, ex.what());
+    ::enhanced_unity::print("    [EXCEPTION] test %s threw std::exception: %s\n", testName, ex.what());
 }
 
 inline void handleUnknownException(const char* testName) {
     recordAbortedMethod("unknown exception", true);
-    printf("    [EXCEPTION] test %s threw unknown exception\n", testName);
+    ::enhanced_unity::print("    [EXCEPTION] test %s threw unknown exception\n", testName);
 }
 
 inline void handleSetUpFailure(const char* testName, const char* message) {
-    printf("    [EXCEPTION] setUp for %s failed: %s\n", testName, message);
+    ::enhanced_unity::print("    [EXCEPTION] setUp for %s failed: %s\n", testName, message);
     Unity.CurrentTestFailed = 1;
-    _enhancedUnityFailureCount++;
+    ::enhanced_unity::counters().extraFailureCount++;
 }
 
 inline void handleTearDownException(const char* testName, const std::exception& ex) {
     recordAbortedMethod("tearDown threw exception", true);
-    printf("    [EXCEPTION] tearDown for %s threw std::exception: %s\n", testName, ex.what());
+    ::enhanced_unity::print("    [EXCEPTION] tearDown for %s threw std::exception: %s\n", testName, ex.what());
 }
 
 inline void handleUnknownTearDownException(const char* testName) {
     recordAbortedMethod("tearDown threw unknown exception", true);
-    printf("    [EXCEPTION] tearDown for %s threw unknown exception\n", testName);
+    ::enhanced_unity::print("    [EXCEPTION] tearDown for %s threw unknown exception\n", testName);
 }
 
-inline void runTest(const char* testName, void (*function)()) {
+// setUp, test and tearDown on the calling thread; once `abandoned` is set (the
+// deadline passed and the run was given up) the fixture is left alone
+inline void runTestInPlace(const char* testName, void (*function)(), const std::atomic<bool>* abandoned = nullptr) {
     if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
-        printf("[RUN] %s\n", testName);
+        ::enhanced_unity::print("[RUN] %s\n", testName);
     }
     bool setupComplete = false;
     try {
@@ -797,7 +3350,7 @@ inline void runTest(const char* testName, void (*function)()) {
         handleUnknownException(testName);
     }
 
-    if (setupComplete) {
+    if (setupComplete && (abandoned == nullptr || !abandoned->load())) {
         try {
             tearDown();
         } catch (const std::exception& ex) {
@@ -808,6 +3361,215 @@ inline void runTest(const char* testName, void (*function)()) {
     }
 }
 
+// Book a test that overran its deadline as an aborted method; `startMicros`
+// is when it was started
+inline void recordTimeout(const char* testName, const char* fileName, int lineNumber,
+                          ::enhanced_unity::TimeMicros startMicros, uint32_t limitMillis) {
+    ::enhanced_unity::TimeMicros elapsed = ::enhanced_unity::nowMicros() - startMicros;
+    char reason[80];
+    snprintf(reason, sizeof(reason), "timed out after %lu.%03lu ms (limit %lu ms)",
+             ::enhanced_unity::wholeMillis(elapsed), ::enhanced_unity::fractionMillis(elapsed),
+             (unsigned long)limitMillis);
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+        ::enhanced_unity::print("[RUN] %s\n", testName);
+    }
+    beginMethod(testName, fileName, lineNumber);
+    ::enhanced_unity::startMethodCounters(testName, fileName);
+    ::enhanced_unity::counters().methodStartMicros = startMicros;
+    recordAbortedMethod(reason, true);
+    ::enhanced_unity::noteTimedOutMethod(testName, elapsed);
+}
+
+// Set in forked process pool workers, whose deadlines the parent enforces
+inline bool inProcessWorker = false;
+
+#if ENHANCED_UNITY_THREAD_SAFE
+// Set on parallel runner threads: fork() there would clone one thread of a
+// running batch, so their deadlines are kept by a DeadlineHelper instead
+inline thread_local bool onParallelWorker = false;
+
+// Runs the deadline tests of one calling thread on a long-lived helper thread
+// with a private context and output capture, so a test costs no allocation.
+// On time, the helper's output and counters are merged as if the test had run
+// here. On overrun the helper is abandoned: it finishes the hung test without
+// tearDown and exits, its state leaked (freeing it would be charged to whatever
+// test runs then); the next test starts a fresh helper.
+class DeadlineHelper {
+public:
+    ~DeadlineHelper() { stop(); }
+
+    // False when the test overran `limitMillis`
+    bool run(const char* testName, void (*function)(), uint32_t limitMillis) {
+        if (!state_) {
+            start();
+        }
+        State& state = *state_;
+        state.counters.reset();
+        state.output.text.clear();
+        for (std::string& report : state.output.reports) {
+            report.clear();
+        }
+        {
+            std::lock_guard<std::mutex> guard(state.mutex);
+            state.testName = testName;
+            state.function = function;
+            state.pending = true;
+            state.done = false;
+        }
+        state.wake.notify_one();
+
+        bool onTime = false;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            onTime = state.finished.wait_for(lock, std::chrono::milliseconds(limitMillis),
+                                             [&state]() { return state.done; });
+            if (!onTime) {
+                state.abandoned = true;
+            }
+        }
+        if (!onTime) {
+            thread_.detach();
+            state_.release();
+            return false;
+        }
+        ::enhanced_unity::print("%s", state.output.text.c_str());
+        ::enhanced_unity::replayReports(state.output);
+        ::enhanced_unity::counters().absorb(state.counters.snapshot());
+        return true;
+    }
+
+private:
+    struct State {
+        ::enhanced_unity::CounterContext counters;
+        ::enhanced_unity::RecordBuffer records;
+        ::enhanced_unity::OutputCapture output;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        const char* testName = nullptr;
+        void (*function)() = nullptr;
+        bool pending = false;
+        bool done = false;
+        bool stopping = false;
+        std::atomic<bool> abandoned{false};
+    };
+
+    void start() {
+        state_.reset(new State());
+        state_->counters.setRecordBuffer(&state_->records);
+        thread_ = std::thread(serve, state_.get());
+    }
+
+    void stop() {
+        if (!state_) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(state_->mutex);
+            state_->stopping = true;
+        }
+        state_->wake.notify_one();
+        thread_.join();
+        state_.reset();
+    }
+
+    static void serve(State* state) {
+        ::enhanced_unity::ScopedCounterContext scope(state->counters);
+        ::enhanced_unity::threadOutputCapture() = &state->output;
+        while (!state->abandoned) {
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->wake.wait(lock, [state]() { return state->pending || state->stopping; });
+                if (!state->pending) {
+                    break;
+                }
+                state->pending = false;
+            }
+            runTestInPlace(state->testName, state->function, &state->abandoned);
+            std::lock_guard<std::mutex> guard(state->mutex);
+            state->done = true;
+            state->finished.notify_one();
+        }
+        ::enhanced_unity::threadOutputCapture() = nullptr;
+    }
+
+    std::unique_ptr<State> state_;
+    std::thread thread_;
+};
+
+// Run the test under a deadline on this thread's DeadlineHelper while the
+// calling thread waits at most `limitMillis`; an overrun is booked as timed out
+inline void runTestWithDeadline(const char* testName, void (*function)(), const char* fileName, int lineNumber,
+                                uint32_t limitMillis) {
+    static thread_local DeadlineHelper helper;
+    ::enhanced_unity::flushOutput();
+    ::enhanced_unity::TimeMicros startMicros = ::enhanced_unity::nowMicros();
+    if (!helper.run(testName, function, limitMillis)) {
+        recordTimeout(testName, fileName, lineNumber, startMicros, limitMillis);
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// One iteration of a test in a forked worker that is killed at the deadline
+// (enhanced_unity_process_pool.hpp)
+inline void runTestForked(const char* testName, void (*function)(), const char* fileName, int lineNumber,
+                          uint32_t limitMillis);
+#endif
+#endif
+
+// One iteration of runTest
+inline void runTestOnce(const char* testName, void (*function)(), const char* fileName, int lineNumber) {
+    int failureMark = ResultCache::failureMark();
+#if ENHANCED_UNITY_THREAD_SAFE
+    uint32_t limitMillis = ::enhanced_unity::testTimeout(function);
+    if (limitMillis > 0 && !inProcessWorker) {
+#if defined(__unix__) || defined(__APPLE__)
+        // A forked test that overruns is killed, so nothing of it runs on
+        if (!onParallelWorker) {
+            runTestForked(testName, function, fileName, lineNumber, limitMillis);
+            resultCache().finish(function, failureMark);
+            return;
+        }
+#endif
+        runTestWithDeadline(testName, function, fileName, lineNumber, limitMillis);
+        resultCache().finish(function, failureMark);
+        return;
+    }
+#else
+    (void)fileName;
+    (void)lineNumber;
+#endif
+    runTestInPlace(testName, function);
+    resultCache().finish(function, failureMark);
+}
+
+// Run one test with exception handling and, when it has a deadline, under
+// the watchdog; `fileName`/`lineNumber` locate it in timeout reports. In
+// stress mode the test repeats in place unless the caller drives the rounds.
+inline void runTest(const char* testName, void (*function)(), const char* fileName = nullptr, int lineNumber = 0) {
+    if (!::enhanced_unity::inShard(testName)) {
+        return;
+    }
+    const StressOptions& stress = stressOptions();
+    if (!stress.active()) {
+        runTestOnce(testName, function, fileName, lineNumber);
+        return;
+    }
+    uint32_t runs = 0;
+    ::enhanced_unity::TimeMicros spent = 0;
+    do {
+        int failureMark = ResultCache::failureMark();
+        ::enhanced_unity::TimeMicros startMicros = ::enhanced_unity::nowMicros();
+        runTestOnce(testName, function, fileName, lineNumber);
+        ::enhanced_unity::TimeMicros elapsed = ::enhanced_unity::nowMicros() - startMicros;
+        if (!inProcessWorker) {
+            stressRecorder().note(testName, function, ResultCache::failureMark() == failureMark, elapsed);
+        }
+        runs++;
+        spent += elapsed;
+    } while (!stress.interleaved && stress.wantsMore(runs, spent));
+}
+
 } // namespace enhanced_unity_host
 
 // Redefine macros for native exception handling
@@ -816,43 +3578,80 @@ inline void runTest(const char* testName, void (*function)()) {
     do { \
         ::enhanced_unity_host::beginMethod((methodName), (fileName), (lineNumber)); \
         if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) { \
-            printf("===== %s \n", (methodName)); \
+            ::enhanced_unity::print("===== %s \n", (methodName)); \
+            ::enhanced_unity::flushOutput(); \
         } \
-        _enhancedUnityMethodCount++; \
-        _enhancedUnityMethodTotalCount++; \
-        _enhancedUnityMethodFileCount++; \
-        _enhancedUnityAssertionCount = 0; \
-        _enhancedUnityAssertionFailureCount = 0; \
+        ::enhanced_unity::startMethodCounters((methodName), (fileName)); \
     } while(0)
 
 #undef ENHANCED_UNITY_END_TEST_METHOD
 #define ENHANCED_UNITY_END_TEST_METHOD() \
     do { \
-        if (_enhancedUnityAssertionFailureCount > 0) { \
-            _enhancedUnityMethodFailureCount++; \
-            _enhancedUnityMethodTotalFailureCount++; \
-            _enhancedUnityMethodFileFailureCount++; \
+        ::enhanced_unity::stopMethodMeasurements(); \
+        ::enhanced_unity::flushRecords(); \
+        bool _methodFailed = ::enhanced_unity::endMethodCounters(); \
+        if (_methodFailed) { \
             ::enhanced_unity_host::markFailureRecorded(); \
         } \
-        _enhancedUnityAssertionFileCount += _enhancedUnityAssertionCount; \
-        _enhancedUnityAssertionFileFailureCount += _enhancedUnityAssertionFailureCount; \
-        if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) { \
-            printf("[%s]     - assertions [tot %5d | pass %5d | fail %5d]\n", \
-                   _enhancedUnityAssertionFailureCount == 0 ? "PASSED" : "FAILED", \
-                   _enhancedUnityAssertionCount, \
-                   _enhancedUnityAssertionCount - _enhancedUnityAssertionFailureCount, \
-                   _enhancedUnityAssertionFailureCount \
-                ); \
-        } \
+        ::enhanced_unity::reportMethodResult(); \
+        ::enhanced_unity::flushOutput(); \
         ::enhanced_unity_host::finalizeMethod(); \
-        if (_enhancedUnityAssertionFailureCount > 0) { \
+        if (_methodFailed) { \
             throw ::enhanced_unity_host::TestAbortSignal(); \
         } \
     } while(0)
 
 #undef RUN_TEST_DEBUG
-#define RUN_TEST_DEBUG(testFunction) ::enhanced_unity_host::runTest(#testFunction, (testFunction))
+#define RUN_TEST_DEBUG(testFunction) ::enhanced_unity_host::runTest(#testFunction, (testFunction), __FILE__, __LINE__)
+
+// RUN_TEST_DEBUG with its own deadline in ms (0 = none); it stays with the
+// test, so queued runners (parallel, process pool) enforce it too
+#undef RUN_TEST_TIMEOUT_DEBUG
+#define RUN_TEST_TIMEOUT_DEBUG(testFunction, timeoutMillis) \
+    do { \
+        ::enhanced_unity::setTestTimeout((testFunction), (timeoutMillis)); \
+        RUN_TEST_DEBUG(testFunction); \
+    } while(0)
+
+#if ENHANCED_UNITY_THREAD_SAFE
+#include "enhanced_unity_parallel.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include "enhanced_unity_process_pool.hpp"
+#endif
+
+namespace enhanced_unity_host {
+
+// Drain every queue; called by ENHANCED_UNITY_END_TEST_FILE/FINAL_SUMMARY
+inline void runPendingTests() {
+    parallelRunner().run();
+#if defined(__unix__) || defined(__APPLE__)
+    processPool().run();
+#endif
+}
+
+} // namespace enhanced_unity_host
+
+#undef ENHANCED_UNITY_RUN_PENDING_TESTS
+#define ENHANCED_UNITY_RUN_PENDING_TESTS() ::enhanced_unity_host::runPendingTests()
+#endif
+
+// The stress and timing history sections follow the summary
+#undef ENHANCED_UNITY_FINAL_SUMMARY
+#define ENHANCED_UNITY_FINAL_SUMMARY() do { \
+    ENHANCED_UNITY_RUN_PENDING_TESTS(); \
+    ::enhanced_unity::flushRecords(); \
+    ::enhanced_unity_host::timingHistory().compare(); \
+    ::enhanced_unity::reportFinalSummary(); \
+    ::enhanced_unity_host::reportStressResults(); \
+    ::enhanced_unity_host::timingHistory().finish(); \
+    ::enhanced_unity::flushOutput(true); \
+} while(0)
 
 #endif // CONFIGMGR_NATIVE
 
+#ifndef USE_BASELINE_UNITY
+#include "enhanced_unity_registry.hpp"
+#include "enhanced_unity_benchmark.hpp"
+#endif
+
 
@@ -0,0 +1,511 @@
+#pragma once
+
+// ============================================================================
+// MEMORY AND ARRAY ASSERTIONS
+// ============================================================================
+// TEST_ASSERT_EQUAL_MEMORY_DEBUG and TEST_ASSERT_EQUAL_*_ARRAY_DEBUG compare
+// whole buffers and count as one assertion each. The search for the first
+// differing byte is a kernel picked once at run time on native hosts (AVX2,
+// then SSE2 on x86; NEON on AArch64); other targets compare one machine word
+// at a time. Only a failure that is going to be reported scans on, counting
+// the elements that differ and keeping ENHANCED_UNITY_ARRAY_WINDOW bytes of
+// both buffers around the first mismatch.
+//
+// TEST_ASSERT_{FLOAT,DOUBLE}_ARRAY_*_DEBUG compare real arrays under a
+// ToleranceMode the same way: a fast pass decides pass/fail (AVX2 on x86
+// hosts, plain loops elsewhere), and the statistics of the report (worst
+// element, elements outside, largest error, RMS) are computed afterwards
+// only when the record is kept. Elements that compare equal, including
+// equal infinities and NaN against NaN, have no error.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+#include <math.h>
+
+#if defined(CONFIGMGR_NATIVE) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define ENHANCED_UNITY_ARRAY_KERNELS_X86 1
+#elif defined(CONFIGMGR_NATIVE) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ENHANCED_UNITY_ARRAY_KERNELS_NEON 1
+#endif
+
+namespace enhanced_unity {
+
+// Offset of the first byte where a and b differ, or length when they are equal
+typedef size_t (*MismatchKernel)(const uint8_t* a, const uint8_t* b, size_t length);
+
+// Portable kernel: a machine word at a time, unaligned loads through memcpy
+inline size_t firstMismatchWords(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    for (; i + sizeof(uintptr_t) <= length; i += sizeof(uintptr_t)) {
+        uintptr_t wordA;
+        uintptr_t wordB;
+        memcpy(&wordA, a + i, sizeof(wordA));
+        memcpy(&wordB, b + i, sizeof(wordB));
+        if (wordA != wordB) {
+            break;
+        }
+    }
+    while (i < length && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+#if ENHANCED_UNITY_ARRAY_KERNELS_X86
+
+__attribute__((target("sse2"))) inline size_t firstMismatchSse2(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        unsigned differ = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(blockA, blockB)) & 0xFFFFu;
+        if (differ != 0) {
+            return i + (size_t)__builtin_ctz(differ);
+        }
+    }
+    return i + firstMismatchWords(a + i, b + i, length - i);
+}
+
+__attribute__((target("avx2"))) inline size_t firstMismatchAvx2(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i blockA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i blockB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        uint32_t differ = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(blockA, blockB));
+        if (differ != 0) {
+            return i + (size_t)__builtin_ctz(differ);
+        }
+    }
+    return i + firstMismatchSse2(a + i, b + i, length - i);
+}
+
+#elif ENHANCED_UNITY_ARRAY_KERNELS_NEON
+
+inline size_t firstMismatchNeon(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        if (vminvq_u8(vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i))) != 0xFF) {
+            break;
+        }
+    }
+    return i + firstMismatchWords(a + i, b + i, length - i);
+}
+
+#endif
+
+#if ENHANCED_UNITY_ARRAY_KERNELS_X86 || ENHANCED_UNITY_ARRAY_KERNELS_NEON
+
+// The widest kernel this CPU runs
+inline MismatchKernel selectMismatchKernel() {
+#if ENHANCED_UNITY_ARRAY_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return firstMismatchAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return firstMismatchSse2;
+    }
+    return firstMismatchWords;
+#else
+    return firstMismatchNeon;
+#endif
+}
+
+inline size_t firstMismatch(const uint8_t* a, const uint8_t* b, size_t length) {
+    static const MismatchKernel kernel = selectMismatchKernel();
+    return kernel(a, b, length);
+}
+
+#else
+
+inline size_t firstMismatch(const uint8_t* a, const uint8_t* b, size_t length) {
+    return firstMismatchWords(a, b, length);
+}
+
+#endif
+
+// Elements at or after `first` that differ; equal runs are skipped by the kernel
+inline uint32_t countMismatches(const uint8_t* expected, const uint8_t* actual, size_t count,
+                                size_t elementSize, size_t first) {
+    size_t length = count * elementSize;
+    size_t offset = first * elementSize;
+    uint32_t mismatches = 0;
+    while (offset < length) {
+        offset += firstMismatch(expected + offset, actual + offset, length - offset);
+        if (offset >= length) {
+            break;
+        }
+        mismatches++;
+        offset = (offset / elementSize + 1) * elementSize;
+    }
+    return mismatches;
+}
+
+// Write the record of an array comparison. A failure is scanned to the end
+// and keeps the elements around `mismatch` that fit the window.
+ENHANCED_UNITY_COLD inline void recordArrays(uint8_t kind, bool passed, int line, const char* fileName, const uint8_t* expected,
+                         const uint8_t* actual, size_t count, size_t elementSize, size_t mismatch) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record == nullptr) {
+        return;
+    }
+    record->value.a.count = (uint32_t)count;
+    record->value.a.mismatch = (uint32_t)mismatch;
+    record->value.a.elementSize = (uint8_t)elementSize;
+    record->value.a.windowStart = 0;
+    record->value.a.windowBytes = 0;
+    if (passed) {
+        record->value.a.mismatches = 0;
+        return;
+    }
+    if (expected == nullptr || actual == nullptr) {
+        record->value.a.mismatches = (uint32_t)count;
+        return;
+    }
+    record->value.a.mismatches = countMismatches(expected, actual, count, elementSize, mismatch);
+    size_t fit = ENHANCED_UNITY_ARRAY_WINDOW / elementSize;
+    if (fit == 0) {
+        return;
+    }
+    // Centre the window on the mismatch, shifted back at the end of the array
+    size_t start = mismatch - (mismatch < (fit - 1) / 2 ? mismatch : (fit - 1) / 2);
+    if (start + fit > count) {
+        start = count > fit ? count - fit : 0;
+    }
+    size_t elements = count - start < fit ? count - start : fit;
+    record->value.a.windowStart = (uint32_t)start;
+    record->value.a.windowBytes = (uint8_t)(elements * elementSize);
+    memcpy(record->value.a.expected, expected + start * elementSize, elements * elementSize);
+    memcpy(record->value.a.actual, actual + start * elementSize, elements * elementSize);
+}
+
+// `count` elements of `elementSize` bytes compared bytewise, as one assertion.
+// The same buffer (or two null pointers) passes; one null pointer fails.
+inline void compareArrays(uint8_t kind, const void* expected, const void* actual, size_t count, size_t elementSize,
+                          int line, const char* fileName, bool recordPasses) {
+    const uint8_t* expectedBytes = static_cast<const uint8_t*>(expected);
+    const uint8_t* actualBytes = static_cast<const uint8_t*>(actual);
+    size_t mismatch = count;
+    if (expectedBytes != actualBytes && count > 0) {
+        mismatch = expectedBytes == nullptr || actualBytes == nullptr
+                 ? 0 : firstMismatch(expectedBytes, actualBytes, count * elementSize) / elementSize;
+    }
+    bool passed = mismatch == count;
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses))) {
+        recordArrays(kind, passed, line, fileName, expectedBytes, actualBytes, count, elementSize, mismatch);
+    }
+}
+
+// ---- real arrays ----
+
+// Distance in representable values; floats are mapped to integers that keep
+// their order (-0 and +0 both map to 0)
+inline uint64_t ulpDistance(float expected, float actual) {
+    int32_t bits[2];
+    memcpy(&bits[0], &expected, sizeof(float));
+    memcpy(&bits[1], &actual, sizeof(float));
+    int64_t ordered[2];
+    for (int i = 0; i < 2; i++) {
+        ordered[i] = bits[i] < 0 ? (int64_t)INT32_MIN - bits[i] : bits[i];
+    }
+    return ordered[0] > ordered[1] ? (uint64_t)(ordered[0] - ordered[1]) : (uint64_t)(ordered[1] - ordered[0]);
+}
+
+inline uint64_t ulpDistance(double expected, double actual) {
+    if (sizeof(double) == sizeof(float)) {  // AVR
+        return ulpDistance((float)expected, (float)actual);
+    }
+    int64_t bits[2] = { 0, 0 };
+    memcpy(&bits[0], &expected, sizeof(double));
+    memcpy(&bits[1], &actual, sizeof(double));
+    uint64_t ordered[2];
+    for (int i = 0; i < 2; i++) {
+        ordered[i] = (uint64_t)(bits[i] < 0 ? INT64_MIN - bits[i] : bits[i]) ^ 0x8000000000000000ull;
+    }
+    return ordered[0] > ordered[1] ? ordered[0] - ordered[1] : ordered[1] - ordered[0];
+}
+
+// Elements with no error: equal, or both NaN
+template <typename T>
+inline bool sameReal(T expected, T actual) {
+    return actual == expected || (actual != actual && expected != expected);
+}
+
+// Whether one element pair satisfies `mode`; TOLERANCE_RMS is judged on the
+// whole array, so every element passes here
+template <typename T>
+inline bool withinTolerance(T expected, T actual, uint8_t mode, double limit) {
+    if (sameReal(expected, actual)) {
+        return true;
+    }
+    T error = actual > expected ? actual - expected : expected - actual;
+    if (error != error) {  // one NaN
+        return false;
+    }
+    switch (mode) {
+    case TOLERANCE_ABSOLUTE: return error <= (T)limit;
+    case TOLERANCE_RELATIVE: return error <= (T)limit * (expected < 0 ? -expected : expected);
+    case TOLERANCE_ULPS: return (double)ulpDistance(expected, actual) <= limit;
+    default: return true;
+    }
+}
+
+template <typename T>
+inline size_t firstOutsideScalar(const T* expected, const T* actual, size_t count, uint8_t mode, double limit) {
+    for (size_t i = 0; i < count; i++) {
+        if (!withinTolerance(expected[i], actual[i], mode, limit)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+template <typename T>
+inline double squaredError(T expected, T actual) {
+    if (sameReal(expected, actual)) {
+        return 0;
+    }
+    double error = (double)actual - (double)expected;
+    return error * error;
+}
+
+template <typename T>
+inline double sumSquaredErrorsScalar(const T* expected, const T* actual, size_t count) {
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += squaredError(expected[i], actual[i]);
+    }
+    return sum;
+}
+
+#if ENHANCED_UNITY_ARRAY_KERNELS_X86
+
+inline bool cpuHasAvx2() {
+    static const bool hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+    return hasAvx2;
+}
+
+__attribute__((target("avx2"))) inline size_t firstOutsideAvx2(const float* expected, const float* actual,
+                                                               size_t count, uint8_t mode, double limit) {
+    if (mode != TOLERANCE_ABSOLUTE && mode != TOLERANCE_RELATIVE && mode != TOLERANCE_ULPS) {
+        return count;
+    }
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 bound = _mm256_set1_ps((float)limit);
+    const __m256i orderBase = _mm256_set1_epi32(INT32_MIN);
+    const __m256i maxUlps = _mm256_set1_epi64x(limit < 9.2e18 ? (long long)limit : INT64_MAX);
+    const __m256i minUlps = _mm256_sub_epi64(_mm256_setzero_si256(), maxUlps);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 e = _mm256_loadu_ps(expected + i);
+        __m256 a = _mm256_loadu_ps(actual + i);
+        __m256 eitherNan = _mm256_cmp_ps(e, a, _CMP_UNORD_Q);
+        __m256 same = _mm256_or_ps(_mm256_cmp_ps(e, a, _CMP_EQ_OQ),
+                                   _mm256_and_ps(_mm256_cmp_ps(e, e, _CMP_UNORD_Q), _mm256_cmp_ps(a, a, _CMP_UNORD_Q)));
+        unsigned outside;
+        if (mode == TOLERANCE_ULPS) {
+            __m256i eBits = _mm256_castps_si256(e);
+            __m256i aBits = _mm256_castps_si256(a);
+            __m256i eOrdered = _mm256_blendv_epi8(eBits, _mm256_sub_epi32(orderBase, eBits), _mm256_srai_epi32(eBits, 31));
+            __m256i aOrdered = _mm256_blendv_epi8(aBits, _mm256_sub_epi32(orderBase, aBits), _mm256_srai_epi32(aBits, 31));
+            unsigned far = 0;
+            for (int half = 0; half < 2; half++) {
+                __m128i eHalf = half == 0 ? _mm256_castsi256_si128(eOrdered) : _mm256_extracti128_si256(eOrdered, 1);
+                __m128i aHalf = half == 0 ? _mm256_castsi256_si128(aOrdered) : _mm256_extracti128_si256(aOrdered, 1);
+                __m256i distance = _mm256_sub_epi64(_mm256_cvtepi32_epi64(aHalf), _mm256_cvtepi32_epi64(eHalf));
+                __m256i beyond = _mm256_or_si256(_mm256_cmpgt_epi64(distance, maxUlps), _mm256_cmpgt_epi64(minUlps, distance));
+                far |= (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(beyond)) << (half * 4);
+            }
+            outside = far | (unsigned)_mm256_movemask_ps(eitherNan);
+        } else {
+            __m256 error = _mm256_andnot_ps(signBit, _mm256_sub_ps(a, e));
+            __m256 allowed = mode == TOLERANCE_RELATIVE ? _mm256_mul_ps(bound, _mm256_andnot_ps(signBit, e)) : bound;
+            outside = ~(unsigned)_mm256_movemask_ps(_mm256_cmp_ps(error, allowed, _CMP_LE_OQ)) & 0xFFu;
+        }
+        outside &= ~(unsigned)_mm256_movemask_ps(same);
+        if (outside != 0) {
+            return i + (size_t)__builtin_ctz(outside);
+        }
+    }
+    return i + firstOutsideScalar(expected + i, actual + i, count - i, mode, limit);
+}
+
+__attribute__((target("avx2"))) inline size_t firstOutsideAvx2(const double* expected, const double* actual,
+                                                               size_t count, uint8_t mode, double limit) {
+    if (mode != TOLERANCE_ABSOLUTE && mode != TOLERANCE_RELATIVE) {
+        return firstOutsideScalar(expected, actual, count, mode, limit);  // 64-bit ULPs stay scalar
+    }
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d bound = _mm256_set1_pd(limit);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d e = _mm256_loadu_pd(expected + i);
+        __m256d a = _mm256_loadu_pd(actual + i);
+        __m256d same = _mm256_or_pd(_mm256_cmp_pd(e, a, _CMP_EQ_OQ),
+                                    _mm256_and_pd(_mm256_cmp_pd(e, e, _CMP_UNORD_Q), _mm256_cmp_pd(a, a, _CMP_UNORD_Q)));
+        __m256d error = _mm256_andnot_pd(signBit, _mm256_sub_pd(a, e));
+        __m256d allowed = mode == TOLERANCE_RELATIVE ? _mm256_mul_pd(bound, _mm256_andnot_pd(signBit, e)) : bound;
+        unsigned outside = ~(unsigned)_mm256_movemask_pd(_mm256_or_pd(same, _mm256_cmp_pd(error, allowed, _CMP_LE_OQ))) & 0xFu;
+        if (outside != 0) {
+            return i + (size_t)__builtin_ctz(outside);
+        }
+    }
+    return i + firstOutsideScalar(expected + i, actual + i, count - i, mode, limit);
+}
+
+// Squared errors of four pairs, widened to double; equal pairs contribute 0
+__attribute__((target("avx2"))) inline __m256d squaredErrorsAvx2(__m256d e, __m256d a) {
+    __m256d same = _mm256_or_pd(_mm256_cmp_pd(e, a, _CMP_EQ_OQ),
+                                _mm256_and_pd(_mm256_cmp_pd(e, e, _CMP_UNORD_Q), _mm256_cmp_pd(a, a, _CMP_UNORD_Q)));
+    __m256d error = _mm256_andnot_pd(same, _mm256_sub_pd(a, e));
+    return _mm256_mul_pd(error, error);
+}
+
+__attribute__((target("avx2"))) inline double sumSquaredErrorsAvx2(const float* expected, const float* actual,
+                                                                   size_t count) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum = _mm256_add_pd(sum, squaredErrorsAvx2(_mm256_cvtps_pd(_mm_loadu_ps(expected + i)),
+                                                   _mm256_cvtps_pd(_mm_loadu_ps(actual + i))));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sum);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumSquaredErrorsScalar(expected + i, actual + i, count - i);
+}
+
+__attribute__((target("avx2"))) inline double sumSquaredErrorsAvx2(const double* expected, const double* actual,
+                                                                   size_t count) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum = _mm256_add_pd(sum, squaredErrorsAvx2(_mm256_loadu_pd(expected + i), _mm256_loadu_pd(actual + i)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sum);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumSquaredErrorsScalar(expected + i, actual + i, count - i);
+}
+
+#endif
+
+// First element outside the tolerance, or count; TOLERANCE_RMS always gives count
+template <typename T>
+inline size_t firstOutside(const T* expected, const T* actual, size_t count, uint8_t mode, double limit) {
+#if ENHANCED_UNITY_ARRAY_KERNELS_X86
+    if (cpuHasAvx2()) {
+        return firstOutsideAvx2(expected, actual, count, mode, limit);
+    }
+#endif
+    return firstOutsideScalar(expected, actual, count, mode, limit);
+}
+
+template <typename T>
+inline double sumSquaredErrors(const T* expected, const T* actual, size_t count) {
+#if ENHANCED_UNITY_ARRAY_KERNELS_X86
+    if (cpuHasAvx2()) {
+        return sumSquaredErrorsAvx2(expected, actual, count);
+    }
+#endif
+    return sumSquaredErrorsScalar(expected, actual, count);
+}
+
+// Error of one pair as `mode` measures it; infinite for a single NaN
+template <typename T>
+inline double toleranceError(T expected, T actual, uint8_t mode) {
+    if (sameReal(expected, actual)) {
+        return 0;
+    }
+    double error = (double)actual - (double)expected;
+    error = error < 0 ? -error : error;
+    if (error != error) {
+        return INFINITY;
+    }
+    switch (mode) {
+    case TOLERANCE_RELATIVE: return expected != 0 ? error / (expected < 0 ? -(double)expected : (double)expected) : INFINITY;
+    case TOLERANCE_ULPS: return (double)ulpDistance(expected, actual);
+    default: return error;
+    }
+}
+
+// Write the record of a real-array comparison, with the statistics of the
+// whole array
+template <typename T>
+ENHANCED_UNITY_COLD inline void recordRealArrays(uint8_t kind, bool passed, int line, const char* fileName, uint8_t mode, double limit,
+                             const T* expected, const T* actual, size_t count) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record == nullptr) {
+        return;
+    }
+    if (sizeof(T) > sizeof(float)) {
+        record->flags |= RECORD_DOUBLE_PRECISION;
+    }
+    record->value.t.count = (uint32_t)count;
+    record->value.t.mode = mode;
+    record->value.t.limit = limit;
+    record->value.t.worst = 0;
+    record->value.t.outside = 0;
+    record->value.t.expected = 0;
+    record->value.t.actual = 0;
+    record->value.t.worstError = 0;
+    record->value.t.rms = 0;
+    if (expected == nullptr || actual == nullptr) {
+        if (!passed) {
+            record->value.t.worst = (uint32_t)count;  // no element to show
+            record->value.t.outside = (uint32_t)count;
+            record->value.t.worstError = INFINITY;
+        }
+        return;
+    }
+    size_t worst = 0;
+    double worstError = -1;
+    double sum = 0;
+    uint32_t outside = 0;
+    for (size_t i = 0; i < count; i++) {
+        double error = toleranceError(expected[i], actual[i], mode);
+        if (error > worstError) {
+            worst = i;
+            worstError = error;
+        }
+        if (mode != TOLERANCE_RMS && !withinTolerance(expected[i], actual[i], mode, limit)) {
+            outside++;
+        }
+        sum += squaredError(expected[i], actual[i]);
+    }
+    if (count > 0) {
+        record->value.t.worst = (uint32_t)worst;
+        record->value.t.expected = expected[worst];
+        record->value.t.actual = actual[worst];
+        record->value.t.worstError = worstError;
+        record->value.t.rms = sqrt(sum / (double)count);
+    }
+    record->value.t.outside = outside;
+}
+
+// `count` real pairs judged under `mode`, as one assertion. The same array
+// (or two null pointers) passes; one null pointer fails.
+template <typename T>
+inline void compareRealArrays(uint8_t kind, uint8_t mode, double limit, const T* expected, const T* actual,
+                              size_t count, int line, const char* fileName, bool recordPasses) {
+    bool passed;
+    if (expected == actual || count == 0) {
+        passed = true;
+    } else if (expected == nullptr || actual == nullptr) {
+        passed = false;
+    } else if (mode == TOLERANCE_RMS) {
+        passed = sqrt(sumSquaredErrors(expected, actual, count) / (double)count) <= limit;
+    } else {
+        passed = firstOutside(expected, actual, count, mode, limit) == count;
+    }
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses))) {
+        recordRealArrays(kind, passed, line, fileName, mode, limit, expected, actual, count);
+    }
+}
+
+} // namespace enhanced_unity
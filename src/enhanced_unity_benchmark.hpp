@@ -0,0 +1,238 @@
+#pragma once
+
+// ============================================================================
+// MICROBENCHMARKS
+// ============================================================================
+// ENHANCED_UNITY_BENCHMARK(name) { ... } registers a test (tags "benchmark,
+// exclusive") whose body is the operation to measure. The runner grows the
+// iteration count until one sample takes ENHANCED_UNITY_BENCHMARK_SAMPLE_US,
+// takes ENHANCED_UNITY_BENCHMARK_SAMPLES samples and reports min, median and
+// p99 in ns per operation. ENHANCED_UNITY_BENCHMARK_MAX_NS(name, ns) also
+// counts an assertion that fails when the median exceeds the bound.
+// Assertions inside the body are neither counted nor recorded while it is
+// timed; only the bound check counts.
+//
+// Ticks come from the cheapest counter available: rdtsc on x86 native,
+// steady_clock on other native hosts, CCOUNT on Xtensa (ESP32), DWT->CYCCNT
+// on Cortex-M3/M4/M7 (SAM3X, SAMD51) and micros() everywhere else. Cycle
+// counters are converted to time once, against nowMicros().
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Target duration of one sample
+#ifndef ENHANCED_UNITY_BENCHMARK_SAMPLE_US
+#ifdef CONFIGMGR_NATIVE
+#define ENHANCED_UNITY_BENCHMARK_SAMPLE_US 2000
+#else
+#define ENHANCED_UNITY_BENCHMARK_SAMPLE_US 10000
+#endif
+#endif
+
+// Samples per benchmark
+#ifndef ENHANCED_UNITY_BENCHMARK_SAMPLES
+#ifdef __AVR__
+#define ENHANCED_UNITY_BENCHMARK_SAMPLES 7
+#else
+#define ENHANCED_UNITY_BENCHMARK_SAMPLES 31
+#endif
+#endif
+
+// Time spent measuring the tick rate of a cycle counter
+#ifndef ENHANCED_UNITY_BENCHMARK_CALIBRATION_US
+#define ENHANCED_UNITY_BENCHMARK_CALIBRATION_US 5000
+#endif
+
+#if defined(CONFIGMGR_NATIVE) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+namespace enhanced_unity {
+
+#if defined(CONFIGMGR_NATIVE) && (defined(__x86_64__) || defined(__i386__))
+typedef uint64_t BenchmarkTicks;
+inline BenchmarkTicks benchmarkTicks() { return __rdtsc(); }
+#define ENHANCED_UNITY_BENCHMARK_CYCLE_COUNTER 1
+#elif defined(CONFIGMGR_NATIVE)
+typedef uint64_t BenchmarkTicks;
+inline BenchmarkTicks benchmarkTicks() {
+    return (BenchmarkTicks)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#define ENHANCED_UNITY_BENCHMARK_TICKS_PER_US 1000.0
+#elif defined(__XTENSA__)
+typedef uint32_t BenchmarkTicks;
+inline BenchmarkTicks benchmarkTicks() {
+    uint32_t cycles;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(cycles));
+    return cycles;
+}
+#define ENHANCED_UNITY_BENCHMARK_CYCLE_COUNTER 1
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+typedef uint32_t BenchmarkTicks;
+inline BenchmarkTicks benchmarkTicks() {
+    volatile uint32_t* const demcr = (volatile uint32_t*)0xE000EDFCu;
+    volatile uint32_t* const dwtControl = (volatile uint32_t*)0xE0001000u;
+    volatile uint32_t* const dwtCycles = (volatile uint32_t*)0xE0001004u;
+    if ((*dwtControl & 1u) == 0) {
+        *demcr |= (1u << 24);  // TRCENA
+        *dwtControl |= 1u;     // CYCCNTENA
+    }
+    return *dwtCycles;
+}
+#define ENHANCED_UNITY_BENCHMARK_CYCLE_COUNTER 1
+#else
+typedef uint32_t BenchmarkTicks;
+inline BenchmarkTicks benchmarkTicks() { return (BenchmarkTicks)micros(); }
+#define ENHANCED_UNITY_BENCHMARK_TICKS_PER_US 1.0
+#endif
+
+#ifdef ENHANCED_UNITY_BENCHMARK_CYCLE_COUNTER
+inline double measureTicksPerMicrosecond() {
+    TimeMicros startMicros = nowMicros();
+    while (nowMicros() == startMicros) {
+    }
+    startMicros = nowMicros();
+    BenchmarkTicks startTicks = benchmarkTicks();
+    TimeMicros elapsed = 0;
+    while ((elapsed = nowMicros() - startMicros) < ENHANCED_UNITY_BENCHMARK_CALIBRATION_US) {
+    }
+    return (double)(BenchmarkTicks)(benchmarkTicks() - startTicks) / (double)elapsed;
+}
+
+inline double ticksPerMicrosecond() {
+    static const double rate = measureTicksPerMicrosecond();
+    return rate;
+}
+#else
+inline double ticksPerMicrosecond() { return ENHANCED_UNITY_BENCHMARK_TICKS_PER_US; }
+#endif
+
+// Keep a computed value alive without emitting any code for it
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+struct BenchmarkResult {
+    uint32_t iterations;  // per sample
+    int samples;
+    double minNanos;      // per operation
+    double medianNanos;
+    double p99Nanos;
+};
+
+inline BenchmarkTicks timeBenchmarkLoop(void (*loop)(uint32_t), uint32_t iterations) {
+    BenchmarkTicks start = benchmarkTicks();
+    loop(iterations);
+    return (BenchmarkTicks)(benchmarkTicks() - start);
+}
+
+inline uint32_t scaleIterations(uint32_t iterations, double elapsed, double ticksPerSample) {
+    double scaled = elapsed > 0 ? iterations * (ticksPerSample / elapsed) : iterations;
+    if (scaled < 1) {
+        return 1;
+    }
+    return scaled > 4e9 ? 0xFFFFFFFFu : (uint32_t)scaled;
+}
+
+// Iterations for one sample of about ENHANCED_UNITY_BENCHMARK_SAMPLE_US: double
+// until a run is long enough to extrapolate, then re-measure once at the
+// extrapolated count so a single disturbed short run cannot skew it
+inline uint32_t calibrateIterations(void (*loop)(uint32_t), double ticksPerSample) {
+    uint32_t iterations = 1;
+    double elapsed = 0;
+    for (;;) {
+        elapsed = (double)timeBenchmarkLoop(loop, iterations);
+        if (elapsed >= ticksPerSample / 16 || iterations >= 0x40000000u) {
+            break;
+        }
+        iterations *= 2;
+    }
+    iterations = scaleIterations(iterations, elapsed, ticksPerSample);
+    elapsed = (double)timeBenchmarkLoop(loop, iterations);
+    return scaleIterations(iterations, elapsed, ticksPerSample);
+}
+
+// Run `loop` (which repeats the operation n times) and collect per-op statistics
+inline BenchmarkResult runBenchmark(void (*loop)(uint32_t)) {
+    // Millions of timed iterations would otherwise each count their assertions
+    QuietAssertions quiet;
+    ShardRewind counts;
+    double ticksPerMicro = ticksPerMicrosecond();
+    BenchmarkResult result;
+    result.iterations = calibrateIterations(loop, ENHANCED_UNITY_BENCHMARK_SAMPLE_US * ticksPerMicro);
+    result.samples = ENHANCED_UNITY_BENCHMARK_SAMPLES;
+
+    double samples[ENHANCED_UNITY_BENCHMARK_SAMPLES];
+    for (int i = 0; i < ENHANCED_UNITY_BENCHMARK_SAMPLES; i++) {
+        double ticks = (double)timeBenchmarkLoop(loop, result.iterations);
+        samples[i] = ticks * 1000.0 / ticksPerMicro / result.iterations;
+    }
+    for (int i = 1; i < ENHANCED_UNITY_BENCHMARK_SAMPLES; i++) {
+        double sample = samples[i];
+        int j = i;
+        for (; j > 0 && samples[j - 1] > sample; j--) {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = sample;
+    }
+    result.minNanos = samples[0];
+    result.medianNanos = samples[ENHANCED_UNITY_BENCHMARK_SAMPLES / 2];
+    result.p99Nanos = samples[(ENHANCED_UNITY_BENCHMARK_SAMPLES * 99 + 99) / 100 - 1];
+    return result;
+}
+
+// Whole and tenth nanoseconds, for "%lu.%lu ns" (no %f on AVR)
+inline unsigned long wholeNanos(double nanos) { return (unsigned long)(nanos + 0.05); }
+inline unsigned long tenthNanos(double nanos) { return (unsigned long)((nanos + 0.05) * 10) % 10; }
+
+// Body of a registered benchmark test; maxNanos <= 0 means no bound
+inline void runBenchmarkMethod(const char* name, void (*loop)(uint32_t), double maxNanos,
+                               int line, const char* fileName) {
+    BenchmarkResult result = runBenchmark(loop);
+#ifdef CONFIGMGR_NATIVE
+    ::enhanced_unity_host::noteBenchmarkResult(result.medianNanos);
+#endif
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+        ENHANCED_UNITY_PRINT("    [BENCH] %" ENHANCED_UNITY_FLASH_S ": %lu ops x %d samples, "
+                             "min %lu.%lu ns, median %lu.%lu ns, p99 %lu.%lu ns\n",
+                             name, (unsigned long)result.iterations, result.samples,
+                             wholeNanos(result.minNanos), tenthNanos(result.minNanos),
+                             wholeNanos(result.medianNanos), tenthNanos(result.medianNanos),
+                             wholeNanos(result.p99Nanos), tenthNanos(result.p99Nanos));
+    }
+    if (maxNanos <= 0) {
+        return;
+    }
+    countAssertion();
+    if (result.medianNanos > maxNanos) {
+        countAssertionFailure();
+        if (recordsFailures()) {
+            recordInt(ASSERT_BENCHMARK_MAX_NS, false, line, fileName,
+                      (int32_t)maxNanos, (int32_t)wholeNanos(result.medianNanos));
+        }
+    }
+}
+
+} // namespace enhanced_unity
+
+// Register a benchmark whose median must not exceed maxNanosPerOp
+#define ENHANCED_UNITY_BENCHMARK_MAX_NS(benchName, maxNanosPerOp) \
+    static void benchName##_benchmarkOperation(); \
+    static void benchName##_benchmarkLoop(uint32_t iterations) { \
+        while (iterations-- > 0) { \
+            benchName##_benchmarkOperation(); \
+        } \
+    } \
+    ENHANCED_UNITY_TEST_TAGGED(benchName, "benchmark,exclusive") { \
+        ::enhanced_unity::runBenchmarkMethod(ENHANCED_UNITY_FLASH(#benchName), benchName##_benchmarkLoop, \
+                                             (maxNanosPerOp), __LINE__, ENHANCED_UNITY_SITE_FILE); \
+    } \
+    static void benchName##_benchmarkOperation()
+
+// Register a benchmark; the body is one operation
+#define ENHANCED_UNITY_BENCHMARK(benchName) ENHANCED_UNITY_BENCHMARK_MAX_NS(benchName, 0)
+
+// Keep a result the benchmark body computes from being optimized away
+#define ENHANCED_UNITY_DO_NOT_OPTIMIZE(value) ::enhanced_unity::doNotOptimize(value)
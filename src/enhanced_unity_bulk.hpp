@@ -0,0 +1,144 @@
+#pragma once
+
+// ============================================================================
+// BULK ASSERTION SCOPES
+// ============================================================================
+// ENHANCED_UNITY_BULK_SCOPE(name, maxReported) opens a scope that lasts to
+// the end of the enclosing block. Assertions inside it run as usual but are
+// reported sparingly, for loops that check thousands of values:
+//
+//   - passes are never recorded, whatever the verbosity
+//   - the first maxReported failures are recorded where they happen
+//   - later failures are reservoir-sampled: ENHANCED_UNITY_BULK_SAMPLES of
+//     them, chosen uniformly, are recorded when the scope closes
+//   - the scope then counts as one assertion of the method, recorded as
+//     ENHANCED_UNITY_BULK_SCOPE(name, checks, passed) when it failed
+//
+// Inner checks count on the calling thread's counter shard, which the scope
+// rewinds when it closes, so the pass path is the plain assertion path. A
+// scope belongs to its thread, may nest (an inner scope is one check of the
+// outer one) and must close within the test method that opened it.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Later failures kept as a uniform sample per scope
+#ifndef ENHANCED_UNITY_BULK_SAMPLES
+#ifdef __AVR__
+#define ENHANCED_UNITY_BULK_SAMPLES 2
+#else
+#define ENHANCED_UNITY_BULK_SAMPLES 8
+#endif
+#endif
+
+namespace enhanced_unity {
+
+class BulkScope {
+public:
+    BulkScope(const char* name, int maxReported, int line, const char* fileName, bool recordPasses)
+        : name_(name), maxReported_(maxReported > 0 ? maxReported : 0), line_(line), fileName_(fileName),
+          recordPasses_(recordPasses), shard_(&localShard()), enclosing_(threadBulkState().scope) {
+        startAssertions_ = shard_->assertions.get();
+        startFailures_ = shard_->assertionFailures.get();
+        // Seeded from the name: the same failures give the same sample
+        random_ = 0x811c9dc5UL;
+        for (const char* c = name != nullptr ? name : ""; *c != '\0'; c++) {
+            random_ = (random_ ^ (uint8_t)*c) * 0x01000193UL;
+        }
+        if (random_ == 0) {
+            random_ = 1;
+        }
+        threadBulkState().scope = this;
+    }
+
+    // Roll the inner checks up into one assertion
+    ~BulkScope() {
+        BulkState& bulk = threadBulkState();
+        bulk.scope = enclosing_;
+        bulk.sampleSlot = nullptr;
+        int checks = shard_->assertions.get() - startAssertions_;
+        int failed = shard_->assertionFailures.get() - startFailures_;
+        shard_->assertions.rewind(startAssertions_);
+        shard_->assertionFailures.rewind(startFailures_);
+        if (sampled_ > 0) {
+            recordSamples();
+        }
+        bool passed = failed == 0;
+        if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses_))) {
+            recordValidation(ASSERT_BULK_SCOPE, passed, line_, fileName_, name_, checks, checks - failed);
+        }
+    }
+
+    BulkScope(const BulkScope&) = delete;
+    BulkScope& operator=(const BulkScope&) = delete;
+
+    // True if the failure just counted is to be recorded; a sampled one is
+    // steered into its sample slot (Algorithm R)
+    bool admitFailure() {
+        BulkState& bulk = threadBulkState();
+        bulk.sampleSlot = nullptr;
+        if (!recordsFailures()) {
+            return false;
+        }
+        failures_++;
+        if (failures_ <= (uint32_t)maxReported_) {
+            return true;
+        }
+        uint32_t later = failures_ - (uint32_t)maxReported_;
+        uint32_t slot = later <= ENHANCED_UNITY_BULK_SAMPLES ? later - 1 : nextRandom() % later;
+        if (slot >= ENHANCED_UNITY_BULK_SAMPLES) {
+            return false;
+        }
+        bulk.sampleSlot = &samples_[slot];
+        if ((int)slot >= sampled_) {
+            sampled_ = (int)slot + 1;
+        }
+        return true;
+    }
+
+private:
+    // xorshift32
+    uint32_t nextRandom() {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 17;
+        random_ ^= random_ << 5;
+        return random_;
+    }
+
+    ENHANCED_UNITY_COLD void recordSamples() {
+        RecordBuffer& buffer = counters().recordBuffer();
+        SpinLockGuard guard(buffer.lock);
+        for (int i = 0; i < sampled_; i++) {
+            AssertRecord* record = reserveRecord(buffer, samples_[i].kind, false, samples_[i].line, nullptr);
+            if (record != nullptr) {
+                *record = samples_[i];
+            }
+        }
+    }
+
+    const char* name_;
+    int maxReported_;
+    int line_;
+    const char* fileName_;
+    bool recordPasses_;
+    CounterShard* shard_;
+    BulkScope* enclosing_;
+    int startAssertions_;
+    int startFailures_;
+    uint32_t failures_ = 0;  // failures while records were kept
+    uint32_t random_;
+    int sampled_ = 0;
+    AssertRecord samples_[ENHANCED_UNITY_BULK_SAMPLES];
+};
+
+inline bool admitBulkFailure(BulkScope& scope) { return scope.admitFailure(); }
+
+} // namespace enhanced_unity
+
+#define ENHANCED_UNITY_BULK_CONCAT_(a, b) a##b
+#define ENHANCED_UNITY_BULK_CONCAT(a, b) ENHANCED_UNITY_BULK_CONCAT_(a, b)
+
+// Declares the scope object; it closes with the enclosing block
+#define ENHANCED_UNITY_BULK_SCOPE(name, maxReported) \
+    ::enhanced_unity::BulkScope ENHANCED_UNITY_BULK_CONCAT(_enhancedUnityBulkScope, __LINE__)( \
+        (name), (maxReported), __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES)
@@ -0,0 +1,207 @@
+#pragma once
+
+// ============================================================================
+// RESULT CACHE (CONFIGMGR_NATIVE)
+// ============================================================================
+// Incremental runs. A test is cacheable when it has a content key
+// (ENHANCED_UNITY_TEST_KEYED, RUN_TEST_CACHED_DEBUG), a run-wide key
+// (--cache-key=KEY or ENHANCED_UNITY_CACHE_KEY), or both. The cache is
+// looked up by the test's identity (source file and name). If the last result
+// recorded for that identity with the same key was a pass, the test does not
+// run: it is printed as [CACHED] and counted in the summary's cache line.
+// Otherwise the test runs and its result is appended to the cache.
+//
+// The cache file is a text log with one "<identity> <key> pass|fail file:name"
+// line per result; the last line for an identity wins. Each line is appended
+// with a single flushed write, so forked pool workers and parallel workers
+// share the file. Closing the cache rewrites it with one line per test.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace enhanced_unity_host {
+
+class ResultCache {
+public:
+    ResultCache() = default;
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // The log is only compacted by close(): a worker process that exit()s
+    // must not rewrite the file under its parent
+    ~ResultCache() {
+        if (log_ != nullptr) {
+            fclose(log_);
+        }
+    }
+
+    // Load `path` (a missing file is an empty cache) and append results to
+    // it; false if it cannot be written
+    bool open(const char* path, const char* runKey) {
+        close();
+        path_ = path;
+        runKey_ = runKey != nullptr ? runKey : "";
+        load();
+        log_ = fopen(path, "a");
+        if (log_ == nullptr) {
+            ::enhanced_unity::print("cannot write result cache %s\n", path);
+            return false;
+        }
+        return true;
+    }
+
+    // Rewrite the file with the latest result per test and stop caching
+    void close() {
+        if (log_ == nullptr) {
+            return;
+        }
+        fclose(log_);
+        log_ = nullptr;
+        load();  // includes results appended by pool workers
+        std::string temporary = path_ + ".tmp";
+        FILE* file = fopen(temporary.c_str(), "w");
+        bool written = file != nullptr && fputs("# enhanced_unity result cache v1\n", file) >= 0;
+        for (const auto& item : entries_) {
+            written = written && writeEntry(file, item.first, item.second);
+        }
+        if (file != nullptr) {
+            written = fclose(file) == 0 && written;
+        }
+        if (!written || rename(temporary.c_str(), path_.c_str()) != 0) {
+            remove(temporary.c_str());
+        }
+        entries_.clear();
+        armed_.clear();
+    }
+
+    bool isOpen() const { return log_ != nullptr; }
+
+    // True if the test passed last time with the same key: it has been
+    // counted as cached and must not run. Otherwise the test is armed and
+    // runTest appends its result. Call from the thread that queues tests,
+    // never while a parallel batch is running
+    bool skip(const char* name, const char* fileName, int lineNumber, void (*function)(), const char* contentKey) {
+        if (log_ == nullptr || (runKey_.empty() && (contentKey == nullptr || *contentKey == '\0'))) {
+            return false;
+        }
+        if (!::enhanced_unity::inShard(name)) {
+            return false;  // RUN_TEST_DEBUG drops it
+        }
+        using ::enhanced_unity::stableHash;
+        uint64_t identity = stableHash(name, stableHash("\n", stableHash(fileName)));
+        uint64_t key = stableHash(contentKey, stableHash("\n", stableHash(runKey_.c_str())));
+        auto found = entries_.find(identity);
+        if (found != entries_.end() && found->second.key == key && found->second.passed) {
+            ::enhanced_unity::counters().methodCachedCount++;
+            if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+                ::enhanced_unity::print("[CACHED]      - %s (%s:%d)\n", name, fileName, lineNumber);
+            }
+            return true;
+        }
+        Armed& armed = armed_[function];
+        armed.identity = identity;
+        armed.entry.key = key;
+        armed.entry.label = std::string(fileName) + ":" + name;
+        return false;
+    }
+
+    // Failure tally of the calling thread's context; runTest compares the
+    // values before and after a test
+    static int failureMark() {
+        const ::enhanced_unity::CounterContext& c = ::enhanced_unity::counters();
+        return c.rawAssertionFailures() + c.extraFailureCount + c.methodTotalFailureCount;
+    }
+
+    // Append the result of an armed test (any thread or worker process)
+    void finish(void (*function)(), int failureMarkBefore) {
+        if (log_ == nullptr) {
+            return;
+        }
+        auto found = armed_.find(function);
+        if (found == armed_.end()) {
+            return;
+        }
+        Entry entry = found->second.entry;
+        entry.passed = failureMark() == failureMarkBefore;
+        writeEntry(log_, found->second.identity, entry);
+        fflush(log_);
+    }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        bool passed = false;
+        std::string label;
+    };
+
+    struct Armed {
+        uint64_t identity = 0;
+        Entry entry;
+    };
+
+    static bool writeEntry(FILE* file, uint64_t identity, const Entry& entry) {
+        return fprintf(file, "%016llx %016llx %s %s\n", (unsigned long long)identity,
+                       (unsigned long long)entry.key, entry.passed ? "pass" : "fail", entry.label.c_str()) > 0;
+    }
+
+    // Malformed lines (e.g. a torn write after a crash) are ignored
+    void load() {
+        entries_.clear();
+        FILE* file = fopen(path_.c_str(), "r");
+        if (file == nullptr) {
+            return;
+        }
+        char line[1024];
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            unsigned long long identity = 0;
+            unsigned long long key = 0;
+            char result[5] = {};
+            int labelStart = 0;
+            if (line[0] == '#' || sscanf(line, "%16llx %16llx %4s %n", &identity, &key, result, &labelStart) != 3 ||
+                labelStart == 0) {
+                continue;
+            }
+            bool passed = strcmp(result, "pass") == 0;
+            if (!passed && strcmp(result, "fail") != 0) {
+                continue;
+            }
+            Entry& entry = entries_[identity];
+            entry.key = key;
+            entry.passed = passed;
+            entry.label.assign(line + labelStart, strcspn(line + labelStart, "\r\n"));
+        }
+        fclose(file);
+    }
+
+    std::string path_;
+    std::string runKey_;
+    FILE* log_ = nullptr;
+    std::unordered_map<uint64_t, Entry> entries_;
+    std::unordered_map<void (*)(), Armed> armed_;
+};
+
+inline ResultCache& resultCache() {
+    static ResultCache cache;
+    return cache;
+}
+
+} // namespace enhanced_unity_host
+
+// Open/close the result cache around a hand-written runner; `runKey` may be
+// nullptr when every cached test carries its own key
+#define ENHANCED_UNITY_OPEN_RESULT_CACHE(path, runKey) ::enhanced_unity_host::resultCache().open((path), (runKey))
+#define ENHANCED_UNITY_CLOSE_RESULT_CACHE() ::enhanced_unity_host::resultCache().close()
+
+// RUN_TEST_DEBUG unless the test passed last time with the same key
+#undef RUN_TEST_CACHED_DEBUG
+#define RUN_TEST_CACHED_DEBUG(testFunction, contentKey) \
+    do { \
+        if (!::enhanced_unity_host::resultCache().skip(#testFunction, __FILE__, __LINE__, (testFunction), \
+                                                       (contentKey))) { \
+            RUN_TEST_DEBUG(testFunction); \
+        } \
+    } while(0)
@@ -0,0 +1,446 @@
+#pragma once
+
+// ============================================================================
+// TIMING HISTORY (CONFIGMGR_NATIVE)
+// ============================================================================
+// An append-only file of past timings, compared against after every run.
+// --history=PATH (or ENHANCED_UNITY_HISTORY) opens it; --history-label=LABEL
+// (or ENHANCED_UNITY_HISTORY_LABEL), typically the commit, tags the records
+// the run appends. Hand-written runners call
+// ENHANCED_UNITY_OPEN_TIMING_HISTORY(path, label) before the tests.
+//
+// Each method contributes its duration in µs, each benchmark its median in
+// ns per operation; a test run several times in one run (stress mode) counts
+// with its median. ENHANCED_UNITY_FINAL_SUMMARY() compares every value with
+// the last ENHANCED_UNITY_HISTORY_WINDOW passing values of the same test and
+// lists a test as slower when it exceeds their median by more than
+// ENHANCED_UNITY_HISTORY_MAD_LIMIT scaled median absolute deviations, by
+// ENHANCED_UNITY_HISTORY_MIN_PERCENT of the median and, for methods, by
+// ENHANCED_UNITY_HISTORY_MIN_MICROS. Slower tests are warnings, or failures
+// with --history-fail (ENHANCED_UNITY_HISTORY_FAIL=1); the comparison runs
+// before the summary, so failures show in it, in the reporters' output and
+// in the run status. The run's records are appended with one write after
+// the summary.
+//
+// The file is a 16-byte header followed by fixed 48-byte records in host
+// byte order (HistoryRecord). It is read backwards in blocks and only until
+// every test of the run has its window, so the cost does not grow with its
+// age. Durations travel as report text, so parallel workers and process pool
+// workers contribute like in-process tests.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Past runs a test is compared with
+#ifndef ENHANCED_UNITY_HISTORY_WINDOW
+#define ENHANCED_UNITY_HISTORY_WINDOW 20
+#endif
+
+// Fewest past runs a comparison is made from
+#ifndef ENHANCED_UNITY_HISTORY_MIN_RUNS
+#define ENHANCED_UNITY_HISTORY_MIN_RUNS 5
+#endif
+
+// Scaled MADs (1.4826 * MAD, a standard deviation for normal noise) above the
+// median a slower value must be
+#ifndef ENHANCED_UNITY_HISTORY_MAD_LIMIT
+#define ENHANCED_UNITY_HISTORY_MAD_LIMIT 4
+#endif
+
+// Smallest slowdown reported, in percent of the median
+#ifndef ENHANCED_UNITY_HISTORY_MIN_PERCENT
+#define ENHANCED_UNITY_HISTORY_MIN_PERCENT 10
+#endif
+
+// Smallest method slowdown reported, in µs
+#ifndef ENHANCED_UNITY_HISTORY_MIN_MICROS
+#define ENHANCED_UNITY_HISTORY_MIN_MICROS 100
+#endif
+
+// 1 = slower tests count as failures; ENHANCED_UNITY_HISTORY_FAIL in the
+// environment overrides it
+#ifndef ENHANCED_UNITY_HISTORY_FAIL
+#define ENHANCED_UNITY_HISTORY_FAIL 0
+#endif
+
+// Records read per block
+#ifndef ENHANCED_UNITY_HISTORY_BLOCK
+#define ENHANCED_UNITY_HISTORY_BLOCK 1024
+#endif
+
+namespace enhanced_unity_host {
+
+enum HistoryKind : uint32_t {
+    HISTORY_METHOD = 1,     // value: method duration in µs
+    HISTORY_BENCHMARK = 2,  // value: median ns per operation
+};
+
+static const uint32_t kHistoryFailed = 1;  // HistoryRecord::flags: not a baseline
+
+struct HistoryRecord {
+    uint64_t id;         // stableHash of file and name, as in the result cache
+    int64_t timestamp;   // seconds since the epoch
+    double value;
+    uint32_t kind;       // HistoryKind
+    uint32_t flags;
+    char label[16];      // run label, truncated and NUL-padded
+};
+
+static_assert(sizeof(HistoryRecord) == 48, "history records are 48 bytes");
+
+struct HistoryHeader {
+    char magic[8];  // "EUHIST1"
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+static const char kHistoryMagic[8] = { 'E', 'U', 'H', 'I', 'S', 'T', '1', '\0' };
+
+// Median ns/op of the benchmark the calling thread just measured; the
+// history reporter takes it at method end
+inline double& threadBenchmarkNanos() {
+    static thread_local double nanos = 0.0;
+    return nanos;
+}
+
+inline void noteBenchmarkResult(double medianNanos) { threadBenchmarkNanos() = medianNanos; }
+
+inline double medianOf(std::vector<double>& values) {
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double median = values[middle];
+    if (values.size() % 2 == 0) {
+        median = (median + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+    }
+    return median;
+}
+
+// Collects the tab-separated "kind value failed file name" lines written by
+// HistoryReporter, directly or replayed from workers
+class HistorySink : public ::enhanced_unity::OutputSink {
+public:
+    struct Sample {
+        uint64_t id;
+        uint32_t kind;
+        bool failed;
+        std::string name;
+        std::vector<double> values;
+    };
+
+    void write(const char* data, size_t length) override {
+        pending_.append(data, length);
+        size_t start = 0;
+        for (size_t end = pending_.find('\n'); end != std::string::npos; end = pending_.find('\n', start)) {
+            parse(pending_.substr(start, end - start));
+            start = end + 1;
+        }
+        pending_.erase(0, start);
+    }
+
+    std::vector<Sample>& samples() { return samples_; }
+
+    void clear() {
+        pending_.clear();
+        samples_.clear();
+        index_.clear();
+    }
+
+private:
+    void parse(const std::string& line) {
+        size_t fields[4];  // starts of value, failed, file and name
+        size_t at = 0;
+        for (size_t& field : fields) {
+            at = line.find('\t', at);
+            if (at == std::string::npos) {
+                return;  // malformed
+            }
+            field = ++at;
+        }
+        char kind = line[0];
+        double value = strtod(line.c_str() + fields[0], nullptr);
+        bool failed = line[fields[1]] == '1';
+        std::string fileName = line.substr(fields[2], fields[3] - 1 - fields[2]);
+        std::string name = line.substr(fields[3]);
+        using ::enhanced_unity::stableHash;
+        uint64_t id = stableHash(name.c_str(), stableHash("\n", stableHash(fileName.c_str())));
+        auto found = index_.find(id);
+        if (found == index_.end()) {
+            found = index_.emplace(id, samples_.size()).first;
+            Sample fresh = { id, kind == 'B' ? (uint32_t)HISTORY_BENCHMARK : (uint32_t)HISTORY_METHOD, false, name, {} };
+            samples_.push_back(fresh);
+        }
+        Sample& sample = samples_[found->second];
+        sample.failed = sample.failed || failed;
+        sample.values.push_back(value);
+    }
+
+    std::string pending_;
+    std::vector<Sample> samples_;
+    std::unordered_map<uint64_t, size_t> index_;
+};
+
+// One line per finished method; benchmarks report their ns/op instead
+class HistoryReporter : public ::enhanced_unity::ResultReporter {
+public:
+    explicit HistoryReporter(::enhanced_unity::OutputSink& sink) : ResultReporter(sink) {}
+
+    void endMethod(const ::enhanced_unity::MethodEvent& event) override {
+        double nanos = threadBenchmarkNanos();
+        threadBenchmarkNanos() = 0.0;
+        bool failed = event.failures > 0 || event.abortReason != nullptr;
+        std::string line(nanos > 0.0 ? "B\t" : "M\t");
+        char number[48];
+        snprintf(number, sizeof(number), "%.17g\t%d\t", nanos > 0.0 ? nanos : (double)event.micros, failed ? 1 : 0);
+        line += number;
+        line += event.fileName != nullptr ? event.fileName : "";
+        line += '\t';
+        line += event.methodName;
+        line += '\n';
+        emit(line.data(), line.size());
+    }
+};
+
+class TimingHistory {
+public:
+    TimingHistory() : reporter_(sink_) {
+        const char* fail = getenv("ENHANCED_UNITY_HISTORY_FAIL");
+        failOnSlower = fail != nullptr && *fail != '\0' ? atoi(fail) != 0 : ENHANCED_UNITY_HISTORY_FAIL != 0;
+    }
+    TimingHistory(const TimingHistory&) = delete;
+    TimingHistory& operator=(const TimingHistory&) = delete;
+
+    // Check `path` (a missing file starts a new history) and collect this
+    // run's timings; false if it is not a history file or the reporter
+    // cannot be attached
+    bool open(const char* path, const char* label) {
+        path_ = path;
+        label_ = label != nullptr ? label : "";
+        FILE* file = fopen(path, "rb");
+        if (file != nullptr) {
+            HistoryHeader header;
+            size_t read = fread(&header, 1, sizeof(header), file);
+            fclose(file);
+            if (read != 0 && (read != sizeof(header) || memcmp(header.magic, kHistoryMagic, sizeof(kHistoryMagic)) != 0 ||
+                              header.recordSize != sizeof(HistoryRecord))) {
+                ::enhanced_unity::print("%s is not a timing history file\n", path);
+                path_.clear();
+                return false;
+            }
+        }
+        sink_.clear();
+        if (!ENHANCED_UNITY_ADD_REPORTER(&reporter_)) {
+            ::enhanced_unity::print("cannot attach the timing history: reporter list full\n");
+            path_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return !path_.empty(); }
+
+    // Compare the run with its history and pass the slower tests to the
+    // reporters; with failOnSlower each adds a failure to the run. Called by
+    // ENHANCED_UNITY_FINAL_SUMMARY() before the summary
+    void compare() {
+        if (!isOpen() || compared_ >= 0) {
+            return;
+        }
+        std::vector<HistorySink::Sample>& samples = sink_.samples();
+        std::unordered_map<uint64_t, Baseline> baselines;
+        for (HistorySink::Sample& sample : samples) {
+            Baseline& baseline = baselines[sample.id];
+            baseline.kind = sample.kind;
+        }
+        loadBaselines(baselines);
+
+        compared_ = 0;
+        slower_.clear();
+        for (HistorySink::Sample& sample : samples) {
+            double current = medianOf(sample.values);
+            sample.values.assign(1, current);
+            Baseline& baseline = baselines[sample.id];
+            if (sample.failed || baseline.values.size() < ENHANCED_UNITY_HISTORY_MIN_RUNS) {
+                continue;
+            }
+            compared_++;
+            double median = medianOf(baseline.values);
+            std::vector<double> deviations;
+            for (double value : baseline.values) {
+                deviations.push_back(std::fabs(value - median));
+            }
+            double mad = medianOf(deviations);
+            double margin = std::max(ENHANCED_UNITY_HISTORY_MAD_LIMIT * 1.4826 * mad,
+                                     median * ENHANCED_UNITY_HISTORY_MIN_PERCENT / 100.0);
+            if (sample.kind == HISTORY_METHOD) {
+                margin = std::max(margin, (double)ENHANCED_UNITY_HISTORY_MIN_MICROS);
+            }
+            if (current <= median + margin) {
+                continue;
+            }
+            Slower entry = { sample.name, sample.kind == HISTORY_BENCHMARK, current, median, mad,
+                             (int)baseline.values.size() };
+            slower_.push_back(entry);
+            char detail[160];
+            describe(entry, false, detail, sizeof(detail));
+            ::enhanced_unity::HistoryEvent event = { sample.name.c_str(), detail, failOnSlower };
+            ::enhanced_unity::notifySlowerTest(event);
+        }
+        if (failOnSlower) {
+            ::enhanced_unity::CounterContext& c = ::enhanced_unity::counters();
+            c.historyFailureCount += (int)slower_.size();
+            c.extraFailureCount += (int)slower_.size();
+        }
+    }
+
+    // Print the slower tests and append the run; called by
+    // ENHANCED_UNITY_FINAL_SUMMARY() after the summary
+    void finish() {
+        if (!isOpen()) {
+            return;
+        }
+        compare();
+        std::vector<HistorySink::Sample>& samples = sink_.samples();
+        ::enhanced_unity::print("=== Timing history: %d test(s), %d compared, %d slower | %s\n",
+                                (int)samples.size(), compared_, (int)slower_.size(), path_.c_str());
+        for (const Slower& entry : slower_) {
+            char detail[160];
+            describe(entry, true, detail, sizeof(detail));
+            ::enhanced_unity::print("  [%s] %-32s %s\n", failOnSlower ? "FAILED" : "SLOWER", entry.name.c_str(), detail);
+        }
+        ::enhanced_unity::print("=======================================================\n");
+        append(samples);
+        sink_.clear();
+        slower_.clear();
+        compared_ = -1;
+        path_.clear();
+    }
+
+    bool failOnSlower;
+
+private:
+    struct Baseline {
+        uint32_t kind = 0;
+        std::vector<double> values;  // most recent first
+    };
+
+    struct Slower {
+        std::string name;
+        bool benchmark;
+        double current;
+        double median;
+        double mad;
+        int runs;
+    };
+
+    // "5.091 ms vs median 2.080 ms (MAD 0.014, +145%, 20 runs)"; `aligned`
+    // pads the values for the console table
+    static void describe(const Slower& entry, bool aligned, char* text, size_t size) {
+        double scale = entry.benchmark ? 1.0 : 1000.0;
+        const char* unit = entry.benchmark ? "ns/op" : "ms";
+        int width = aligned ? 10 : 0;
+        snprintf(text, size, "%*.3f %s vs median %*.3f %s (MAD %.3f, %+.0f%%, %d runs)", width,
+                 entry.current / scale, unit, width, entry.median / scale, unit, entry.mad / scale,
+                 entry.median > 0.0 ? 100.0 * (entry.current - entry.median) / entry.median : 100.0, entry.runs);
+    }
+
+    // Newest records first, block by block from the end; stops once every
+    // test has a full window. A torn last record is ignored.
+    void loadBaselines(std::unordered_map<uint64_t, Baseline>& baselines) {
+        FILE* file = fopen(path_.c_str(), "rb");
+        if (file == nullptr) {
+            return;
+        }
+        long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+        long records = size > (long)sizeof(HistoryHeader) ? (size - (long)sizeof(HistoryHeader)) / (long)sizeof(HistoryRecord)
+                                                          : 0;
+        size_t open = baselines.size();
+        std::vector<HistoryRecord> block(ENHANCED_UNITY_HISTORY_BLOCK);
+        while (records > 0 && open > 0) {
+            long count = std::min(records, (long)block.size());
+            records -= count;
+            if (fseek(file, (long)sizeof(HistoryHeader) + records * (long)sizeof(HistoryRecord), SEEK_SET) != 0 ||
+                fread(block.data(), sizeof(HistoryRecord), (size_t)count, file) != (size_t)count) {
+                break;
+            }
+            for (long i = count - 1; i >= 0 && open > 0; i--) {
+                const HistoryRecord& record = block[(size_t)i];
+                auto found = baselines.find(record.id);
+                if (found == baselines.end() || (record.flags & kHistoryFailed) != 0 ||
+                    record.kind != found->second.kind ||
+                    found->second.values.size() >= ENHANCED_UNITY_HISTORY_WINDOW) {
+                    continue;
+                }
+                found->second.values.push_back(record.value);
+                if (found->second.values.size() == ENHANCED_UNITY_HISTORY_WINDOW) {
+                    open--;
+                }
+            }
+        }
+        fclose(file);
+    }
+
+    // The header when the file is new, padding after a torn record, then
+    // the run's records in one write
+    void append(const std::vector<HistorySink::Sample>& samples) {
+        FILE* file = fopen(path_.c_str(), "ab");
+        if (file == nullptr) {
+            ::enhanced_unity::print("cannot write timing history %s\n", path_.c_str());
+            return;
+        }
+        std::string data;
+        long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : 0;
+        if (size <= 0) {
+            HistoryHeader header = {};
+            memcpy(header.magic, kHistoryMagic, sizeof(kHistoryMagic));
+            header.version = 1;
+            header.recordSize = sizeof(HistoryRecord);
+            data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        } else {
+            long torn = (size - (long)sizeof(HistoryHeader)) % (long)sizeof(HistoryRecord);
+            if (torn > 0) {
+                data.append((size_t)((long)sizeof(HistoryRecord) - torn), '\0');
+            }
+        }
+        int64_t now = (int64_t)time(nullptr);
+        for (const HistorySink::Sample& sample : samples) {
+            HistoryRecord record = {};
+            record.id = sample.id;
+            record.timestamp = now;
+            record.value = sample.values.empty() ? 0.0 : sample.values[0];
+            record.kind = sample.kind;
+            record.flags = sample.failed ? kHistoryFailed : 0;
+            memcpy(record.label, label_.data(), std::min(label_.size(), sizeof(record.label)));
+            data.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (fclose(file) != 0 || !written) {
+            ::enhanced_unity::print("cannot write timing history %s\n", path_.c_str());
+        }
+    }
+
+    HistorySink sink_;
+    HistoryReporter reporter_;
+    std::string path_;
+    std::string label_;
+    std::vector<Slower> slower_;
+    int compared_ = -1;  // tests compared by compare(); -1 until it has run
+};
+
+inline TimingHistory& timingHistory() {
+    static TimingHistory history;
+    return history;
+}
+
+} // namespace enhanced_unity_host
+
+// Compare this run with the history at `path` and append it, tagged with
+// `label` (e.g. the commit); false if the file cannot be used
+#define ENHANCED_UNITY_OPEN_TIMING_HISTORY(path, label) ::enhanced_unity_host::timingHistory().open((path), (label))
@@ -0,0 +1,311 @@
+#pragma once
+
+// ============================================================================
+// OUTPUT SINKS
+// ============================================================================
+// print() formats straight into one write-combining buffer; the buffer is
+// handed to the current OutputSink when it fills and at every method, file
+// and summary boundary (and when a method aborts), so a verbose run costs a
+// few large writes instead of one stdio call per line.
+//
+// Backends: StdoutSink (native and non-Arduino), SerialSink (Arduino),
+// FileSink (native), RingBufferSink (last N bytes in memory) and TeeSink
+// (fan out to several). The default is SerialSink on Arduino and StdoutSink
+// elsewhere; on native a non-null ENHANCED_UNITY_LOG_FILE also copies the
+// report to that file. ENHANCED_UNITY_SET_OUTPUT(&sink) replaces it.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Bytes collected before the sink is written
+#ifndef ENHANCED_UNITY_OUTPUT_BUFFER
+#if defined(__AVR__)
+#define ENHANCED_UNITY_OUTPUT_BUFFER 64
+#elif defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_OUTPUT_BUFFER 16384
+#else
+#define ENHANCED_UNITY_OUTPUT_BUFFER 512
+#endif
+#endif
+
+// Sinks one TeeSink can fan out to
+#ifndef ENHANCED_UNITY_TEE_SINKS
+#define ENHANCED_UNITY_TEE_SINKS 4
+#endif
+
+#ifdef CONFIGMGR_NATIVE
+#include <cstdlib>
+#include <string>
+#endif
+
+namespace enhanced_unity {
+
+inline void flushOutput(bool toDevice);
+
+class OutputSink {
+public:
+    virtual ~OutputSink() {}
+    virtual void write(const char* data, size_t length) = 0;
+    // Push written bytes to the device (called on abort and at the summary)
+    virtual void flush() {}
+};
+
+class StdoutSink : public OutputSink {
+public:
+    void write(const char* data, size_t length) override {
+        // One fwrite per buffer; stdio passes a block this size straight to write()
+        fwrite(data, 1, length, stdout);
+        fflush(stdout);
+    }
+    void flush() override { fflush(stdout); }
+};
+
+#ifdef ARDUINO
+class SerialSink : public OutputSink {
+public:
+    void write(const char* data, size_t length) override {
+        Serial.write(reinterpret_cast<const uint8_t*>(data), length);
+    }
+    void flush() override { Serial.flush(); }
+};
+#endif
+
+#ifdef CONFIGMGR_NATIVE
+class FileSink : public OutputSink {
+public:
+    explicit FileSink(const char* path) : file_(path != nullptr ? fopen(path, "w") : nullptr) {}
+    ~FileSink() override {
+        if (file_ != nullptr) {
+            fclose(file_);
+        }
+    }
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    bool isOpen() const { return file_ != nullptr; }
+    void write(const char* data, size_t length) override {
+        if (file_ != nullptr) {
+            fwrite(data, 1, length, file_);
+        }
+    }
+    void flush() override {
+        if (file_ != nullptr) {
+            fflush(file_);
+        }
+    }
+
+private:
+    FILE* file_;
+};
+#endif
+
+// Keeps the last Capacity bytes written; older output is overwritten
+template <size_t Capacity>
+class RingBufferSink : public OutputSink {
+public:
+    void write(const char* data, size_t length) override {
+        for (size_t i = 0; i < length; i++) {
+            data_[(start_ + size_) % Capacity] = data[i];
+            if (size_ < Capacity) {
+                size_++;
+            } else {
+                start_ = (start_ + 1) % Capacity;
+            }
+        }
+    }
+
+    size_t size() const { return size_; }
+    void clear() { start_ = size_ = 0; }
+
+    // Copy the kept bytes, oldest first, as a C string; returns the length copied
+    size_t copyTo(char* out, size_t outSize) const {
+        if (outSize == 0) {
+            return 0;
+        }
+        size_t skip = size_ >= outSize ? size_ - (outSize - 1) : 0;
+        size_t length = size_ - skip;
+        for (size_t i = 0; i < length; i++) {
+            out[i] = data_[(start_ + skip + i) % Capacity];
+        }
+        out[length] = '\0';
+        return length;
+    }
+
+private:
+    char data_[Capacity];
+    size_t start_ = 0;
+    size_t size_ = 0;
+};
+
+class TeeSink : public OutputSink {
+public:
+    // False when all ENHANCED_UNITY_TEE_SINKS slots are taken
+    bool add(OutputSink* sink) {
+        if (sink == nullptr || count_ >= ENHANCED_UNITY_TEE_SINKS) {
+            return false;
+        }
+        sinks_[count_++] = sink;
+        return true;
+    }
+    void write(const char* data, size_t length) override {
+        for (int i = 0; i < count_; i++) {
+            sinks_[i]->write(data, length);
+        }
+    }
+    void flush() override {
+        for (int i = 0; i < count_; i++) {
+            sinks_[i]->flush();
+        }
+    }
+
+private:
+    OutputSink* sinks_[ENHANCED_UNITY_TEE_SINKS];
+    int count_ = 0;
+};
+
+inline OutputSink& defaultOutputSink() {
+#ifdef ARDUINO
+    static SerialSink sink;
+    return sink;
+#elif defined(CONFIGMGR_NATIVE)
+    static StdoutSink standardOutput;
+    static FileSink logFile(ENHANCED_UNITY_LOG_FILE);
+    static TeeSink tee;
+    static OutputSink* sink = nullptr;
+    if (sink == nullptr) {
+        // Text still buffered when main() returns is written on the way out
+        atexit([]() { flushOutput(true); });
+        sink = &standardOutput;
+        if (logFile.isOpen()) {
+            tee.add(&standardOutput);
+            tee.add(&logFile);
+            sink = &tee;
+        }
+    }
+    return *sink;
+#else
+    static StdoutSink sink;
+    return sink;
+#endif
+}
+
+// The write-combining buffer in front of the current sink
+struct OutputBuffer {
+    char data[ENHANCED_UNITY_OUTPUT_BUFFER];
+    size_t length = 0;
+    OutputSink* sink = nullptr;  // nullptr = defaultOutputSink()
+    SpinLock lock;
+};
+
+} // namespace enhanced_unity
+
+extern enhanced_unity::OutputBuffer _enhancedUnityOutput;
+
+namespace enhanced_unity {
+
+inline OutputSink& outputSink() {
+    return _enhancedUnityOutput.sink != nullptr ? *_enhancedUnityOutput.sink : defaultOutputSink();
+}
+
+#if ENHANCED_UNITY_WIRE_PROTOCOL
+inline void writeTextFrame(const char* data, size_t length);
+#endif
+
+// Report text to the sink; framed as text records on the wire protocol
+inline void writeToSink(const char* data, size_t length) {
+#if ENHANCED_UNITY_WIRE_PROTOCOL
+    writeTextFrame(data, length);
+#else
+    outputSink().write(data, length);
+#endif
+}
+
+// Callers hold the buffer's lock
+inline void drainOutput(OutputBuffer& buffer) {
+    if (buffer.length > 0) {
+        writeToSink(buffer.data, buffer.length);
+        buffer.length = 0;
+    }
+}
+
+// Hand buffered text to the sink; toDevice also flushes the sink itself
+inline void flushOutput(bool toDevice = false) {
+    OutputBuffer& buffer = _enhancedUnityOutput;
+    SpinLockGuard guard(buffer.lock);
+    drainOutput(buffer);
+    if (toDevice) {
+        outputSink().flush();
+    }
+}
+
+// Route output to `sink` (nullptr = default); pending text goes to the old sink
+inline void setOutputSink(OutputSink* sink) {
+    flushOutput(true);
+    OutputBuffer& buffer = _enhancedUnityOutput;
+    SpinLockGuard guard(buffer.lock);
+    buffer.sink = sink;
+}
+
+inline void writeOutput(const char* data, size_t length) {
+    OutputBuffer& buffer = _enhancedUnityOutput;
+    SpinLockGuard guard(buffer.lock);
+    while (length > 0) {
+        if (buffer.length == sizeof(buffer.data)) {
+            drainOutput(buffer);
+        }
+        size_t chunk = sizeof(buffer.data) - buffer.length;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(buffer.data + buffer.length, data, chunk);
+        buffer.length += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+typedef int (*OutputFormatter)(char*, size_t, const char*, va_list);
+
+// Format in place at the end of the buffer; a line that does not fit drains
+// the buffer and is formatted again. Longer lines than the buffer go to the
+// sink on their own (native) or are cut to the buffer size.
+inline void writeFormatted(OutputFormatter formatter, const char* format, va_list args) {
+    OutputBuffer& buffer = _enhancedUnityOutput;
+    SpinLockGuard guard(buffer.lock);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t room = sizeof(buffer.data) - buffer.length;
+        va_list copy;
+        va_copy(copy, args);
+        int length = formatter(buffer.data + buffer.length, room, format, copy);
+        va_end(copy);
+        if (length < 0) {
+            return;
+        }
+        if ((size_t)length < room) {
+            buffer.length += (size_t)length;
+            return;
+        }
+        if (buffer.length == 0) {
+#ifdef CONFIGMGR_NATIVE
+            std::string line((size_t)length + 1, '\0');
+            va_list again;
+            va_copy(again, args);
+            formatter(&line[0], line.size(), format, again);
+            va_end(again);
+            writeToSink(line.data(), (size_t)length);
+#else
+            buffer.length = sizeof(buffer.data) - 1;
+#endif
+            return;
+        }
+        drainOutput(buffer);
+    }
+}
+
+} // namespace enhanced_unity
+
+// Send report output to `sink` (an enhanced_unity::OutputSink*; nullptr restores the default)
+#define ENHANCED_UNITY_SET_OUTPUT(sink) ::enhanced_unity::setOutputSink(sink)
+
+// Write out everything buffered so far, down to the device
+#define ENHANCED_UNITY_FLUSH_OUTPUT() ::enhanced_unity::flushOutput(true)
@@ -0,0 +1,204 @@
+#pragma once
+
+// ============================================================================
+// PARALLEL TEST RUNNER (CONFIGMGR_NATIVE)
+// ============================================================================
+// Queued tests run on a work-stealing thread pool. Every worker owns a
+// CounterContext and record buffer, so method state and counters never mix
+// between tests; each test's output is captured and the blocks are printed in
+// submission order once the batch finishes (report text of attached result
+// reporters too). Tests queued as exclusive act as barriers: everything queued
+// before them completes, then they run alone on the calling thread. A test with
+// a deadline runs under the watchdog on whichever worker picks it up.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker count; 0 = std::thread::hardware_concurrency().
+// The ENHANCED_UNITY_THREADS environment variable overrides it at run time.
+#ifndef ENHANCED_UNITY_PARALLEL_THREADS
+#define ENHANCED_UNITY_PARALLEL_THREADS 0
+#endif
+
+namespace enhanced_unity_host {
+
+struct QueuedTest {
+    const char* name;
+    void (*function)();
+    bool exclusive;
+    const char* fileName;
+    int lineNumber;
+};
+
+// Owner pops from the back, idle workers steal from the front
+class WorkStealingQueue {
+public:
+    void push(size_t index) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        items_.push_back(index);
+    }
+
+    bool pop(size_t& index) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        index = items_.back();
+        items_.pop_back();
+        return true;
+    }
+
+    bool steal(size_t& index) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        index = items_.front();
+        items_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<size_t> items_;
+};
+
+inline unsigned parallelThreadCount() {
+    const char* fromEnvironment = getenv("ENHANCED_UNITY_THREADS");
+    if (fromEnvironment != nullptr && atoi(fromEnvironment) > 0) {
+        return (unsigned)atoi(fromEnvironment);
+    }
+    if (ENHANCED_UNITY_PARALLEL_THREADS > 0) {
+        return ENHANCED_UNITY_PARALLEL_THREADS;
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+class ParallelRunner {
+public:
+    void add(const char* name, void (*function)(), bool exclusive, const char* fileName = nullptr,
+             int lineNumber = 0) {
+        if (!::enhanced_unity::inShard(name)) {
+            return;
+        }
+        tests_.push_back(QueuedTest{name, function, exclusive, fileName, lineNumber});
+    }
+
+    bool empty() const { return tests_.empty(); }
+
+    // Run everything queued so far; results are merged into the caller's context
+    void run(unsigned threadCount = 0) {
+        std::vector<QueuedTest> tests;
+        tests.swap(tests_);
+        if (threadCount == 0) {
+            threadCount = parallelThreadCount();
+        }
+        size_t batchStart = 0;
+        for (size_t i = 0; i <= tests.size(); i++) {
+            if (i < tests.size() && !tests[i].exclusive) {
+                continue;
+            }
+            runBatch(tests, batchStart, i, threadCount);
+            if (i < tests.size()) {
+                runTest(tests[i].name, tests[i].function, tests[i].fileName, tests[i].lineNumber);
+            }
+            batchStart = i + 1;
+        }
+    }
+
+private:
+    struct Worker {
+        ::enhanced_unity::CounterContext counters;
+        ::enhanced_unity::RecordBuffer records;
+        WorkStealingQueue queue;
+    };
+
+    static void runWorker(std::vector<std::unique_ptr<Worker>>& workers, size_t self,
+                          const std::vector<QueuedTest>& tests,
+                          std::vector<::enhanced_unity::OutputCapture>& outputs) {
+        Worker& worker = *workers[self];
+        ::enhanced_unity::ScopedCounterContext scope(worker.counters);
+        onParallelWorker = true;
+        for (;;) {
+            size_t index = 0;
+            bool found = worker.queue.pop(index);
+            for (size_t k = 1; !found && k < workers.size(); k++) {
+                found = workers[(self + k) % workers.size()]->queue.steal(index);
+            }
+            if (!found) {
+                // Nothing is ever queued after start, so empty queues mean done
+                return;
+            }
+            ::enhanced_unity::threadOutputCapture() = &outputs[index];
+            runTest(tests[index].name, tests[index].function, tests[index].fileName, tests[index].lineNumber);
+            ::enhanced_unity::threadOutputCapture() = nullptr;
+        }
+    }
+
+    static void runBatch(const std::vector<QueuedTest>& tests, size_t begin, size_t end, unsigned threadCount) {
+        if (begin >= end) {
+            return;
+        }
+        size_t workerCount = threadCount < end - begin ? threadCount : end - begin;
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (size_t w = 0; w < workerCount; w++) {
+            workers.emplace_back(new Worker());
+            workers.back()->counters.setRecordBuffer(&workers.back()->records);
+        }
+        for (size_t i = begin; i < end; i++) {
+            workers[(i - begin) % workerCount]->queue.push(i);
+        }
+
+        std::vector<::enhanced_unity::OutputCapture> outputs(tests.size());
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < workerCount; w++) {
+            threads.emplace_back(runWorker, std::ref(workers), w, std::cref(tests), std::ref(outputs));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            ::enhanced_unity::print("%s", outputs[i].text.c_str());
+            ::enhanced_unity::replayReports(outputs[i]);
+        }
+        ::enhanced_unity::CounterContext& counters = ::enhanced_unity::counters();
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            counters.absorb(worker->counters.snapshot());
+        }
+    }
+
+    std::vector<QueuedTest> tests_;
+};
+
+inline ParallelRunner& parallelRunner() {
+    static ParallelRunner runner;
+    return runner;
+}
+
+} // namespace enhanced_unity_host
+
+// Queue a test for the pool; it runs at the next ENHANCED_UNITY_RUN_QUEUED_TESTS(),
+// ENHANCED_UNITY_END_TEST_FILE() or ENHANCED_UNITY_FINAL_SUMMARY()
+#define RUN_TEST_PARALLEL_DEBUG(testFunction) \
+    ::enhanced_unity_host::parallelRunner().add(#testFunction, (testFunction), false, __FILE__, __LINE__)
+
+// Queue a test that must not overlap with any other test
+#define RUN_TEST_EXCLUSIVE_DEBUG(testFunction) \
+    ::enhanced_unity_host::parallelRunner().add(#testFunction, (testFunction), true, __FILE__, __LINE__)
+
+#define ENHANCED_UNITY_RUN_QUEUED_TESTS() ::enhanced_unity_host::parallelRunner().run()
+
+// ENHANCED_UNITY_PARALLEL turns every RUN_TEST_DEBUG into a queued parallel test
+#ifdef ENHANCED_UNITY_PARALLEL
+#undef RUN_TEST_DEBUG
+#define RUN_TEST_DEBUG(testFunction) RUN_TEST_PARALLEL_DEBUG(testFunction)
+#endif
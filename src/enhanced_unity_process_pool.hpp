@@ -0,0 +1,467 @@
+#pragma once
+
+// ============================================================================
+// CRASH-ISOLATING PROCESS POOL (CONFIGMGR_NATIVE, POSIX)
+// ============================================================================
+// Queued tests run in forked worker processes. The parent hands out test
+// indices over a pipe; a worker runs the test with its own counter context,
+// then streams back a fixed binary header (counter snapshot) followed by the
+// captured output and the text of each attached result reporter. A worker that
+// dies mid-test (segfault, abort(), exit()) is reaped, the test is recorded as
+// [ABORTED] through recordAbortedMethod, and a fresh worker takes its place. A
+// worker still busy past the test's deadline is killed the same way and the
+// test booked as timed out. Output is printed in submission order.
+//
+// In-process tests with a deadline (RUN_TEST_DEBUG, registered tests) get a
+// one-test pool of their own, so an overrun is killed rather than abandoned.
+//
+// fork() only clones the calling thread: queue and run from a single-threaded
+// point of the program (no parallel runner batch in flight).
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Worker process count; 0 = one per core.
+// The ENHANCED_UNITY_PROCESSES environment variable overrides it at run time.
+#ifndef ENHANCED_UNITY_PROCESS_POOL_WORKERS
+#define ENHANCED_UNITY_PROCESS_POOL_WORKERS 0
+#endif
+
+namespace enhanced_unity_host {
+
+struct IsolatedTest {
+    const char* name;
+    void (*function)();
+    const char* fileName;
+    int lineNumber;
+    uint32_t timeoutMillis;  // 0 = none
+    bool once;               // one iteration of runTest, which drives any repeats
+};
+
+// Worker -> parent message; followed by outputLength bytes of report text,
+// then reportLengths[i] bytes for each attached result reporter
+struct ProcessResultHeader {
+    uint32_t magic;
+    uint32_t testIndex;
+    uint32_t outputLength;
+    uint32_t reportLengths[ENHANCED_UNITY_MAX_REPORTERS];
+    ::enhanced_unity::CounterSnapshot counters;
+};
+
+static const uint32_t kProcessResultMagic = 0x32525545;  // "EUR2"
+
+inline bool writeAll(int fd, const void* data, size_t length) {
+    const char* bytes = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// False on EOF or error before `length` bytes arrived
+inline bool readAll(int fd, void* data, size_t length) {
+    char* bytes = static_cast<char*>(data);
+    while (length > 0) {
+        ssize_t received = read(fd, bytes, length);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        length -= (size_t)received;
+    }
+    return true;
+}
+
+inline unsigned processPoolWorkerCount() {
+    const char* fromEnvironment = getenv("ENHANCED_UNITY_PROCESSES");
+    if (fromEnvironment != nullptr && atoi(fromEnvironment) > 0) {
+        return (unsigned)atoi(fromEnvironment);
+    }
+    if (ENHANCED_UNITY_PROCESS_POOL_WORKERS > 0) {
+        return ENHANCED_UNITY_PROCESS_POOL_WORKERS;
+    }
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (unsigned)cores : 1;
+}
+
+class ProcessPool {
+public:
+    void add(const char* name, void (*function)(), const char* fileName, int lineNumber) {
+        if (!::enhanced_unity::inShard(name)) {
+            return;
+        }
+        tests_.push_back(
+            IsolatedTest{name, function, fileName, lineNumber, ::enhanced_unity::testTimeout(function), false});
+    }
+
+    // Queue a test as given, already past the shard filter
+    void add(const IsolatedTest& test) { tests_.push_back(test); }
+
+    bool empty() const { return tests_.empty(); }
+
+    // Run everything queued so far; results are merged into the caller's context
+    void run(unsigned workerCount = 0) {
+        if (tests_.empty()) {
+            return;
+        }
+        std::vector<IsolatedTest> tests;
+        tests.swap(tests_);
+        if (workerCount == 0) {
+            workerCount = processPoolWorkerCount();
+        }
+        if (workerCount > tests.size()) {
+            workerCount = (unsigned)tests.size();
+        }
+
+        void (*previousPipeHandler)(int) = signal(SIGPIPE, SIG_IGN);
+        std::vector<::enhanced_unity::OutputCapture> outputs(tests.size());
+        std::vector<Worker> workers(workerCount);
+        size_t nextTest = 0;
+        size_t completed = 0;
+
+        for (Worker& worker : workers) {
+            if (spawn(worker, workers, tests)) {
+                dispatch(worker, nextTest, tests.size());
+            }
+        }
+
+        while (completed < tests.size()) {
+            std::vector<pollfd> fds;
+            std::vector<Worker*> polled;
+            for (Worker& worker : workers) {
+                if (worker.busy) {
+                    fds.push_back(pollfd{worker.resultFd, POLLIN, 0});
+                    polled.push_back(&worker);
+                }
+            }
+            if (fds.empty()) {
+                // Workers could not be started; run the rest in-process
+                for (; nextTest < tests.size(); nextTest++, completed++) {
+                    const IsolatedTest& test = tests[nextTest];
+                    if (test.once) {
+                        runTestWithDeadline(test.name, test.function, test.fileName, test.lineNumber,
+                                            test.timeoutMillis);
+                    } else {
+                        runTest(test.name, test.function, test.fileName, test.lineNumber);
+                    }
+                }
+                break;
+            }
+            if (poll(fds.data(), fds.size(), pollTimeout(polled, tests)) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            ::enhanced_unity::TimeMicros now = ::enhanced_unity::nowMicros();
+            for (size_t i = 0; i < fds.size(); i++) {
+                Worker& worker = *polled[i];
+                size_t index = worker.testIndex;
+                if (fds[i].revents != 0) {
+                    if (!receive(worker, outputs[index])) {
+                        recordCrash(worker, tests[index], outputs[index]);
+                    }
+                } else if (overdue(worker, tests[index], now)) {
+                    recordHang(worker, tests[index], outputs[index]);
+                } else {
+                    continue;
+                }
+                if (worker.pid <= 0 && nextTest < tests.size()) {
+                    spawn(worker, workers, tests);
+                }
+                worker.busy = false;
+                completed++;
+                if (worker.pid > 0) {
+                    dispatch(worker, nextTest, tests.size());
+                }
+            }
+        }
+
+        for (Worker& worker : workers) {
+            reap(worker, false);
+        }
+        signal(SIGPIPE, previousPipeHandler);
+
+        for (const ::enhanced_unity::OutputCapture& output : outputs) {
+            ::enhanced_unity::print("%s", output.text.c_str());
+            ::enhanced_unity::replayReports(output);
+        }
+    }
+
+private:
+    struct Worker {
+        pid_t pid = -1;
+        int commandFd = -1;
+        int resultFd = -1;
+        bool busy = false;
+        size_t testIndex = 0;
+        ::enhanced_unity::TimeMicros dispatchMicros = 0;
+    };
+
+    static void workerMain(int commandFd, int resultFd, const std::vector<IsolatedTest>& tests) {
+        inProcessWorker = true;
+        ::enhanced_unity::CounterContext counters;
+        ::enhanced_unity::RecordBuffer records;
+        counters.setRecordBuffer(&records);
+        ::enhanced_unity::ScopedCounterContext scope(counters);
+        uint32_t index = 0;
+        while (readAll(commandFd, &index, sizeof(index)) && index < tests.size()) {
+            counters.reset();
+            ::enhanced_unity::OutputCapture capture;
+            ::enhanced_unity::threadOutputCapture() = &capture;
+            const IsolatedTest& test = tests[index];
+            if (test.once) {
+                runTestOnce(test.name, test.function, test.fileName, test.lineNumber);
+            } else {
+                runTest(test.name, test.function);
+            }
+            ::enhanced_unity::threadOutputCapture() = nullptr;
+
+            ProcessResultHeader header;
+            memset(&header, 0, sizeof(header));
+            header.magic = kProcessResultMagic;
+            header.testIndex = index;
+            header.outputLength = (uint32_t)capture.text.size();
+            for (int i = 0; i < ENHANCED_UNITY_MAX_REPORTERS; i++) {
+                header.reportLengths[i] = (uint32_t)capture.reports[i].size();
+            }
+            header.counters = counters.snapshot();
+            if (!writeAll(resultFd, &header, sizeof(header)) ||
+                !writeAll(resultFd, capture.text.data(), capture.text.size())) {
+                break;
+            }
+            bool written = true;
+            for (int i = 0; i < ENHANCED_UNITY_MAX_REPORTERS && written; i++) {
+                written = writeAll(resultFd, capture.reports[i].data(), capture.reports[i].size());
+            }
+            if (!written) {
+                break;
+            }
+        }
+    }
+
+    static bool spawn(Worker& worker, std::vector<Worker>& workers, const std::vector<IsolatedTest>& tests) {
+        int command[2];
+        int result[2];
+        if (pipe(command) != 0) {
+            return false;
+        }
+        if (pipe(result) != 0) {
+            close(command[0]);
+            close(command[1]);
+            return false;
+        }
+        // Anything still buffered would otherwise be written by parent and child
+        ::enhanced_unity::flushOutput(true);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(command[0]);
+            close(command[1]);
+            close(result[0]);
+            close(result[1]);
+            return false;
+        }
+        if (pid == 0) {
+            // Drop the parent's ends of the other workers' pipes, or they never see EOF
+            for (Worker& other : workers) {
+                if (other.pid > 0) {
+                    close(other.commandFd);
+                    close(other.resultFd);
+                }
+            }
+            close(command[1]);
+            close(result[0]);
+            signal(SIGPIPE, SIG_DFL);
+            workerMain(command[0], result[1], tests);
+            ::enhanced_unity::flushOutput(true);
+            _exit(0);
+        }
+        close(command[0]);
+        close(result[1]);
+        worker.pid = pid;
+        worker.commandFd = command[1];
+        worker.resultFd = result[0];
+        worker.busy = false;
+        return true;
+    }
+
+    static void dispatch(Worker& worker, size_t& nextTest, size_t testCount) {
+        if (nextTest >= testCount) {
+            return;
+        }
+        uint32_t index = (uint32_t)nextTest;
+        if (!writeAll(worker.commandFd, &index, sizeof(index))) {
+            return;
+        }
+        worker.testIndex = nextTest++;
+        worker.dispatchMicros = ::enhanced_unity::nowMicros();
+        worker.busy = true;
+    }
+
+    static bool receive(Worker& worker, ::enhanced_unity::OutputCapture& output) {
+        ProcessResultHeader header;
+        if (!readAll(worker.resultFd, &header, sizeof(header)) ||
+            header.magic != kProcessResultMagic || header.testIndex != worker.testIndex) {
+            return false;
+        }
+        if (!receiveText(worker.resultFd, output.text, header.outputLength)) {
+            return false;
+        }
+        for (int i = 0; i < ENHANCED_UNITY_MAX_REPORTERS; i++) {
+            if (!receiveText(worker.resultFd, output.reports[i], header.reportLengths[i])) {
+                return false;
+            }
+        }
+        ::enhanced_unity::counters().absorb(header.counters);
+        return true;
+    }
+
+    // Read `length` bytes into text; cleared on failure
+    static bool receiveText(int fd, std::string& text, uint32_t length) {
+        text.resize(length);
+        if (length > 0 && !readAll(fd, &text[0], length)) {
+            text.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Close the pipes (EOF tells an idle worker to exit) and collect the status
+    static int reap(Worker& worker, bool forceKill) {
+        int status = 0;
+        if (worker.pid <= 0) {
+            return status;
+        }
+        if (forceKill) {
+            kill(worker.pid, SIGKILL);
+        }
+        close(worker.commandFd);
+        close(worker.resultFd);
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        worker.pid = -1;
+        worker.commandFd = -1;
+        worker.resultFd = -1;
+        worker.busy = false;
+        return status;
+    }
+
+    static bool overdue(const Worker& worker, const IsolatedTest& test, ::enhanced_unity::TimeMicros now) {
+        return test.timeoutMillis > 0 &&
+               now - worker.dispatchMicros >= (::enhanced_unity::TimeMicros)test.timeoutMillis * 1000;
+    }
+
+    // Milliseconds until the nearest deadline of a busy worker; -1 = none
+    static int pollTimeout(const std::vector<Worker*>& busy, const std::vector<IsolatedTest>& tests) {
+        ::enhanced_unity::TimeMicros now = ::enhanced_unity::nowMicros();
+        int timeout = -1;
+        for (const Worker* worker : busy) {
+            const IsolatedTest& test = tests[worker->testIndex];
+            if (test.timeoutMillis == 0) {
+                continue;
+            }
+            ::enhanced_unity::TimeMicros deadline =
+                worker->dispatchMicros + (::enhanced_unity::TimeMicros)test.timeoutMillis * 1000;
+            ::enhanced_unity::TimeMicros left = deadline > now ? (deadline - now + 999) / 1000 : 0;
+            int millis = left < 0x7fffffff ? (int)left : 0x7fffffff;
+            if (timeout < 0 || millis < timeout) {
+                timeout = millis;
+            }
+        }
+        return timeout;
+    }
+
+    // Kill the worker stuck on a test past its deadline and book the test
+    static void recordHang(Worker& worker, const IsolatedTest& test, ::enhanced_unity::OutputCapture& output) {
+        reap(worker, true);
+        output = ::enhanced_unity::OutputCapture();
+        ::enhanced_unity::OutputCapture* previous = ::enhanced_unity::threadOutputCapture();
+        ::enhanced_unity::threadOutputCapture() = &output;
+        recordTimeout(test.name, test.fileName, test.lineNumber, worker.dispatchMicros, test.timeoutMillis);
+        ::enhanced_unity::threadOutputCapture() = previous;
+    }
+
+    // Book the test the dead worker was running as an aborted method
+    static void recordCrash(Worker& worker, const IsolatedTest& test, ::enhanced_unity::OutputCapture& output) {
+        // A garbled message from a live worker is treated like a crash too
+        int status = reap(worker, true);
+
+        char reason[96];
+        if (WIFSIGNALED(status)) {
+            snprintf(reason, sizeof(reason), "worker crashed: signal %d (%s)",
+                     WTERMSIG(status), strsignal(WTERMSIG(status)));
+        } else if (WIFEXITED(status)) {
+            snprintf(reason, sizeof(reason), "worker exited with status %d", WEXITSTATUS(status));
+        } else {
+            snprintf(reason, sizeof(reason), "worker lost");
+        }
+
+        // A partial message may have left text behind
+        output = ::enhanced_unity::OutputCapture();
+        ::enhanced_unity::OutputCapture* previous = ::enhanced_unity::threadOutputCapture();
+        ::enhanced_unity::threadOutputCapture() = &output;
+        if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+            ::enhanced_unity::print("[RUN] %s\n", test.name);
+        }
+        beginMethod(test.name, test.fileName, test.lineNumber);
+        ::enhanced_unity::startMethodCounters(test.name, test.fileName);
+        // Charge the time the worker spent on the test before it died
+        ::enhanced_unity::counters().methodStartMicros = worker.dispatchMicros;
+        recordAbortedMethod(reason, true);
+        ::enhanced_unity::threadOutputCapture() = previous;
+    }
+
+    std::vector<IsolatedTest> tests_;
+};
+
+inline ProcessPool& processPool() {
+    static ProcessPool pool;
+    return pool;
+}
+
+inline void runTestForked(const char* testName, void (*function)(), const char* fileName, int lineNumber,
+                          uint32_t limitMillis) {
+    ProcessPool pool;
+    pool.add(IsolatedTest{testName, function, fileName, lineNumber, limitMillis, true});
+    pool.run(1);
+}
+
+} // namespace enhanced_unity_host
+
+// Queue a test to run in a forked worker; it runs at the next
+// ENHANCED_UNITY_RUN_ISOLATED_TESTS(), ENHANCED_UNITY_END_TEST_FILE() or
+// ENHANCED_UNITY_FINAL_SUMMARY()
+#define RUN_TEST_ISOLATED_DEBUG(testFunction) \
+    ::enhanced_unity_host::processPool().add(#testFunction, (testFunction), __FILE__, __LINE__)
+
+#define ENHANCED_UNITY_RUN_ISOLATED_TESTS() ::enhanced_unity_host::processPool().run()
+
+// ENHANCED_UNITY_PROCESS_POOL turns every RUN_TEST_DEBUG into an isolated test
+#ifdef ENHANCED_UNITY_PROCESS_POOL
+#undef RUN_TEST_DEBUG
+#define RUN_TEST_DEBUG(testFunction) RUN_TEST_ISOLATED_DEBUG(testFunction)
+#endif
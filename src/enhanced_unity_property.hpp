@@ -0,0 +1,627 @@
+#pragma once
+
+// ============================================================================
+// PROPERTY-BASED TESTS
+// ============================================================================
+// TEST_ASSERT_PROPERTY_DEBUG(property, cases) runs `property` against
+// `cases` generated inputs and counts as one assertion. A property is a
+// function taking an enhanced_unity::PropertyInput& that draws its inputs
+// and checks them with the usual *_DEBUG assertions:
+//
+//   static void reverse_twice(enhanced_unity::PropertyInput& input) {
+//       char text[33];
+//       size_t length = input.text(text, 0, 32);
+//       ...
+//       TEST_ASSERT_EQUAL_STRING_DEBUG(text, twice);
+//   }
+//
+// Generators map choices to values: each draw takes one 64-bit choice from
+// a seeded SplitMix64 stream and records it on a tape. A case fails when one
+// of its assertions fails (or, on native, it throws). The first failing case
+// is shrunk by editing its tape: chunks of choices are deleted, then each
+// choice is zeroed or binary-searched down, keeping any edit that still
+// fails and is simpler (shorter, then smaller). Choice 0 is every
+// generator's simplest value: 0 or the bound nearest it, an empty buffer,
+// the alphabet's first character. The shrunk case is then run once more with
+// its failures recorded as usual, under a note naming the seed.
+//
+// Cases run quietly: their assertions only count on the thread's shard,
+// which is rewound after each case, so a property of 100000 cases costs its
+// assertions and nothing else. On thread-safe native builds the cases are
+// spread over ENHANCED_UNITY_PROPERTY_THREADS threads, so properties must
+// not share mutable state; the failing case reported is always the first in
+// case order, whatever the thread timing.
+//
+// Seeds: each run draws one seed (ENHANCED_UNITY_PROPERTY_SEED, or on native
+// the ENHANCED_UNITY_SEED environment variable / --seed=N; otherwise from
+// the clock), and each property mixes in its name. Rerunning with the
+// reported seed replays the same cases.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Run seed; 0 = a new one per run, from the clock
+#ifndef ENHANCED_UNITY_PROPERTY_SEED
+#define ENHANCED_UNITY_PROPERTY_SEED 0
+#endif
+
+// Cases of TEST_ASSERT_PROPERTY_DEBUG(property, 0)
+#ifndef ENHANCED_UNITY_PROPERTY_CASES
+#ifdef CONFIGMGR_NATIVE
+#define ENHANCED_UNITY_PROPERTY_CASES 10000
+#else
+#define ENHANCED_UNITY_PROPERTY_CASES 100
+#endif
+#endif
+
+// Choices one case may draw; draws beyond it are not replayed (they read 0)
+#ifndef ENHANCED_UNITY_PROPERTY_CHOICES
+#if defined(__AVR__)
+#define ENHANCED_UNITY_PROPERTY_CHOICES 16
+#elif defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_PROPERTY_CHOICES 4096
+#else
+#define ENHANCED_UNITY_PROPERTY_CHOICES 256
+#endif
+#endif
+
+// Property runs spent shrinking one counterexample
+#ifndef ENHANCED_UNITY_PROPERTY_SHRINKS
+#ifdef CONFIGMGR_NATIVE
+#define ENHANCED_UNITY_PROPERTY_SHRINKS 20000
+#else
+#define ENHANCED_UNITY_PROPERTY_SHRINKS 500
+#endif
+#endif
+
+// Case threads on thread-safe native builds; 0 = hardware_concurrency().
+// The ENHANCED_UNITY_PROPERTY_THREADS environment variable overrides it.
+#ifndef ENHANCED_UNITY_PROPERTY_THREADS
+#define ENHANCED_UNITY_PROPERTY_THREADS 0
+#endif
+
+// Cases a thread claims at a time
+#ifndef ENHANCED_UNITY_PROPERTY_CHUNK
+#define ENHANCED_UNITY_PROPERTY_CHUNK 256
+#endif
+
+#if ENHANCED_UNITY_THREAD_SAFE && defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_PROPERTY_PARALLEL 1
+#else
+#define ENHANCED_UNITY_PROPERTY_PARALLEL 0
+#endif
+
+#ifdef CONFIGMGR_NATIVE
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#endif
+#if ENHANCED_UNITY_PROPERTY_PARALLEL
+#include <thread>
+#include <vector>
+#endif
+
+namespace enhanced_unity {
+
+// SplitMix64 step: advances `state` and returns the next output
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t initialPropertySeed() {
+#ifdef CONFIGMGR_NATIVE
+    const char* text = getenv("ENHANCED_UNITY_SEED");
+    if (text != nullptr && *text != '\0') {
+        return (uint64_t)strtoull(text, nullptr, 0);
+    }
+#endif
+    if (ENHANCED_UNITY_PROPERTY_SEED != 0) {
+        return (uint64_t)ENHANCED_UNITY_PROPERTY_SEED;
+    }
+    uint64_t clock = (uint64_t)nowMicros();
+    return splitMix64(clock);
+}
+
+// Seed of the run; ENHANCED_UNITY_SET_PROPERTY_SEED() replaces it
+inline uint64_t& propertyRunSeed() {
+    static uint64_t seed = initialPropertySeed();
+    return seed;
+}
+
+// Seed of one property: the run seed mixed with the property's name
+inline uint64_t propertySeed(const char* name) {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+    for (; name != nullptr && *name != '\0'; name++) {
+        hash = (hash ^ (uint8_t)*name) * 0x100000001b3ULL;
+    }
+    uint64_t state = propertyRunSeed() ^ hash;
+    return splitMix64(state);
+}
+
+// Generator seed of case `index`; cases are independent of run order
+inline uint64_t propertyCaseSeed(uint64_t seed, uint64_t index) {
+    uint64_t state = seed + index * 0xd1b54a32d192ed03ULL;
+    return splitMix64(state);
+}
+
+// Choices drawn by one case
+struct PropertyTape {
+    uint64_t choices[ENHANCED_UNITY_PROPERTY_CHOICES];
+    int length;
+};
+
+// Shorter, then lexicographically smaller
+inline bool simplerTape(const PropertyTape& a, const PropertyTape& b) {
+    if (a.length != b.length) {
+        return a.length < b.length;
+    }
+    for (int i = 0; i < a.length; i++) {
+        if (a.choices[i] != b.choices[i]) {
+            return a.choices[i] < b.choices[i];
+        }
+    }
+    return false;
+}
+
+inline void copyTape(PropertyTape& destination, const PropertyTape& source) {
+    memcpy(destination.choices, source.choices, (size_t)source.length * sizeof(source.choices[0]));
+    destination.length = source.length;
+}
+
+// The inputs of one case. Every generator consumes one choice per value
+// and maps choice 0 to its simplest value.
+class PropertyInput {
+public:
+    // Draw fresh choices from `seed`, recording them on `tape`
+    void generate(uint64_t seed, PropertyTape& tape) {
+        start(tape, false);
+        random_ = seed;
+    }
+
+    // Read the choices back from `tape`; choices past its end read 0
+    void replay(PropertyTape& tape) { start(tape, true); }
+
+    // Cut the tape to the choices the case actually read. Every drawn value
+    // was written back reduced to its generator's range.
+    void finish() {
+        tape_->length = position_ < ENHANCED_UNITY_PROPERTY_CHOICES ? position_ : ENHANCED_UNITY_PROPERTY_CHOICES;
+    }
+
+    // True if the case drew more choices than the tape holds
+    bool overrun() const { return position_ > ENHANCED_UNITY_PROPERTY_CHOICES; }
+
+    // Next choice in [0, bound); bound 0 = any 64-bit value
+    uint64_t draw(uint64_t bound) {
+        uint64_t value;
+        if (replaying_) {
+            value = position_ < replayLength_ ? tape_->choices[position_] : 0;
+        } else {
+            value = splitMix64(random_);
+        }
+        if (bound != 0 && value >= bound) {
+            value %= bound;
+        }
+        if (position_ < ENHANCED_UNITY_PROPERTY_CHOICES) {
+            tape_->choices[position_] = value;
+        }
+        position_++;
+        return value;
+    }
+
+    // Integer in [low, high], shrinking towards 0 (or the bound nearest it)
+    template <typename T>
+    T integer(T low, T high) {
+        if ((T)-1 < (T)0) {
+            return (T)signedInteger((int64_t)low, (int64_t)high);
+        }
+        return (T)unsignedInteger((uint64_t)low, (uint64_t)high);
+    }
+
+    // Real in [low, high) at double precision, shrinking towards 0 (or the
+    // bound nearest it)
+    template <typename T>
+    T real(T low, T high) {
+        return (T)realValue((double)low, (double)high);
+    }
+
+    bool boolean() { return draw(2) != 0; }
+
+    // Index in [0, count), shrinking towards 0
+    size_t choose(size_t count) { return count > 0 ? (size_t)draw(count) : 0; }
+
+    // Fill `buffer` with [minLength, maxLength] random bytes; returns the length
+    size_t bytes(uint8_t* buffer, size_t minLength, size_t maxLength) {
+        size_t length = (size_t)unsignedInteger(minLength, maxLength);
+        for (size_t i = 0; i < length; i++) {
+            buffer[i] = (uint8_t)draw(256);
+        }
+        return length;
+    }
+
+    // Terminated text of [minLength, maxLength] characters from `alphabet`
+    // (default: printable ASCII, letters first); `buffer` holds maxLength + 1
+    size_t text(char* buffer, size_t minLength, size_t maxLength, const char* alphabet = nullptr) {
+        static const char printable[] ENHANCED_UNITY_FLASH_DATA =
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+        size_t count = alphabet != nullptr ? strlen(alphabet) : sizeof(printable) - 1;
+        size_t length = count > 0 ? (size_t)unsignedInteger(minLength, maxLength) : 0;
+        for (size_t i = 0; i < length; i++) {
+            size_t index = (size_t)draw(count);
+            buffer[i] = alphabet != nullptr ? alphabet[index] : (char)readFlashByte(&printable[index]);
+        }
+        buffer[length] = '\0';
+        return length;
+    }
+
+private:
+    void start(PropertyTape& tape, bool replaying) {
+        tape_ = &tape;
+        replaying_ = replaying;
+        replayLength_ = tape.length;
+        position_ = 0;
+    }
+
+    uint64_t unsignedInteger(uint64_t low, uint64_t high) {
+        if (high <= low) {
+            return low;
+        }
+        return low + draw(high - low + 1);  // full range: bound 0
+    }
+
+    // Choices 1, 2, 3, 4, ... alternate above and below the origin until one
+    // side runs out, then continue on the other
+    int64_t signedInteger(int64_t low, int64_t high) {
+        if (high <= low) {
+            return low;
+        }
+        int64_t origin = low > 0 ? low : high < 0 ? high : 0;
+        uint64_t above = (uint64_t)high - (uint64_t)origin;
+        uint64_t below = (uint64_t)origin - (uint64_t)low;
+        uint64_t choice = draw((uint64_t)high - (uint64_t)low + 1);
+        uint64_t pair = above < below ? above : below;
+        uint64_t step = choice / 2 + (choice & 1);
+        if (step <= pair) {
+            return (choice & 1) != 0 ? (int64_t)((uint64_t)origin + step) : (int64_t)((uint64_t)origin - step);
+        }
+        uint64_t beyond = choice - 2 * pair;
+        return above > below ? (int64_t)((uint64_t)origin + pair + beyond)
+                             : (int64_t)((uint64_t)origin - pair - beyond);
+    }
+
+    // Lowest bit: side of zero; the rest: a 53-bit fraction of that side
+    double realValue(double low, double high) {
+        if (!(high > low)) {
+            return low;
+        }
+        uint64_t choice = draw((uint64_t)1 << 54);
+        double fraction = (double)(choice >> 1) * (1.0 / 9007199254740992.0);  // 2^-53
+        if (low >= 0) {
+            return low + fraction * (high - low);
+        }
+        if (high <= 0) {
+            return high - fraction * (high - low);
+        }
+        return (choice & 1) != 0 ? low * fraction : high * fraction;
+    }
+
+    PropertyTape* tape_ = nullptr;
+    uint64_t random_ = 0;
+    int replayLength_ = 0;
+    int position_ = 0;
+    bool replaying_ = false;
+};
+
+typedef void (*PropertyFunction)(PropertyInput& input);
+
+// Suppresses records on the calling thread for a scope
+class QuietAssertions {
+public:
+    QuietAssertions() : previous_(threadBulkState().quiet) { threadBulkState().quiet = true; }
+    ~QuietAssertions() { threadBulkState().quiet = previous_; }
+    QuietAssertions(const QuietAssertions&) = delete;
+    QuietAssertions& operator=(const QuietAssertions&) = delete;
+private:
+    bool previous_;
+};
+
+// Restores the calling thread's shard to its current counts at scope exit
+class ShardRewind {
+public:
+    ShardRewind() : shard_(&localShard()) {
+        assertions_ = shard_->assertions.get();
+        failures_ = shard_->assertionFailures.get();
+    }
+    ~ShardRewind() {
+        shard_->assertions.rewind(assertions_);
+        shard_->assertionFailures.rewind(failures_);
+    }
+    bool failed() const { return shard_->assertionFailures.get() != failures_; }
+    ShardRewind(const ShardRewind&) = delete;
+    ShardRewind& operator=(const ShardRewind&) = delete;
+private:
+    CounterShard* shard_;
+    int assertions_;
+    int failures_;
+};
+
+// Run one quiet case; true if it failed
+inline bool runPropertyCase(PropertyFunction property, PropertyInput& input) {
+    ShardRewind counts;
+#ifdef CONFIGMGR_NATIVE
+    try {
+        property(input);
+    } catch (...) {
+        return true;
+    }
+#else
+    property(input);
+#endif
+    return counts.failed();
+}
+
+// Index of the first failing case in [0, cases), or `cases`
+inline uint32_t firstFailingCase(PropertyFunction property, uint64_t seed, uint32_t cases,
+                                 PropertyInput& input, PropertyTape& tape) {
+    QuietAssertions quiet;
+    for (uint32_t i = 0; i < cases; i++) {
+        input.generate(propertyCaseSeed(seed, i), tape);
+        if (runPropertyCase(property, input)) {
+            return i;
+        }
+    }
+    return cases;
+}
+
+#if ENHANCED_UNITY_PROPERTY_PARALLEL
+
+inline unsigned propertyThreadCount() {
+    const char* fromEnvironment = getenv("ENHANCED_UNITY_PROPERTY_THREADS");
+    if (fromEnvironment != nullptr && atoi(fromEnvironment) > 0) {
+        return (unsigned)atoi(fromEnvironment);
+    }
+    if (ENHANCED_UNITY_PROPERTY_THREADS > 0) {
+        return ENHANCED_UNITY_PROPERTY_THREADS;
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+// Threads claim chunks of cases; one that finds a failure lowers the bound
+// the others stop at, so the result is the lowest failing index
+inline uint32_t firstFailingCaseParallel(PropertyFunction property, uint64_t seed, uint32_t cases,
+                                         unsigned threads) {
+    std::atomic<uint32_t> next{0};
+    std::atomic<uint32_t> firstFailure{cases};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            QuietAssertions quiet;
+            PropertyInput input;
+            std::unique_ptr<PropertyTape> tape(new PropertyTape());
+            for (;;) {
+                uint32_t start = next.fetch_add(ENHANCED_UNITY_PROPERTY_CHUNK, std::memory_order_relaxed);
+                if (start >= firstFailure.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                for (uint32_t i = start; i < start + ENHANCED_UNITY_PROPERTY_CHUNK; i++) {
+                    if (i >= firstFailure.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    input.generate(propertyCaseSeed(seed, i), *tape);
+                    if (runPropertyCase(property, input)) {
+                        uint32_t known = firstFailure.load(std::memory_order_relaxed);
+                        while (i < known && !firstFailure.compare_exchange_weak(known, i)) {
+                        }
+                        return;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return firstFailure.load();
+}
+
+#endif
+
+// Tape edits that keep the case failing and make it simpler
+class PropertyShrinker {
+public:
+    PropertyShrinker(PropertyFunction property, PropertyInput& input, PropertyTape& best, PropertyTape& candidate)
+        : property_(property), input_(input), best_(best), candidate_(candidate) {}
+
+    void shrink() {
+        QuietAssertions quiet;
+        bool improved = true;
+        while (improved && budget_ > 0) {
+            improved = false;
+            for (int size = 8; size >= 1; size /= 2) {
+                for (int i = 0; i + size <= best_.length && budget_ > 0;) {
+                    copyTape(candidate_, best_);
+                    memmove(&candidate_.choices[i], &candidate_.choices[i + size],
+                            (size_t)(best_.length - i - size) * sizeof(candidate_.choices[0]));
+                    candidate_.length -= size;
+                    if (attempt()) {
+                        improved = true;
+                    } else {
+                        i++;
+                    }
+                }
+            }
+            for (int i = 0; i < best_.length && budget_ > 0; i++) {
+                improved = minimizeChoice(i) || improved;
+            }
+        }
+    }
+
+    int steps() const { return steps_; }
+
+private:
+    // Smallest value of choice `index` that still fails: 0, else a binary
+    // search below the current value
+    bool minimizeChoice(int index) {
+        if (best_.choices[index] == 0) {
+            return false;
+        }
+        if (attemptChoice(index, 0)) {
+            return true;
+        }
+        bool improved = false;
+        uint64_t passing = 0;
+        uint64_t failing = best_.choices[index];
+        while (failing - passing > 1 && budget_ > 0) {
+            uint64_t middle = passing + (failing - passing) / 2;
+            if (attemptChoice(index, middle)) {
+                improved = true;
+                if (index >= best_.length) {
+                    break;
+                }
+                failing = best_.choices[index];
+            } else {
+                passing = middle;
+            }
+        }
+        return improved;
+    }
+
+    bool attemptChoice(int index, uint64_t value) {
+        copyTape(candidate_, best_);
+        candidate_.choices[index] = value;
+        return attempt();
+    }
+
+    // Replay the candidate; keep what it read if it fails and is simpler
+    bool attempt() {
+        budget_--;
+        input_.replay(candidate_);
+        bool failed = runPropertyCase(property_, input_);
+        input_.finish();
+        if (!failed || !simplerTape(candidate_, best_)) {
+            return false;
+        }
+        copyTape(best_, candidate_);
+        steps_++;
+        return true;
+    }
+
+    PropertyFunction property_;
+    PropertyInput& input_;
+    PropertyTape& best_;
+    PropertyTape& candidate_;
+    int budget_ = ENHANCED_UNITY_PROPERTY_SHRINKS;
+    int steps_ = 0;
+};
+
+// Write the property's record: one assertion, `passed` of `cases` cases
+inline void recordProperty(const char* name, uint32_t cases, uint32_t passed, int line, const char* fileName,
+                           bool recordPasses) {
+    bool holds = passed == cases;
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(holds, recordPasses))) {
+        recordValidation(ASSERT_PROPERTY, holds, line, fileName, name, (int32_t)cases, (int32_t)passed);
+    }
+}
+
+// Run the counterexample once more with its records; only the property
+// itself is counted
+inline void replayCounterexample(PropertyFunction property, PropertyInput& input, PropertyTape& tape,
+                                 bool replay, uint64_t caseSeed) {
+    ShardRewind counts;
+    if (replay) {
+        input.replay(tape);
+    } else {
+        input.generate(caseSeed, tape);
+    }
+    property(input);
+}
+
+// Rebuild the failing case on this thread, shrink it, then report it
+ENHANCED_UNITY_COLD inline void reportCounterexample(const char* name, PropertyFunction property, uint64_t seed,
+                                                     uint32_t failing, uint32_t cases, PropertyInput& input,
+                                                     PropertyTape& best, PropertyTape& candidate, int line,
+                                                     const char* fileName, bool recordPasses) {
+    uint64_t caseSeed = propertyCaseSeed(seed, failing);
+    bool reproduced = false;
+    {
+        QuietAssertions quiet;
+        input.generate(caseSeed, best);
+        reproduced = runPropertyCase(property, input);
+        input.finish();
+    }
+    bool shrinkable = reproduced && !input.overrun();
+    int steps = 0;
+    if (shrinkable) {
+        PropertyShrinker shrinker(property, input, best, candidate);
+        shrinker.shrink();
+        steps = shrinker.steps();
+    }
+    flushRecords();  // the note goes before the counterexample's records
+    uint64_t runSeed = propertyRunSeed();
+    ENHANCED_UNITY_PRINT("    [NOTE] property %s falsified after %lu passing case(s), %" ENHANCED_UNITY_FLASH_S
+           " %d step(s); seed 0x%08lx%08lx\n", name, (unsigned long)failing,
+           reproduced ? ENHANCED_UNITY_FLASH("shrunk in") : ENHANCED_UNITY_FLASH("not reproduced on rerun,"),
+           steps, (unsigned long)(uint32_t)(runSeed >> 32), (unsigned long)(uint32_t)runSeed);
+#ifdef CONFIGMGR_NATIVE
+    try {
+        replayCounterexample(property, input, best, shrinkable, caseSeed);
+    } catch (...) {
+        recordProperty(name, cases, failing, line, fileName, recordPasses);
+        throw;  // reported by the test's exception handling
+    }
+#else
+    replayCounterexample(property, input, best, shrinkable, caseSeed);
+#endif
+    recordProperty(name, cases, failing, line, fileName, recordPasses);
+}
+
+// Check `property` on `cases` cases (0 = ENHANCED_UNITY_PROPERTY_CASES); one
+// assertion. A falsified property is shrunk and its counterexample replayed
+// with records.
+inline void checkProperty(const char* name, PropertyFunction property, uint32_t cases, int line,
+                          const char* fileName, bool recordPasses) {
+    if (cases == 0) {
+        cases = ENHANCED_UNITY_PROPERTY_CASES;
+    }
+    uint64_t seed = propertySeed(name);
+    PropertyInput input;
+#ifdef CONFIGMGR_NATIVE
+    std::unique_ptr<PropertyTape> bestStorage(new PropertyTape());
+    std::unique_ptr<PropertyTape> candidateStorage(new PropertyTape());
+    PropertyTape& best = *bestStorage;
+    PropertyTape& candidate = *candidateStorage;
+#else
+    static PropertyTape best;
+    static PropertyTape candidate;
+#endif
+    uint32_t failing = cases;
+#if ENHANCED_UNITY_PROPERTY_PARALLEL
+    unsigned threads = propertyThreadCount();
+    if (threads > 1 && cases > 2 * ENHANCED_UNITY_PROPERTY_CHUNK) {
+        failing = firstFailingCaseParallel(property, seed, cases, threads);
+    } else
+#endif
+    {
+        failing = firstFailingCase(property, seed, cases, input, best);
+    }
+    if (ENHANCED_UNITY_LIKELY(failing == cases)) {
+        recordProperty(name, cases, cases, line, fileName, recordPasses);
+        return;
+    }
+    reportCounterexample(name, property, seed, failing, cases, input, best, candidate, line, fileName, recordPasses);
+}
+
+} // namespace enhanced_unity
+
+// Replace the run seed, e.g. with one reported by a failing property
+#define ENHANCED_UNITY_SET_PROPERTY_SEED(seed) do { ::enhanced_unity::propertyRunSeed() = (uint64_t)(seed); } while(0)
+
+// `property` holds for `cases` generated inputs (0 = ENHANCED_UNITY_PROPERTY_CASES)
+#define TEST_ASSERT_PROPERTY_DEBUG(property, cases) \
+    do { \
+        ::enhanced_unity::checkProperty(#property, (property), (uint32_t)(cases), \
+            __LINE__, ENHANCED_UNITY_SITE_FILE, ENHANCED_UNITY_RECORD_PASSES); \
+    } while(0)
@@ -0,0 +1,542 @@
+#pragma once
+
+// ============================================================================
+// SELF-REGISTERING TESTS
+// ============================================================================
+// ENHANCED_UNITY_TEST(name) { ... } defines a test whose name, file, line and
+// tags live in a constant TestInfo; a two-pointer TestRegistration links it
+// into the registry during static initialization. The generated function
+// wraps the body in ENHANCED_UNITY_START/END_TEST_METHOD, so it can also be
+// passed to RUN_TEST_DEBUG and the native runners by hand.
+//
+// ENHANCED_UNITY_RUN_REGISTERED_TESTS(filter, tags) runs the selected tests,
+// one ENHANCED_UNITY_START/END_TEST_FILE block per source file. On native,
+// ENHANCED_UNITY_MAIN() adds --list, --filter=GLOBS and --tags=TAGS (or the
+// ENHANCED_UNITY_FILTER / ENHANCED_UNITY_TAGS environment variables), and
+// --jsonl=PATH, --junit=PATH and --tap=PATH to write result reports, and
+// --cache=PATH / --cache-key=KEY (or ENHANCED_UNITY_CACHE and
+// ENHANCED_UNITY_CACHE_KEY) to skip tests that passed last time with the same
+// key. ENHANCED_UNITY_TEST_KEYED(name, tags, key) gives a test its own
+// content key, e.g. a build-system hash of its dependencies. --shard=I/N (or
+// ENHANCED_UNITY_SHARD) runs the I-th of N disjoint slices of the suite.
+// --timeout=MS (or ENHANCED_UNITY_TIMEOUT_MS) gives every test a deadline; a
+// "timeout=MS" tag sets one test's own. --seed=N (or ENHANCED_UNITY_SEED)
+// replays the cases of property tests. --repeat=N, --repeat-for=MS and
+// --shuffle[=SEED] run the suite in stress mode (enhanced_unity_stress.hpp).
+// --history=PATH, --history-label=LABEL and --history-fail (or
+// ENHANCED_UNITY_HISTORY, ENHANCED_UNITY_HISTORY_LABEL and
+// ENHANCED_UNITY_HISTORY_FAIL) compare the timings with past runs
+// (enhanced_unity_history.hpp). --rusage-sort=KEY (or
+// ENHANCED_UNITY_RUSAGE_SORT) picks the column that ranks the resource table.
+//
+// Filters and tags are comma-separated lists; '*' and '?' are wildcards and a
+// leading '-' excludes. A test tagged "exclusive" never overlaps other tests
+// when ENHANCED_UNITY_PARALLEL is enabled.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+namespace enhanced_unity {
+
+struct TestInfo {
+    const char* name;
+    const char* fileName;
+    int lineNumber;
+    const char* tags;
+    void (*function)();
+    const char* cacheKey;  // result cache content key; nullptr = run key only
+};
+
+class TestRegistration {
+public:
+    explicit TestRegistration(const TestInfo& info);
+
+    const TestInfo& info;
+    TestRegistration* next = nullptr;
+};
+
+} // namespace enhanced_unity
+
+// Registry list, in registration order (constant-initialized, so safe to use
+// from other static initializers)
+extern enhanced_unity::TestRegistration* _enhancedUnityRegistryHead;
+extern enhanced_unity::TestRegistration* _enhancedUnityRegistryTail;
+
+namespace enhanced_unity {
+
+inline TestRegistration::TestRegistration(const TestInfo& testInfo) : info(testInfo) {
+    if (_enhancedUnityRegistryTail == nullptr) {
+        _enhancedUnityRegistryHead = this;
+    } else {
+        _enhancedUnityRegistryTail->next = this;
+    }
+    _enhancedUnityRegistryTail = this;
+}
+
+// '*' matches any run of characters, '?' any single character
+inline bool globMatch(const char* pattern, const char* patternEnd, const char* text) {
+    const char* starPattern = nullptr;
+    const char* starText = nullptr;
+    while (*text != '\0') {
+        if (pattern < patternEnd && (*pattern == '?' || *pattern == *text)) {
+            pattern++;
+            text++;
+        } else if (pattern < patternEnd && *pattern == '*') {
+            starPattern = ++pattern;
+            starText = text;
+        } else if (starPattern != nullptr) {
+            pattern = starPattern;
+            text = ++starText;
+        } else {
+            return false;
+        }
+    }
+    while (pattern < patternEnd && *pattern == '*') {
+        pattern++;
+    }
+    return pattern == patternEnd;
+}
+
+// True if `word` (length given) is one of the comma-separated entries of `list`
+inline bool listContains(const char* list, const char* word, size_t wordLength) {
+    while (list != nullptr && *list != '\0') {
+        const char* end = strchr(list, ',');
+        size_t length = end != nullptr ? (size_t)(end - list) : strlen(list);
+        if (length == wordLength && strncmp(list, word, wordLength) == 0) {
+            return true;
+        }
+        list = end != nullptr ? end + 1 : nullptr;
+    }
+    return false;
+}
+
+// Apply a comma-separated include/exclude list; `matches` tests one entry
+template <typename Matcher>
+inline bool selectedBy(const char* spec, Matcher matches) {
+    if (spec == nullptr || *spec == '\0') {
+        return true;
+    }
+    bool anyInclude = false;
+    bool included = false;
+    while (spec != nullptr && *spec != '\0') {
+        const char* end = strchr(spec, ',');
+        const char* entryEnd = end != nullptr ? end : spec + strlen(spec);
+        bool exclude = *spec == '-';
+        const char* entry = exclude ? spec + 1 : spec;
+        if (entry < entryEnd) {
+            if (exclude) {
+                if (matches(entry, entryEnd)) {
+                    return false;
+                }
+            } else {
+                anyInclude = true;
+                included = included || matches(entry, entryEnd);
+            }
+        }
+        spec = end != nullptr ? end + 1 : nullptr;
+    }
+    return !anyInclude || included;
+}
+
+inline bool testSelected(const TestInfo& info, const char* filter, const char* tags) {
+    bool nameSelected = selectedBy(filter, [&info](const char* entry, const char* entryEnd) {
+        return globMatch(entry, entryEnd, info.name);
+    });
+    return nameSelected && selectedBy(tags, [&info](const char* entry, const char* entryEnd) {
+        return listContains(info.tags, entry, (size_t)(entryEnd - entry));
+    });
+}
+
+inline bool testHasTag(const TestInfo& info, const char* tag) {
+    return listContains(info.tags, tag, strlen(tag));
+}
+
+inline const char* fileBaseName(const char* path) {
+    const char* base = path;
+    for (const char* p = path; *p != '\0'; p++) {
+        if (*p == '/' || *p == '\\') {
+            base = p + 1;
+        }
+    }
+    return base;
+}
+
+// Deadline from a "timeout=MS" tag in ms; 0 = none
+inline uint32_t testTagTimeout(const TestInfo& info) {
+    for (const char* tag = info.tags; tag != nullptr && *tag != '\0';) {
+        if (strncmp(tag, "timeout=", 8) == 0) {
+            return (uint32_t)strtoul(tag + 8, nullptr, 10);
+        }
+        tag = strchr(tag, ',');
+        tag = tag != nullptr ? tag + 1 : nullptr;
+    }
+    return 0;
+}
+
+inline void runRegisteredTest(const TestInfo& info) {
+    uint32_t timeoutMillis = testTagTimeout(info);
+#ifdef CONFIGMGR_NATIVE
+    if (::enhanced_unity_host::resultCache().skip(info.name, info.fileName, info.lineNumber, info.function,
+                                                  info.cacheKey)) {
+        return;
+    }
+    if (timeoutMillis > 0) {
+        setTestTimeout(info.function, timeoutMillis);
+    }
+#else
+    if (timeoutMillis == 0) {
+        timeoutMillis = ENHANCED_UNITY_TEST_TIMEOUT_MS;
+    }
+#endif
+#if defined(CONFIGMGR_NATIVE) && defined(ENHANCED_UNITY_PROCESS_POOL) && ENHANCED_UNITY_THREAD_SAFE
+    ::enhanced_unity_host::processPool().add(info.name, info.function, info.fileName, info.lineNumber);
+#elif defined(CONFIGMGR_NATIVE) && defined(ENHANCED_UNITY_PARALLEL) && ENHANCED_UNITY_THREAD_SAFE
+    ::enhanced_unity_host::parallelRunner().add(info.name, info.function, testHasTag(info, "exclusive"),
+                                                info.fileName, info.lineNumber);
+#elif defined(CONFIGMGR_NATIVE)
+    ::enhanced_unity_host::runTest(info.name, info.function, info.fileName, info.lineNumber);
+#else
+    if (ENHANCED_UNITY_WATCHDOG_BEGIN(info.name, timeoutMillis)) {
+        setUp();
+        info.function();
+        tearDown();
+        ENHANCED_UNITY_WATCHDOG_END();
+    }
+#endif
+}
+
+// Run every selected test handed out by `nextTest` (nullptr ends the
+// sequence), one file block per run of equal fileName; returns the count run
+template <typename NextTest>
+inline int runRegisteredSequence(NextTest nextTest, const char* filter, const char* tags) {
+    int run = 0;
+    const char* openFile = nullptr;
+    for (const TestInfo* info = nextTest(); info != nullptr; info = nextTest()) {
+        if (!testSelected(*info, filter, tags)) {
+            continue;
+        }
+#ifdef CONFIGMGR_NATIVE
+        if (!inShard(info->name)) {
+            continue;
+        }
+#endif
+        if (openFile == nullptr || strcmp(openFile, info->fileName) != 0) {
+            if (openFile != nullptr) {
+                ENHANCED_UNITY_END_TEST_FILE(fileBaseName(openFile), openFile);
+            }
+            openFile = info->fileName;
+            ENHANCED_UNITY_START_TEST_FILE(fileBaseName(openFile), openFile);
+        }
+        runRegisteredTest(*info);
+        run++;
+    }
+    if (openFile != nullptr) {
+        ENHANCED_UNITY_END_TEST_FILE(fileBaseName(openFile), openFile);
+    }
+    return run;
+}
+
+// Registration order; tests of one translation unit are contiguous
+inline int runRegisteredTests(const char* filter, const char* tags) {
+    TestRegistration* registration = _enhancedUnityRegistryHead;
+    return runRegisteredSequence([&registration]() -> const TestInfo* {
+        if (registration == nullptr) {
+            return nullptr;
+        }
+        const TestInfo* info = &registration->info;
+        registration = registration->next;
+        return info;
+    }, filter, tags);
+}
+
+} // namespace enhanced_unity
+
+#define ENHANCED_UNITY_TEST_KEYED(testName, testTags, contentKey) \
+    static void testName##_enhancedUnityBody(); \
+    static void testName() { \
+        ENHANCED_UNITY_START_TEST_METHOD(#testName, __FILE__, __LINE__); \
+        testName##_enhancedUnityBody(); \
+        ENHANCED_UNITY_END_TEST_METHOD(); \
+    } \
+    static constexpr ::enhanced_unity::TestInfo testName##_enhancedUnityInfo = \
+        { #testName, __FILE__, __LINE__, (testTags), testName, (contentKey) }; \
+    static ::enhanced_unity::TestRegistration testName##_enhancedUnityRegistration(testName##_enhancedUnityInfo); \
+    static void testName##_enhancedUnityBody()
+
+#define ENHANCED_UNITY_TEST_TAGGED(testName, testTags) ENHANCED_UNITY_TEST_KEYED(testName, testTags, nullptr)
+#define ENHANCED_UNITY_TEST(testName) ENHANCED_UNITY_TEST_TAGGED(testName, "")
+
+// Run all registered tests matching the filter/tag lists (nullptr = all)
+#define ENHANCED_UNITY_RUN_REGISTERED_TESTS(filter, tags) ::enhanced_unity::runRegisteredTests((filter), (tags))
+
+#ifdef CONFIGMGR_NATIVE
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace enhanced_unity_host {
+
+inline void listRegisteredTests(const char* filter, const char* tags) {
+    for (::enhanced_unity::TestRegistration* r = _enhancedUnityRegistryHead; r != nullptr; r = r->next) {
+        if (::enhanced_unity::testSelected(r->info, filter, tags) && ::enhanced_unity::inShard(r->info.name)) {
+            ::enhanced_unity::print("%-40s [%s] %s:%d\n", r->info.name, r->info.tags,
+                                    r->info.fileName, r->info.lineNumber);
+        }
+    }
+}
+
+// Attach `reporter` when a report file was asked for; false if it cannot be written
+inline bool attachReportFile(const char* path, ::enhanced_unity::FileSink& file,
+                             ::enhanced_unity::ResultReporter& reporter) {
+    if (path == nullptr) {
+        return true;
+    }
+    if (!file.isOpen()) {
+        ::enhanced_unity::print("cannot write report file %s\n", path);
+        return false;
+    }
+    return ENHANCED_UNITY_ADD_REPORTER(&reporter);
+}
+
+// Fisher-Yates, drawing from `random`
+template <typename T>
+inline void shuffleInPlace(std::vector<T>& items, uint64_t& random) {
+    for (size_t i = items.size(); i > 1; i--) {
+        std::swap(items[i - 1], items[(size_t)(::enhanced_unity::splitMix64(random) % i)]);
+    }
+}
+
+// Rounds over the tests of one file: every test still short of its
+// iterations runs once per round, in a fresh order; returns the count of
+// test runs
+inline int runShuffledFile(std::vector<const ::enhanced_unity::TestInfo*>& tests, uint64_t& random) {
+    StressRecorder& recorder = stressRecorder();
+    int run = 0;
+    for (;;) {
+        tests.erase(std::remove_if(tests.begin(), tests.end(), [&recorder](const ::enhanced_unity::TestInfo* info) {
+            return !recorder.wantsMore(info->function);
+        }), tests.end());
+        if (tests.empty()) {
+            break;
+        }
+        shuffleInPlace(tests, random);
+        uint64_t before = recorder.iterations();
+        for (const ::enhanced_unity::TestInfo* info : tests) {
+            ::enhanced_unity::runRegisteredTest(*info);
+            run++;
+        }
+        ENHANCED_UNITY_RUN_PENDING_TESTS();
+        // Cached tests and pool workers leave no statistics: stop rather than loop
+        if (recorder.iterations() == before) {
+            break;
+        }
+    }
+    return run;
+}
+
+// Shuffled stress rounds: the files run in an order shuffled from the stress
+// seed, each in one file block holding all of its rounds, so the file totals
+// stay those of a single run; returns the count of test runs
+inline int runShuffledRounds(std::vector<const ::enhanced_unity::TestInfo*> tests, const char* filter,
+                             const char* tags) {
+    StressOptions& stress = stressOptions();
+    tests.erase(std::remove_if(tests.begin(), tests.end(), [filter, tags](const ::enhanced_unity::TestInfo* info) {
+        return !::enhanced_unity::testSelected(*info, filter, tags) || !::enhanced_unity::inShard(info->name);
+    }), tests.end());
+    ::enhanced_unity::print("=== Shuffled stress rounds, seed 0x%08lx%08lx\n", (unsigned long)(stress.seed >> 32),
+                            (unsigned long)(stress.seed & 0xffffffffUL));
+    // Tests arrive sorted by file
+    std::vector<std::vector<const ::enhanced_unity::TestInfo*>> files;
+    for (const ::enhanced_unity::TestInfo* info : tests) {
+        if (files.empty() || strcmp(files.back().front()->fileName, info->fileName) != 0) {
+            files.emplace_back();
+        }
+        files.back().push_back(info);
+    }
+    uint64_t random = stress.seed;
+    shuffleInPlace(files, random);
+    int run = 0;
+    stress.interleaved = true;
+    for (std::vector<const ::enhanced_unity::TestInfo*>& fileTests : files) {
+        const char* fileName = fileTests.front()->fileName;
+        ENHANCED_UNITY_START_TEST_FILE(::enhanced_unity::fileBaseName(fileName), fileName);
+        run += runShuffledFile(fileTests, random);
+        ENHANCED_UNITY_END_TEST_FILE(::enhanced_unity::fileBaseName(fileName), fileName);
+    }
+    stress.interleaved = false;
+    return run;
+}
+
+inline int runCommandLine(int argc, char** argv) {
+    const char* filter = getenv("ENHANCED_UNITY_FILTER");
+    const char* tags = getenv("ENHANCED_UNITY_TAGS");
+    const char* jsonLinesPath = nullptr;
+    const char* junitPath = nullptr;
+    const char* tapPath = nullptr;
+    const char* cachePath = getenv("ENHANCED_UNITY_CACHE");
+    const char* cacheKey = getenv("ENHANCED_UNITY_CACHE_KEY");
+    const char* historyPath = getenv("ENHANCED_UNITY_HISTORY");
+    const char* historyLabel = getenv("ENHANCED_UNITY_HISTORY_LABEL");
+    bool list = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--tags=", 7) == 0) {
+            tags = argv[i] + 7;
+        } else if (strncmp(argv[i], "--jsonl=", 8) == 0) {
+            jsonLinesPath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--junit=", 8) == 0) {
+            junitPath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--tap=", 6) == 0) {
+            tapPath = argv[i] + 6;
+        } else if (strncmp(argv[i], "--cache=", 8) == 0) {
+            cachePath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--cache-key=", 12) == 0) {
+            cacheKey = argv[i] + 12;
+        } else if (strncmp(argv[i], "--history=", 10) == 0) {
+            historyPath = argv[i] + 10;
+        } else if (strncmp(argv[i], "--history-label=", 16) == 0) {
+            historyLabel = argv[i] + 16;
+        } else if (strcmp(argv[i], "--history-fail") == 0) {
+            timingHistory().failOnSlower = true;
+        } else if (strncmp(argv[i], "--shard=", 8) == 0) {
+            if (!::enhanced_unity::parseShard(argv[i] + 8, ::enhanced_unity::shardSpec())) {
+                ::enhanced_unity::print("bad shard %s (expected INDEX/COUNT, 0 <= INDEX < COUNT)\n", argv[i] + 8);
+                return 2;
+            }
+        } else if (strncmp(argv[i], "--timeout=", 10) == 0) {
+            char* end = nullptr;
+            unsigned long millis = strtoul(argv[i] + 10, &end, 10);
+            if (end == argv[i] + 10 || *end != '\0' || millis > 0xffffffffUL) {
+                ::enhanced_unity::print("bad timeout %s (expected milliseconds, 0 = none)\n", argv[i] + 10);
+                return 2;
+            }
+            ::enhanced_unity::defaultTestTimeout() = (uint32_t)millis;
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            char* end = nullptr;
+            unsigned long long seed = strtoull(argv[i] + 7, &end, 0);
+            if (end == argv[i] + 7 || *end != '\0') {
+                ::enhanced_unity::print("bad seed %s (expected a number, e.g. 0x1234abcd)\n", argv[i] + 7);
+                return 2;
+            }
+            ENHANCED_UNITY_SET_PROPERTY_SEED(seed);
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0 || strncmp(argv[i], "--repeat-for=", 13) == 0) {
+            bool forTime = argv[i][8] == '-';
+            const char* text = argv[i] + (forTime ? 13 : 9);
+            char* end = nullptr;
+            unsigned long value = strtoul(text, &end, 10);
+            if (end == text || *end != '\0' || value > 0xffffffffUL) {
+                ::enhanced_unity::print("bad %s %s (expected %s)\n", forTime ? "repeat time" : "repeat count", text,
+                                        forTime ? "milliseconds per test" : "iterations per test");
+                return 2;
+            }
+            (forTime ? stressOptions().budgetMillis : stressOptions().iterations) = (uint32_t)value;
+        } else if (strcmp(argv[i], "--shuffle") == 0 || strncmp(argv[i], "--shuffle=", 10) == 0) {
+            unsigned long long seed = 0;
+            if (argv[i][9] == '=') {
+                char* end = nullptr;
+                seed = strtoull(argv[i] + 10, &end, 0);
+                if (end == argv[i] + 10 || *end != '\0') {
+                    ::enhanced_unity::print("bad shuffle seed %s (expected a number, e.g. 0x1234abcd)\n", argv[i] + 10);
+                    return 2;
+                }
+            }
+            stressOptions().shuffle = true;
+            stressOptions().seed = stressSeed(seed);
+#if ENHANCED_UNITY_RUSAGE
+        } else if (strncmp(argv[i], "--rusage-sort=", 14) == 0) {
+            if (!::enhanced_unity::parseResourceColumn(argv[i] + 14, ::enhanced_unity::resourceSortColumn())) {
+                ::enhanced_unity::print("bad resource column %s (expected cpu, user, sys, minflt, majflt, vcsw, ivcsw or rss)\n",
+                                        argv[i] + 14);
+                return 2;
+            }
+#endif
+        } else {
+            ::enhanced_unity::print("unknown argument: %s (use --list, --filter=GLOBS, --tags=TAGS, "
+                                    "--jsonl=PATH, --junit=PATH, --tap=PATH, --cache=PATH, --cache-key=KEY, "
+                                    "--history=PATH, --history-label=LABEL, --history-fail, --shard=I/N, --timeout=MS, --seed=N, --repeat=N, --repeat-for=MS, "
+                                    "--shuffle[=SEED], --rusage-sort=KEY)\n", argv[i]);
+            return 2;
+        }
+    }
+    if (list) {
+        listRegisteredTests(filter, tags);
+        return 0;
+    }
+
+    // Reporters stay attached until the summary has been written
+    ::enhanced_unity::FileSink jsonLinesFile(jsonLinesPath);
+    ::enhanced_unity::FileSink junitFile(junitPath);
+    ::enhanced_unity::FileSink tapFile(tapPath);
+    ::enhanced_unity::JsonLinesReporter jsonLines(jsonLinesFile);
+    ::enhanced_unity::JUnitReporter junit(junitFile);
+    ::enhanced_unity::TapReporter tap(tapFile);
+    if (!attachReportFile(jsonLinesPath, jsonLinesFile, jsonLines) ||
+        !attachReportFile(junitPath, junitFile, junit) ||
+        !attachReportFile(tapPath, tapFile, tap)) {
+        ENHANCED_UNITY_REMOVE_REPORTERS();
+        return 2;
+    }
+    if (cachePath != nullptr && *cachePath != '\0' && !ENHANCED_UNITY_OPEN_RESULT_CACHE(cachePath, cacheKey)) {
+        ENHANCED_UNITY_REMOVE_REPORTERS();
+        return 2;
+    }
+    if (historyPath != nullptr && *historyPath != '\0' &&
+        !ENHANCED_UNITY_OPEN_TIMING_HISTORY(historyPath, historyLabel)) {
+        ENHANCED_UNITY_CLOSE_RESULT_CACHE();
+        ENHANCED_UNITY_REMOVE_REPORTERS();
+        return 2;
+    }
+
+    // Registration order across translation units is unspecified; sort for a stable run
+    std::vector<const ::enhanced_unity::TestInfo*> tests;
+    for (::enhanced_unity::TestRegistration* r = _enhancedUnityRegistryHead; r != nullptr; r = r->next) {
+        tests.push_back(&r->info);
+    }
+    std::stable_sort(tests.begin(), tests.end(),
+                     [](const ::enhanced_unity::TestInfo* a, const ::enhanced_unity::TestInfo* b) {
+                         int byFile = strcmp(a->fileName, b->fileName);
+                         return byFile != 0 ? byFile < 0 : a->lineNumber < b->lineNumber;
+                     });
+
+    ENHANCED_UNITY_INIT();
+    int run = 0;
+    if (stressOptions().shuffle) {
+        run = runShuffledRounds(tests, filter, tags);
+    } else {
+        size_t next = 0;
+        run = ::enhanced_unity::runRegisteredSequence([&tests, &next]() -> const ::enhanced_unity::TestInfo* {
+            return next < tests.size() ? tests[next++] : nullptr;
+        }, filter, tags);
+    }
+    ENHANCED_UNITY_FINAL_SUMMARY();
+    ENHANCED_UNITY_CLOSE_RESULT_CACHE();
+    ENHANCED_UNITY_REMOVE_REPORTERS();
+    if (run == 0) {
+        ::enhanced_unity::print("no registered test matches filter '%s' tags '%s'\n",
+                                filter ? filter : "", tags ? tags : "");
+    }
+    return ENHANCED_UNITY_GET_FAILURES() > 0 ? 1 : 0;
+}
+
+// Command-line runner: --list, --filter=GLOBS, --tags=TAGS, --jsonl=PATH,
+// --junit=PATH, --tap=PATH, --cache=PATH, --cache-key=KEY, --history=PATH,
+// --history-label=LABEL, --history-fail, --shard=I/N, --timeout=MS,
+// --seed=N, --repeat=N, --repeat-for=MS, --shuffle[=SEED], --rusage-sort=KEY;
+// returns a process exit code
+inline int runRegisteredTests(int argc, char** argv) {
+    int exitCode = runCommandLine(argc, argv);
+    ::enhanced_unity::flushOutput(true);  // --list and argument errors print without a summary
+    return exitCode;
+}
+
+} // namespace enhanced_unity_host
+
+// Defines main() for a native test binary built from ENHANCED_UNITY_TEST cases
+#define ENHANCED_UNITY_MAIN() \
+    int main(int argc, char** argv) { return ::enhanced_unity_host::runRegisteredTests(argc, argv); }
+
+#endif // CONFIGMGR_NATIVE
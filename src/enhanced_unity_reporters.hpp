@@ -0,0 +1,752 @@
+#pragma once
+
+// ============================================================================
+// MACHINE-READABLE RESULT REPORTERS
+// ============================================================================
+// A ResultReporter receives the run as a stream of events: file start, each
+// recorded failing assertion, method end (counts, timing, memory, abort
+// reason), file end, tests slower than their timing history and run end. Three writers ship with the framework, each
+// streaming to its own OutputSink as events arrive and keeping only
+// fixed-size state:
+//
+//   JsonLinesReporter  one JSON object per event
+//   TapReporter        TAP version 13 with a YAML block per method
+//   JUnitReporter      JUnit XML, one <testsuite> per test file
+//
+// ENHANCED_UNITY_ADD_REPORTER(&reporter) attaches one (up to
+// ENHANCED_UNITY_MAX_REPORTERS). While a reporter is attached, failing
+// assertions are recorded whatever the verbosity. On parallel and process
+// pool runs each test's report text is captured with its output and
+// written in submission order.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Bytes a writer formats before handing them to its sink
+#ifndef ENHANCED_UNITY_REPORT_LINE
+#if defined(__AVR__)
+#define ENHANCED_UNITY_REPORT_LINE 48
+#elif defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_REPORT_LINE 1024
+#else
+#define ENHANCED_UNITY_REPORT_LINE 256
+#endif
+#endif
+
+// Failure messages one JUnit <testcase> keeps; later ones are only counted
+#ifndef ENHANCED_UNITY_JUNIT_FAILURES
+#ifdef __AVR__
+#define ENHANCED_UNITY_JUNIT_FAILURES 1
+#else
+#define ENHANCED_UNITY_JUNIT_FAILURES 4
+#endif
+#endif
+
+namespace enhanced_unity {
+
+// Strings marked (flash) are flash strings on ENHANCED_UNITY_PROGMEM builds
+
+struct AssertionEvent {
+    AssertionEvent(const AssertRecord& assertRecord, const char* method, const char* file)
+        : methodName(method), fileName(file), line(assertRecord.line), passed(assertRecord.passed != 0),
+          record(assertRecord) {}
+
+    const char* methodName;  // (flash)
+    const char* fileName;    // (flash)
+    unsigned line;
+    bool passed;
+    const AssertRecord& record;
+
+    // "TEST_ASSERT_EQUAL_INT(3, 4)", formatted on first use
+    const char* detail() const {
+        if (!formatted_) {
+            formatRecordDetail(record, detail_, sizeof(detail_));
+            formatted_ = true;
+        }
+        return detail_;
+    }
+
+private:
+    mutable char detail_[ENHANCED_UNITY_DETAIL_LENGTH];
+    mutable bool formatted_ = false;
+};
+
+struct MethodEvent {
+    const char* methodName;     // (flash)
+    const char* fileName;       // (flash)
+    int assertions;
+    int failures;
+    TimeMicros micros;
+    const MethodMemory* memory;  // nullptr without ENHANCED_UNITY_MEMORY
+    const char* abortReason;     // nullptr unless the method aborted
+};
+
+struct FileEvent {
+    const char* suiteName;
+    const char* fileName;
+    int methods;
+    int methodFailures;
+    int assertions;
+    int failures;
+    TimeMicros micros;
+};
+
+// A test slower than its timing history (native)
+struct HistoryEvent {
+    const char* testName;
+    const char* detail;  // "12.500 ms vs median 4.000 ms (MAD 0.100, +212%, 20 runs)"
+    bool failed;         // --history-fail: booked as a failure of the run
+};
+
+struct RunEvent {
+    int files;
+    int fileFailures;
+    int methods;
+    int methodFailures;
+    int assertions;
+    int failures;
+    TimeMicros micros;
+    int shardIndex;
+    int shardCount;  // 0 unless the run was one shard of a suite
+    int historyFailures;  // tests failed for being slower than their history
+};
+
+class ResultReporter {
+public:
+    explicit ResultReporter(OutputSink& sink) : sink_(sink) {}
+    virtual ~ResultReporter() {}
+
+    virtual void beginFile(const char* /*suiteName*/, const char* /*fileName*/) {}
+    virtual void beginMethod(const char* /*methodName*/) {}
+    virtual void assertion(const AssertionEvent& /*event*/) {}
+    virtual void endMethod(const MethodEvent& /*event*/) {}
+    virtual void endFile(const FileEvent& /*event*/) {}
+    virtual void slowerTest(const HistoryEvent& /*event*/) {}
+    virtual void endRun(const RunEvent& /*event*/) {}
+
+    // Write report text; captured with the test's output on worker threads
+    void emit(const char* data, size_t length) {
+#if ENHANCED_UNITY_THREAD_SAFE
+        if (OutputCapture* capture = threadOutputCapture()) {
+            if (slot >= 0) {
+                capture->reports[slot].append(data, length);
+            }
+            return;
+        }
+#endif
+        sink_.write(data, length);
+    }
+
+    OutputSink& sink() { return sink_; }
+
+    int slot = -1;  // index in the reporter list, set by addReporter()
+
+private:
+    OutputSink& sink_;
+};
+
+} // namespace enhanced_unity
+
+extern enhanced_unity::ResultReporter* _enhancedUnityReporters[ENHANCED_UNITY_MAX_REPORTERS];
+extern int _enhancedUnityReporterCount;
+
+namespace enhanced_unity {
+
+inline int reporterCount() { return _enhancedUnityReporterCount; }
+
+// False when the list is full
+inline bool addReporter(ResultReporter* reporter) {
+    if (reporter == nullptr || _enhancedUnityReporterCount >= ENHANCED_UNITY_MAX_REPORTERS) {
+        return false;
+    }
+    reporter->slot = _enhancedUnityReporterCount;
+    _enhancedUnityReporters[_enhancedUnityReporterCount++] = reporter;
+    return true;
+}
+
+inline void removeReporters() {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->slot = -1;
+        _enhancedUnityReporters[i] = nullptr;
+    }
+    _enhancedUnityReporterCount = 0;
+}
+
+// Failing assertions are recorded for the report text or for a reporter
+inline bool recordsFailures() {
+    return ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS || reporterCount() > 0;
+}
+
+#if ENHANCED_UNITY_THREAD_SAFE
+// Write the report text a worker captured for one test; a thread that is
+// itself being captured (a watchdog helper's parent) passes it on instead
+inline void replayReports(const OutputCapture& capture) {
+    OutputCapture* outer = threadOutputCapture();
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        const std::string& text = capture.reports[i];
+        if (text.empty()) {
+            continue;
+        }
+        if (outer != nullptr) {
+            outer->reports[i] += text;
+        } else {
+            _enhancedUnityReporters[i]->sink().write(text.data(), text.size());
+        }
+    }
+}
+#endif
+
+enum ReportEscape : uint8_t {
+    ESCAPE_NONE,
+    ESCAPE_LINE,         // newlines become spaces (TAP diagnostics)
+    ESCAPE_DESCRIPTION,  // ESCAPE_LINE, and "#" escaped as "\#" (TAP test descriptions)
+    ESCAPE_JSON,
+    ESCAPE_XML,
+};
+
+// Fixed-size formatting buffer for one reporter; passes full chunks on, so
+// text of any length streams through in constant memory
+class ReportLine {
+public:
+    explicit ReportLine(ResultReporter& reporter) : reporter_(reporter) {}
+    ~ReportLine() { flush(); }
+    ReportLine(const ReportLine&) = delete;
+    ReportLine& operator=(const ReportLine&) = delete;
+
+    // A string literal wrapped in ENHANCED_UNITY_FLASH()
+    ReportLine& literal(const char* text) { return escaped(text, true, ESCAPE_NONE); }
+
+    ReportLine& escaped(const char* text, bool inFlash, ReportEscape escape) {
+        if (text == nullptr) {
+            return *this;
+        }
+        for (;; text++) {
+            char c = inFlash ? (char)readFlashByte(text) : *text;
+            if (c == '\0') {
+                return *this;
+            }
+            putEscaped(c, escape);
+        }
+    }
+
+    ReportLine& number(int64_t value) {
+        char digits[24];
+        return escaped(formatInteger(digits, value, false), false, ESCAPE_NONE);
+    }
+
+    // "1.234567" from microseconds
+    ReportLine& seconds(TimeMicros micros) { return fixed((uint64_t)micros, 1000000u, 6); }
+
+    // "1.234" from microseconds
+    ReportLine& millis(TimeMicros micros) { return fixed((uint64_t)micros, 1000u, 3); }
+
+    void flush() {
+        if (length_ > 0) {
+            reporter_.emit(data_, length_);
+            length_ = 0;
+        }
+    }
+
+private:
+    void put(char c) {
+        if (length_ == sizeof(data_)) {
+            flush();
+        }
+        data_[length_++] = c;
+    }
+
+    void putEscaped(char c, ReportEscape escape) {
+        static const char hex[] = "0123456789abcdef";
+        unsigned char byte = (unsigned char)c;
+        switch (escape) {
+        case ESCAPE_JSON:
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put(c);
+            } else if (byte < 0x20) {
+                put('\\');
+                put('u');
+                put('0');
+                put('0');
+                put(hex[byte >> 4]);
+                put(hex[byte & 0xF]);
+            } else {
+                put(c);
+            }
+            return;
+        case ESCAPE_XML:
+            if (c == '&') {
+                literal(ENHANCED_UNITY_FLASH("&amp;"));
+            } else if (c == '<') {
+                literal(ENHANCED_UNITY_FLASH("&lt;"));
+            } else if (c == '>') {
+                literal(ENHANCED_UNITY_FLASH("&gt;"));
+            } else if (c == '"') {
+                literal(ENHANCED_UNITY_FLASH("&quot;"));
+            } else if (c == '\n') {
+                literal(ENHANCED_UNITY_FLASH("&#10;"));  // kept inside attributes too
+            } else if (byte < 0x20 && c != '\t') {
+                put('?');  // not representable in XML 1.0
+            } else {
+                put(c);
+            }
+            return;
+        case ESCAPE_DESCRIPTION:
+            if (c == '#' || c == '\\') {
+                put('\\');
+            }
+            put(c == '\n' || c == '\r' ? ' ' : c);
+            return;
+        case ESCAPE_LINE:
+            put(c == '\n' || c == '\r' ? ' ' : c);
+            return;
+        case ESCAPE_NONE:
+            put(c);
+            return;
+        }
+    }
+
+    ReportLine& fixed(uint64_t value, uint32_t scale, int decimals) {
+        number((int64_t)(value / scale));
+        put('.');
+        uint32_t fraction = (uint32_t)(value % scale);
+        for (uint32_t digit = scale / 10; decimals-- > 0; digit /= 10) {
+            put((char)('0' + (fraction / digit) % 10));
+        }
+        return *this;
+    }
+
+    ResultReporter& reporter_;
+    char data_[ENHANCED_UNITY_REPORT_LINE];
+    size_t length_ = 0;
+};
+
+// One JSON object per line:
+//   {"event":"file_start","suite":...,"file":...}
+//   {"event":"assertion","method":...,"file":...,"line":42,"detail":...}
+//   {"event":"method","method":...,"status":"failed","assertions":..,...}
+//   {"event":"file",...}, {"event":"history","method":...,"status":"slower"}
+//   and a closing {"event":"run",...}
+class JsonLinesReporter : public ResultReporter {
+public:
+    explicit JsonLinesReporter(OutputSink& sink) : ResultReporter(sink) {}
+
+    void beginFile(const char* suiteName, const char* fileName) override {
+        suite_ = suiteName;
+        ReportLine line(*this);
+        line.literal(ENHANCED_UNITY_FLASH("{\"event\":\"file_start\""));
+        string(line, ENHANCED_UNITY_FLASH("suite"), suiteName, false);
+        string(line, ENHANCED_UNITY_FLASH("file"), fileName, false);
+        line.literal(ENHANCED_UNITY_FLASH("}\n"));
+    }
+
+    void assertion(const AssertionEvent& event) override {
+        if (event.passed) {
+            return;
+        }
+        ReportLine line(*this);
+        line.literal(ENHANCED_UNITY_FLASH("{\"event\":\"assertion\""));
+        string(line, ENHANCED_UNITY_FLASH("suite"), suite_, false);
+        string(line, ENHANCED_UNITY_FLASH("method"), event.methodName, true);
+        string(line, ENHANCED_UNITY_FLASH("file"), event.fileName, true);
+        count(line, ENHANCED_UNITY_FLASH("line"), event.line);
+        string(line, ENHANCED_UNITY_FLASH("detail"), event.detail(), false);
+        line.literal(ENHANCED_UNITY_FLASH("}\n"));
+    }
+
+    void endMethod(const MethodEvent& event) override {
+        ReportLine line(*this);
+        line.literal(ENHANCED_UNITY_FLASH("{\"event\":\"method\""));
+        string(line, ENHANCED_UNITY_FLASH("suite"), suite_, false);
+        string(line, ENHANCED_UNITY_FLASH("method"), event.methodName, true);
+        string(line, ENHANCED_UNITY_FLASH("file"), event.fileName, true);
+        string(line, ENHANCED_UNITY_FLASH("status"),
+               event.abortReason != nullptr ? ENHANCED_UNITY_FLASH("aborted")
+               : event.failures > 0 ? ENHANCED_UNITY_FLASH("failed") : ENHANCED_UNITY_FLASH("passed"), true);
+        count(line, ENHANCED_UNITY_FLASH("assertions"), event.assertions);
+        count(line, ENHANCED_UNITY_FLASH("failures"), event.failures);
+        count(line, ENHANCED_UNITY_FLASH("micros"), (int64_t)event.micros);
+        if (event.memory != nullptr) {
+            count(line, ENHANCED_UNITY_FLASH("heap_delta"), event.memory->heapDelta);
+            count(line, ENHANCED_UNITY_FLASH("heap_peak"), event.memory->heapPeak);
+            if (event.memory->stackFree != ENHANCED_UNITY_STACK_UNKNOWN) {
+                count(line, ENHANCED_UNITY_FLASH("stack_free"), event.memory->stackFree);
+            }
+        }
+        if (event.abortReason != nullptr) {
+            string(line, ENHANCED_UNITY_FLASH("reason"), event.abortReason, false);
+        }
+        line.literal(ENHANCED_UNITY_FLASH("}\n"));
+    }
+
+    void endFile(const FileEvent& event) override {
+        {
+            ReportLine line(*this);
+            line.literal(ENHANCED_UNITY_FLASH("{\"event\":\"file\""));
+            string(line, ENHANCED_UNITY_FLASH("suite"), event.suiteName, false);
+            string(line, ENHANCED_UNITY_FLASH("file"), event.fileName, false);
+            string(line, ENHANCED_UNITY_FLASH("status"), statusWord(event.methodFailures == 0), true);
+            count(line, ENHANCED_UNITY_FLASH("methods"), event.methods);
+            count(line, ENHANCED_UNITY_FLASH("method_failures"), event.methodFailures);
+            count(line, ENHANCED_UNITY_FLASH("assertions"), event.assertions);
+            count(line, ENHANCED_UNITY_FLASH("failures"), event.failures);
+            count(line, ENHANCED_UNITY_FLASH("micros"), (int64_t)event.micros);
+            line.literal(ENHANCED_UNITY_FLASH("}\n"));
+        }
+        suite_ = nullptr;
+        sink().flush();
+    }
+
+    void slowerTest(const HistoryEvent& event) override {
+        ReportLine line(*this);
+        line.literal(ENHANCED_UNITY_FLASH("{\"event\":\"history\""));
+        string(line, ENHANCED_UNITY_FLASH("method"), event.testName, false);
+        string(line, ENHANCED_UNITY_FLASH("status"),
+               event.failed ? ENHANCED_UNITY_FLASH("failed") : ENHANCED_UNITY_FLASH("slower"), true);
+        string(line, ENHANCED_UNITY_FLASH("detail"), event.detail, false);
+        line.literal(ENHANCED_UNITY_FLASH("}\n"));
+    }
+
+    void endRun(const RunEvent& event) override {
+        {
+            ReportLine line(*this);
+            line.literal(ENHANCED_UNITY_FLASH("{\"event\":\"run\""));
+            string(line, ENHANCED_UNITY_FLASH("status"),
+                   statusWord(event.fileFailures == 0 && event.methodFailures == 0 && event.failures == 0 &&
+                              event.historyFailures == 0), true);
+            count(line, ENHANCED_UNITY_FLASH("files"), event.files);
+            count(line, ENHANCED_UNITY_FLASH("file_failures"), event.fileFailures);
+            count(line, ENHANCED_UNITY_FLASH("methods"), event.methods);
+            count(line, ENHANCED_UNITY_FLASH("method_failures"), event.methodFailures);
+            count(line, ENHANCED_UNITY_FLASH("assertions"), event.assertions);
+            count(line, ENHANCED_UNITY_FLASH("failures"), event.failures);
+            count(line, ENHANCED_UNITY_FLASH("micros"), (int64_t)event.micros);
+            if (event.shardCount > 0) {
+                count(line, ENHANCED_UNITY_FLASH("shard"), event.shardIndex);
+                count(line, ENHANCED_UNITY_FLASH("shards"), event.shardCount);
+            }
+            if (event.historyFailures > 0) {
+                count(line, ENHANCED_UNITY_FLASH("history_failures"), event.historyFailures);
+            }
+            line.literal(ENHANCED_UNITY_FLASH("}\n"));
+        }
+        sink().flush();
+    }
+
+private:
+    static const char* statusWord(bool passed) {
+        return passed ? ENHANCED_UNITY_FLASH("passed") : ENHANCED_UNITY_FLASH("failed");
+    }
+
+    // ,"key":"value" (omitted when value is nullptr)
+    static void string(ReportLine& line, const char* key, const char* value, bool inFlash) {
+        if (value == nullptr) {
+            return;
+        }
+        line.literal(ENHANCED_UNITY_FLASH(",\"")).literal(key).literal(ENHANCED_UNITY_FLASH("\":\""));
+        line.escaped(value, inFlash, ESCAPE_JSON).literal(ENHANCED_UNITY_FLASH("\""));
+    }
+
+    // ,"key":123
+    static void count(ReportLine& line, const char* key, int64_t value) {
+        line.literal(ENHANCED_UNITY_FLASH(",\"")).literal(key).literal(ENHANCED_UNITY_FLASH("\":")).number(value);
+    }
+
+    const char* suite_ = nullptr;
+};
+
+// TAP version 13: "ok - suite: method" per method with a YAML block of
+// counts and timing, failures as "# file:line: detail" diagnostics before
+// it, a "not ok - timing history: test" per test failed for being slower
+// than its history, and the plan at the end of the run
+class TapReporter : public ResultReporter {
+public:
+    explicit TapReporter(OutputSink& sink) : ResultReporter(sink) {}
+
+    void beginFile(const char* suiteName, const char* fileName) override {
+        suite_ = suiteName;
+        ReportLine line(*this);
+        header(line);
+        line.literal(ENHANCED_UNITY_FLASH("# ")).escaped(suiteName, false, ESCAPE_LINE);
+        line.literal(ENHANCED_UNITY_FLASH(" (")).escaped(fileName, false, ESCAPE_LINE);
+        line.literal(ENHANCED_UNITY_FLASH(")\n"));
+    }
+
+    void assertion(const AssertionEvent& event) override {
+        if (event.passed) {
+            return;
+        }
+        ReportLine line(*this);
+        line.literal(ENHANCED_UNITY_FLASH("# ")).escaped(event.fileName, true, ESCAPE_LINE);
+        line.literal(ENHANCED_UNITY_FLASH(":")).number(event.line).literal(ENHANCED_UNITY_FLASH(": "));
+        line.escaped(event.detail(), false, ESCAPE_LINE).literal(ENHANCED_UNITY_FLASH("\n"));
+    }
+
+    void endMethod(const MethodEvent& event) override {
+        ReportLine line(*this);
+        bool passed = event.failures == 0 && event.abortReason == nullptr;
+        line.literal(passed ? ENHANCED_UNITY_FLASH("ok - ") : ENHANCED_UNITY_FLASH("not ok - "));
+        if (suite_ != nullptr) {
+            line.escaped(suite_, false, ESCAPE_DESCRIPTION).literal(ENHANCED_UNITY_FLASH(": "));
+        }
+        line.escaped(event.methodName, true, ESCAPE_DESCRIPTION).literal(ENHANCED_UNITY_FLASH("\n  ---\n"));
+        line.literal(ENHANCED_UNITY_FLASH("  duration_ms: ")).millis(event.micros);
+        line.literal(ENHANCED_UNITY_FLASH("\n  assertions: ")).number(event.assertions);
+        line.literal(ENHANCED_UNITY_FLASH("\n  failures: ")).number(event.failures);
+        if (event.memory != nullptr) {
+            line.literal(ENHANCED_UNITY_FLASH("\n  heap_peak: ")).number(event.memory->heapPeak);
+        }
+        if (event.abortReason != nullptr) {
+            line.literal(ENHANCED_UNITY_FLASH("\n  aborted: \"")).escaped(event.abortReason, false, ESCAPE_JSON);
+            line.literal(ENHANCED_UNITY_FLASH("\""));
+        }
+        line.literal(ENHANCED_UNITY_FLASH("\n  ...\n"));
+    }
+
+    void endFile(const FileEvent&) override {
+        suite_ = nullptr;
+        sink().flush();
+    }
+
+    void slowerTest(const HistoryEvent& event) override {
+        if (!event.failed) {
+            return;
+        }
+        ReportLine line(*this);
+        header(line);
+        line.literal(ENHANCED_UNITY_FLASH("not ok - timing history: ")).escaped(event.testName, false, ESCAPE_DESCRIPTION);
+        line.literal(ENHANCED_UNITY_FLASH("\n  ---\n  slower: \"")).escaped(event.detail, false, ESCAPE_JSON);
+        line.literal(ENHANCED_UNITY_FLASH("\"\n  ...\n"));
+    }
+
+    void endRun(const RunEvent& event) override {
+        {
+            ReportLine line(*this);
+            header(line);
+            line.literal(ENHANCED_UNITY_FLASH("1..")).number(event.methods + event.historyFailures);
+            line.literal(ENHANCED_UNITY_FLASH("\n"));
+        }
+        sink().flush();
+    }
+
+private:
+    // Written from the test thread only (file boundaries and run end)
+    void header(ReportLine& line) {
+        if (!headerWritten_) {
+            headerWritten_ = true;
+            line.literal(ENHANCED_UNITY_FLASH("TAP version 13\n"));
+        }
+    }
+
+    const char* suite_ = nullptr;
+    bool headerWritten_ = false;
+};
+
+// Failures of the running method, kept per reporter slot and per thread
+struct JUnitFailures {
+    char messages[ENHANCED_UNITY_JUNIT_FAILURES][ENHANCED_UNITY_DETAIL_LENGTH];
+    int count;
+    int dropped;
+};
+
+inline JUnitFailures& junitFailures(int slot) {
+#if ENHANCED_UNITY_THREAD_SAFE
+    static thread_local JUnitFailures failures[ENHANCED_UNITY_MAX_REPORTERS];
+#else
+    static JUnitFailures failures[ENHANCED_UNITY_MAX_REPORTERS];
+#endif
+    return failures[slot >= 0 ? slot : 0];
+}
+
+// JUnit XML: <testsuites> around one <testsuite> per test file; methods
+// are written as <testcase> when they end, with their (first
+// ENHANCED_UNITY_JUNIT_FAILURES) failure messages. Tests failed for being
+// slower than their timing history close the run in a "timing history"
+// <testsuite>. Methods must run inside ENHANCED_UNITY_START/END_TEST_FILE
+// for the XML to be well formed.
+class JUnitReporter : public ResultReporter {
+public:
+    explicit JUnitReporter(OutputSink& sink) : ResultReporter(sink) {}
+
+    void beginFile(const char* suiteName, const char* fileName) override {
+        suite_ = suiteName;
+        ReportLine line(*this);
+        if (!started_) {
+            started_ = true;
+            line.literal(ENHANCED_UNITY_FLASH("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n"));
+        }
+        line.literal(ENHANCED_UNITY_FLASH("  <testsuite name=\"")).escaped(suiteName, false, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\" file=\"")).escaped(fileName, false, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\">\n"));
+    }
+
+    void beginMethod(const char*) override {
+        JUnitFailures& failures = junitFailures(slot);
+        failures.count = 0;
+        failures.dropped = 0;
+    }
+
+    void assertion(const AssertionEvent& event) override {
+        if (event.passed) {
+            return;
+        }
+        JUnitFailures& failures = junitFailures(slot);
+        if (failures.count >= ENHANCED_UNITY_JUNIT_FAILURES) {
+            failures.dropped++;
+            return;
+        }
+        char* message = failures.messages[failures.count++];
+        int prefix = ENHANCED_UNITY_FORMAT(message, ENHANCED_UNITY_DETAIL_LENGTH,
+                                           "%" ENHANCED_UNITY_FLASH_S ":%u: ", event.fileName, event.line);
+        if (prefix >= 0 && prefix < ENHANCED_UNITY_DETAIL_LENGTH) {
+            formatRecordDetail(event.record, message + prefix, ENHANCED_UNITY_DETAIL_LENGTH - prefix);
+        }
+    }
+
+    void endMethod(const MethodEvent& event) override {
+        const JUnitFailures& failures = junitFailures(slot);
+        ReportLine line(*this);
+        line.literal(ENHANCED_UNITY_FLASH("    <testcase classname=\"")).escaped(suite_, false, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\" name=\"")).escaped(event.methodName, true, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\" file=\"")).escaped(event.fileName, true, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\" assertions=\"")).number(event.assertions);
+        line.literal(ENHANCED_UNITY_FLASH("\" time=\"")).seconds(event.micros);
+        if (event.failures == 0 && event.abortReason == nullptr) {
+            line.literal(ENHANCED_UNITY_FLASH("\"/>\n"));
+            return;
+        }
+        line.literal(ENHANCED_UNITY_FLASH("\">\n"));
+        if (event.abortReason != nullptr) {
+            line.literal(ENHANCED_UNITY_FLASH("      <error type=\"aborted\" message=\""));
+            line.escaped(event.abortReason, false, ESCAPE_XML).literal(ENHANCED_UNITY_FLASH("\"/>\n"));
+        }
+        if (event.failures > 0) {
+            line.literal(ENHANCED_UNITY_FLASH("      <failure type=\"assertion\" message=\""));
+            if (failures.count > 0) {
+                line.escaped(failures.messages[0], false, ESCAPE_XML);
+            }
+            line.literal(ENHANCED_UNITY_FLASH("\">"));
+            for (int i = 0; i < failures.count; i++) {
+                line.escaped(failures.messages[i], false, ESCAPE_XML).literal(ENHANCED_UNITY_FLASH("\n"));
+            }
+            // Failures that were not recorded (record buffer full) are counted too
+            int unlisted = event.failures - failures.count;
+            if (unlisted > 0) {
+                line.number(unlisted).literal(ENHANCED_UNITY_FLASH(" more failure(s)\n"));
+            }
+            line.literal(ENHANCED_UNITY_FLASH("</failure>\n"));
+        }
+        line.literal(ENHANCED_UNITY_FLASH("    </testcase>\n"));
+    }
+
+    void endFile(const FileEvent&) override {
+        {
+            ReportLine line(*this);
+            line.literal(ENHANCED_UNITY_FLASH("  </testsuite>\n"));
+        }
+        suite_ = nullptr;
+        sink().flush();
+    }
+
+    void slowerTest(const HistoryEvent& event) override {
+        if (!event.failed) {
+            return;
+        }
+        ReportLine line(*this);
+        if (!started_) {
+            started_ = true;
+            line.literal(ENHANCED_UNITY_FLASH("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n"));
+        }
+        if (!historyOpen_) {
+            historyOpen_ = true;
+            line.literal(ENHANCED_UNITY_FLASH("  <testsuite name=\"timing history\">\n"));
+        }
+        line.literal(ENHANCED_UNITY_FLASH("    <testcase classname=\"timing history\" name=\""));
+        line.escaped(event.testName, false, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\">\n      <failure type=\"slower\" message=\""));
+        line.escaped(event.detail, false, ESCAPE_XML);
+        line.literal(ENHANCED_UNITY_FLASH("\"/>\n    </testcase>\n"));
+    }
+
+    void endRun(const RunEvent&) override {
+        if (started_) {
+            ReportLine line(*this);
+            if (historyOpen_) {
+                line.literal(ENHANCED_UNITY_FLASH("  </testsuite>\n"));
+                historyOpen_ = false;
+            }
+            line.literal(ENHANCED_UNITY_FLASH("</testsuites>\n"));
+            started_ = false;
+        }
+        sink().flush();
+    }
+
+private:
+    const char* suite_ = nullptr;
+    bool started_ = false;
+    bool historyOpen_ = false;
+};
+
+// ---- event dispatch, called from the test boundaries ----
+
+inline void notifyFileStart(const char* suiteName, const char* fileName) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->beginFile(suiteName, fileName);
+    }
+}
+
+inline void notifyMethodStart(const char* methodName) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->beginMethod(methodName);
+    }
+}
+
+inline void notifyAssertion(const AssertionEvent& event) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->assertion(event);
+    }
+}
+
+inline void notifyMethodEnd(const MethodEvent& event) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->endMethod(event);
+    }
+}
+
+inline void notifyFileEnd(const FileEvent& event) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->endFile(event);
+    }
+}
+
+inline void notifySlowerTest(const HistoryEvent& event) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->slowerTest(event);
+    }
+}
+
+inline void notifyRunEnd(const RunEvent& event) {
+    for (int i = 0; i < _enhancedUnityReporterCount; i++) {
+        _enhancedUnityReporters[i]->endRun(event);
+    }
+}
+
+// The method that just ended, from the current counter context
+inline void notifyMethodResult(const char* abortReason) {
+    if (_enhancedUnityReporterCount == 0) {
+        return;
+    }
+    const CounterContext& c = counters();
+    MethodEvent event = { c.methodName != nullptr ? c.methodName : ENHANCED_UNITY_FLASH("<unknown>"),
+                          fileNameForId(c.methodFileId), c.assertionCount, c.assertionFailureCount,
+                          c.methodMicros, ENHANCED_UNITY_MEMORY ? &c.methodMemory : nullptr, abortReason };
+    notifyMethodEnd(event);
+}
+
+} // namespace enhanced_unity
+
+// Attach a reporter (an enhanced_unity::ResultReporter*) for the rest of the run
+#define ENHANCED_UNITY_ADD_REPORTER(reporter) ::enhanced_unity::addReporter(reporter)
+
+// Detach all reporters (before they or their sinks go out of scope)
+#define ENHANCED_UNITY_REMOVE_REPORTERS() ::enhanced_unity::removeReporters()
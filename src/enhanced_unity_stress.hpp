@@ -0,0 +1,317 @@
+#pragma once
+
+// ============================================================================
+// STRESS MODE (CONFIGMGR_NATIVE)
+// ============================================================================
+// Reruns tests to expose intermittent failures and timing variance. Each test
+// runs `iterations` times, or until it has spent `budgetMillis` of wall time
+// (at least once), or whichever comes first when both are set:
+//
+//   --repeat=N        ENHANCED_UNITY_REPEAT=N
+//   --repeat-for=MS   ENHANCED_UNITY_REPEAT_FOR_MS=MS
+//   --shuffle[=SEED]  ENHANCED_UNITY_SHUFFLE=SEED (0 = seed from the clock)
+//
+// Hand-written runners call ENHANCED_UNITY_SET_REPEAT(count, ms) before
+// their RUN_TEST_DEBUG calls; each test then repeats in place. --shuffle
+// (registered tests only) instead runs the files in an order drawn from the
+// printed seed and, inside each file's block, its tests in rounds, each in a
+// fresh order, until every test has had its iterations, so failures that
+// depend on test order show up too.
+//
+// Every iteration is a full method (setUp, body, tearDown) in the report and
+// the counters. A "Stress results" section after the final summary gives per
+// test the pass rate, the first failing iteration, the mean, standard
+// deviation and p99 of the durations, and a class:
+//
+//   STABLE    every iteration passed, no duration trend
+//   FLAKY     some iterations passed and some failed
+//   FAILING   no iteration passed
+//   DRIFTING  passed, but durations grew over the run: the least-squares
+//             trend adds ENHANCED_UNITY_STRESS_DRIFT_PERCENT of the mean or
+//             more from first to last iteration, and at least
+//             ENHANCED_UNITY_STRESS_DRIFT_MIN_MICROS, with a correlation of at
+//             least 0.5 over ENHANCED_UNITY_STRESS_DRIFT_MIN_RUNS or more runs
+//
+// Statistics come from the process that ran the test: in place and under
+// ENHANCED_UNITY_PARALLEL. Process pool workers repeat their tests but
+// report no statistics, so shuffled pool runs stop after one round.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+// Growth over the run, in percent of the mean duration, that marks a drift
+#ifndef ENHANCED_UNITY_STRESS_DRIFT_PERCENT
+#define ENHANCED_UNITY_STRESS_DRIFT_PERCENT 20
+#endif
+
+// Smallest growth in µs that counts as a drift; below it, timer resolution
+// and scheduling noise dominate
+#ifndef ENHANCED_UNITY_STRESS_DRIFT_MIN_MICROS
+#define ENHANCED_UNITY_STRESS_DRIFT_MIN_MICROS 100
+#endif
+
+// Fewest iterations a drift is judged from
+#ifndef ENHANCED_UNITY_STRESS_DRIFT_MIN_RUNS
+#define ENHANCED_UNITY_STRESS_DRIFT_MIN_RUNS 8
+#endif
+
+namespace enhanced_unity_host {
+
+struct StressOptions {
+    uint32_t iterations = 0;    // per test; 0 = unset
+    uint32_t budgetMillis = 0;  // wall time per test; 0 = unset
+    bool shuffle = false;
+    uint64_t seed = 0;          // of the shuffled order
+    bool interleaved = false;   // rounds are driven by the caller, not runTest
+
+    bool active() const { return iterations > 1 || budgetMillis > 0 || shuffle; }
+
+    // True if a test that ran `runs` times for `spent` µs is to run again
+    bool wantsMore(uint32_t runs, ::enhanced_unity::TimeMicros spent) const {
+        if (runs == 0) {
+            return true;
+        }
+        if ((iterations == 0 && budgetMillis == 0) || (iterations > 0 && runs >= iterations)) {
+            return false;
+        }
+        return budgetMillis == 0 || spent < (::enhanced_unity::TimeMicros)budgetMillis * 1000;
+    }
+};
+
+// A shuffle seed of 0 is replaced by one from the clock
+inline uint64_t stressSeed(uint64_t seed) {
+    if (seed != 0) {
+        return seed;
+    }
+    uint64_t clock = (uint64_t)::enhanced_unity::nowMicros();
+    return ::enhanced_unity::splitMix64(clock);
+}
+
+// Set from the environment on first use; --repeat, --repeat-for, --shuffle
+// and ENHANCED_UNITY_SET_REPEAT() change it before the tests run
+inline StressOptions& stressOptions() {
+    static StressOptions options = []() {
+        StressOptions initial;
+        const char* text = getenv("ENHANCED_UNITY_REPEAT");
+        if (text != nullptr && *text != '\0') {
+            initial.iterations = (uint32_t)strtoul(text, nullptr, 10);
+        }
+        text = getenv("ENHANCED_UNITY_REPEAT_FOR_MS");
+        if (text != nullptr && *text != '\0') {
+            initial.budgetMillis = (uint32_t)strtoul(text, nullptr, 10);
+        }
+        text = getenv("ENHANCED_UNITY_SHUFFLE");
+        if (text != nullptr && *text != '\0') {
+            initial.shuffle = true;
+            initial.seed = stressSeed((uint64_t)strtoull(text, nullptr, 0));
+        }
+        return initial;
+    }();
+    return options;
+}
+
+// Iterations of one test
+struct StressStats {
+    const char* name;
+    void (*function)();
+    uint32_t runs;
+    uint32_t passes;
+    uint32_t firstFailure;  // 1-based iteration; 0 = none
+    ::enhanced_unity::TimeMicros spent;
+    std::vector<::enhanced_unity::TimeMicros> durations;
+};
+
+enum StressClass {
+    STRESS_FAILING,
+    STRESS_FLAKY,
+    STRESS_DRIFTING,
+    STRESS_STABLE
+};
+
+struct StressSummary {
+    double meanMicros;
+    double stddevMicros;
+    ::enhanced_unity::TimeMicros p99Micros;
+    double drift;  // trend from first to last iteration, as a fraction of the mean
+    StressClass kind;
+};
+
+inline StressSummary summarizeStress(const StressStats& stats) {
+    StressSummary summary = { 0.0, 0.0, 0, 0.0, STRESS_STABLE };
+    size_t n = stats.durations.size();
+    if (n == 0) {
+        return summary;
+    }
+    // Welford's mean/variance alongside the sums of the trend line
+    double mean = 0.0;
+    double squares = 0.0;
+    double meanIndex = (double)(n - 1) / 2.0;
+    double covariance = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double value = (double)stats.durations[i];
+        double delta = value - mean;
+        mean += delta / (double)(i + 1);
+        squares += delta * (value - mean);
+    }
+    double indexSquares = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double offset = (double)i - meanIndex;
+        covariance += offset * ((double)stats.durations[i] - mean);
+        indexSquares += offset * offset;
+    }
+    summary.meanMicros = mean;
+    summary.stddevMicros = n > 1 ? std::sqrt(squares / (double)(n - 1)) : 0.0;
+
+    std::vector<::enhanced_unity::TimeMicros> sorted(stats.durations);
+    size_t rank = (n * 99 + 99) / 100;  // nearest rank
+    std::nth_element(sorted.begin(), sorted.begin() + (rank - 1), sorted.end());
+    summary.p99Micros = sorted[rank - 1];
+
+    double correlation = 0.0;
+    if (indexSquares > 0.0 && squares > 0.0 && mean > 0.0) {
+        double slope = covariance / indexSquares;
+        summary.drift = slope * (double)(n - 1) / mean;
+        correlation = covariance / std::sqrt(indexSquares * squares);
+    }
+
+    if (stats.passes == 0) {
+        summary.kind = STRESS_FAILING;
+    } else if (stats.passes < stats.runs) {
+        summary.kind = STRESS_FLAKY;
+    } else if (n >= ENHANCED_UNITY_STRESS_DRIFT_MIN_RUNS && correlation >= 0.5 &&
+               summary.drift * 100.0 >= ENHANCED_UNITY_STRESS_DRIFT_PERCENT &&
+               summary.drift * mean >= ENHANCED_UNITY_STRESS_DRIFT_MIN_MICROS) {
+        summary.kind = STRESS_DRIFTING;
+    }
+    return summary;
+}
+
+inline const char* stressClassText(StressClass kind) {
+    switch (kind) {
+        case STRESS_FAILING: return "FAILING";
+        case STRESS_FLAKY: return "FLAKY";
+        case STRESS_DRIFTING: return "DRIFTING";
+        default: return "STABLE";
+    }
+}
+
+// Per-test iterations, in order of first run; parallel workers add to it
+class StressRecorder {
+public:
+    void note(const char* name, void (*function)(), bool passed, ::enhanced_unity::TimeMicros micros) {
+        ::enhanced_unity::SpinLockGuard guard(lock_);
+        auto found = index_.find(function);
+        if (found == index_.end()) {
+            found = index_.emplace(function, tests_.size()).first;
+            StressStats fresh = { name, function, 0, 0, 0, 0, {} };
+            tests_.push_back(fresh);
+        }
+        StressStats& stats = tests_[found->second];
+        stats.runs++;
+        if (passed) {
+            stats.passes++;
+        } else if (stats.firstFailure == 0) {
+            stats.firstFailure = stats.runs;
+        }
+        stats.spent += micros;
+        stats.durations.push_back(micros);
+        iterations_++;
+    }
+
+    // True if `function` is to run again under the stress options
+    bool wantsMore(void (*function)()) {
+        ::enhanced_unity::SpinLockGuard guard(lock_);
+        auto found = index_.find(function);
+        if (found == index_.end()) {
+            return true;
+        }
+        const StressStats& stats = tests_[found->second];
+        return stressOptions().wantsMore(stats.runs, stats.spent);
+    }
+
+    uint64_t iterations() {
+        ::enhanced_unity::SpinLockGuard guard(lock_);
+        return iterations_;
+    }
+
+    // Read once the runners have finished
+    const std::vector<StressStats>& tests() const { return tests_; }
+
+private:
+    ::enhanced_unity::SpinLock lock_;
+    std::vector<StressStats> tests_;
+    std::unordered_map<void (*)(), size_t> index_;
+    uint64_t iterations_ = 0;
+};
+
+inline StressRecorder& stressRecorder() {
+    static StressRecorder recorder;
+    return recorder;
+}
+
+// Failing and flaky tests first, then drifting and stable ones
+inline void reportStressResults() {
+    const StressOptions& options = stressOptions();
+    const std::vector<StressStats>& tests = stressRecorder().tests();
+    if (!options.active() || tests.empty()) {
+        return;
+    }
+    std::vector<StressSummary> summaries;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < tests.size(); i++) {
+        summaries.push_back(summarizeStress(tests[i]));
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&summaries](size_t a, size_t b) {
+        return summaries[a].kind < summaries[b].kind;
+    });
+    int unstable = 0;
+    for (const StressSummary& summary : summaries) {
+        unstable += summary.kind != STRESS_STABLE ? 1 : 0;
+    }
+
+    ::enhanced_unity::print("=== Stress results: %d test(s), %d unstable", (int)tests.size(), unstable);
+    if (options.iterations > 0) {
+        ::enhanced_unity::print(" | repeat %lu", (unsigned long)options.iterations);
+    }
+    if (options.budgetMillis > 0) {
+        ::enhanced_unity::print(" | for %lu ms", (unsigned long)options.budgetMillis);
+    }
+    if (options.shuffle) {
+        ::enhanced_unity::print(" | shuffled, seed 0x%08lx%08lx", (unsigned long)(options.seed >> 32),
+                                (unsigned long)(options.seed & 0xffffffffUL));
+    }
+    ::enhanced_unity::print("\n");
+    for (size_t i : order) {
+        const StressStats& stats = tests[i];
+        const StressSummary& summary = summaries[i];
+        ::enhanced_unity::print("  [%-8s] %-32s runs %6lu | pass %5.1f%% | first failure ",
+                                stressClassText(summary.kind), stats.name, (unsigned long)stats.runs,
+                                100.0 * (double)stats.passes / (double)stats.runs);
+        if (stats.firstFailure > 0) {
+            ::enhanced_unity::print("#%-6lu", (unsigned long)stats.firstFailure);
+        } else {
+            ::enhanced_unity::print("%-7s", "-");
+        }
+        ::enhanced_unity::print(" | mean %9.3f sd %9.3f p99 %9.3f ms | drift %+5.0f%%\n",
+                                summary.meanMicros / 1000.0, summary.stddevMicros / 1000.0,
+                                (double)summary.p99Micros / 1000.0, summary.drift * 100.0);
+    }
+    ::enhanced_unity::print("=======================================================\n");
+}
+
+} // namespace enhanced_unity_host
+
+// Repeat every following RUN_TEST_DEBUG `count` times or for `millis` of
+// wall time (0 = unset)
+#define ENHANCED_UNITY_SET_REPEAT(count, millis) \
+    do { \
+        ::enhanced_unity_host::stressOptions().iterations = (uint32_t)(count); \
+        ::enhanced_unity_host::stressOptions().budgetMillis = (uint32_t)(millis); \
+    } while(0)
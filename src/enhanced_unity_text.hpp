@@ -0,0 +1,343 @@
+#pragma once
+
+// ============================================================================
+// STRING AND PAYLOAD ASSERTIONS
+// ============================================================================
+// TEST_ASSERT_EQUAL_STRING_DEBUG, TEST_ASSERT_EQUAL_STRING_LEN_DEBUG and
+// TEST_ASSERT_EQUAL_PAYLOAD_DEBUG share one engine: measure both texts
+// (a NULL text measures 0 and only equals another NULL), find the first
+// differing byte with the kernel of the array assertions, and keep
+// ENHANCED_UNITY_RECORD_STRING_LENGTH bytes of each text around it. The
+// report names the byte, its line and column, and shows both windows with a
+// caret under the divergence instead of the whole text.
+//
+// On native builds ENHANCED_UNITY_TEXT_DIFF 1 also prints a line diff of a
+// failing multi-line text under its report. The diff trims the common head
+// and tail, then runs Myers' algorithm in at most
+// ENHANCED_UNITY_TEXT_DIFF_MEMORY bytes; texts that need more are only noted.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// 1 = line diff under failing multi-line texts (native only)
+#ifndef ENHANCED_UNITY_TEXT_DIFF
+#define ENHANCED_UNITY_TEXT_DIFF 0
+#endif
+
+// Bytes one diff may allocate for line tables and its edit trace
+#ifndef ENHANCED_UNITY_TEXT_DIFF_MEMORY
+#define ENHANCED_UNITY_TEXT_DIFF_MEMORY 262144
+#endif
+
+// Diff lines printed per assertion before the rest is summarised
+#ifndef ENHANCED_UNITY_TEXT_DIFF_LINES
+#define ENHANCED_UNITY_TEXT_DIFF_LINES 40
+#endif
+
+#if ENHANCED_UNITY_TEXT_DIFF && defined(CONFIGMGR_NATIVE)
+#include <algorithm>
+#include <vector>
+#endif
+
+namespace enhanced_unity {
+
+inline bool isUtf8Continuation(uint8_t c) { return (c & 0xC0) == 0x80; }
+
+// Bytes before the terminator; NULL measures 0
+inline size_t textLength(const char* text) {
+    return text != nullptr ? strlen(text) : 0;
+}
+
+// Bytes before the terminator, at most `limit`
+inline size_t textLength(const char* text, size_t limit) {
+    if (text == nullptr) {
+        return 0;
+    }
+    const void* end = memchr(text, '\0', limit);
+    return end != nullptr ? (size_t)(static_cast<const char*>(end) - text) : limit;
+}
+
+// Write the record of a text comparison. Both windows start at the same
+// byte: the start of the divergent line, at most a third of the window
+// before the divergence, and never inside a UTF-8 sequence.
+ENHANCED_UNITY_COLD inline void recordTexts(uint8_t kind, bool passed, int line, const char* fileName,
+                        const uint8_t* expected, size_t expectedLength,
+                        const uint8_t* actual, size_t actualLength, size_t offset) {
+    RecordBuffer& buffer = counters().recordBuffer();
+    SpinLockGuard guard(buffer.lock);
+    AssertRecord* record = reserveRecord(buffer, kind, passed, line, fileName);
+    if (record == nullptr) {
+        return;
+    }
+    record->value.s.expectedLength = (TextLength)expectedLength;
+    record->value.s.actualLength = (TextLength)actualLength;
+    record->value.s.nulls = (expected == nullptr ? TEXT_EXPECTED_NULL : 0) |
+                            (actual == nullptr ? TEXT_ACTUAL_NULL : 0);
+    record->value.s.line = 0;
+    record->value.s.column = 0;
+    size_t start = 0;
+    if (!passed && record->value.s.nulls == 0) {
+        start = offset - (offset < ENHANCED_UNITY_RECORD_STRING_LENGTH / 3 ? offset
+                                                                            : ENHANCED_UNITY_RECORD_STRING_LENGTH / 3);
+        const void* newline = memchr(expected + start, '\n', offset - start);
+        while (newline != nullptr) {
+            start = (size_t)(static_cast<const uint8_t*>(newline) - expected) + 1;
+            newline = memchr(expected + start, '\n', offset - start);
+        }
+        while (start < offset && isUtf8Continuation(expected[start])) {
+            start++;
+        }
+        // Line and column of the divergence, counted through the whole head
+        size_t lineStart = 0;
+        size_t lines = 1;
+        for (const void* p = memchr(expected, '\n', offset); p != nullptr;
+             p = memchr(expected + lineStart, '\n', offset - lineStart)) {
+            lineStart = (size_t)(static_cast<const uint8_t*>(p) - expected) + 1;
+            lines++;
+        }
+        // Characters up to the one holding `offset`, which may be mid-sequence
+        size_t column = 0;
+        for (size_t i = lineStart; i <= offset; i++) {
+            column += i == expectedLength || !isUtf8Continuation(expected[i]) ? 1 : 0;
+        }
+        record->value.s.line = (TextLength)lines;
+        record->value.s.column = (TextLength)column;
+        record->value.s.offset = (TextLength)offset;
+    } else {
+        record->value.s.offset = 0;
+    }
+    record->value.s.lead = (uint8_t)(record->value.s.offset - start);
+    const uint8_t* texts[2] = { expected, actual };
+    size_t lengths[2] = { expectedLength, actualLength };
+    char* windows[2] = { record->value.s.expected, record->value.s.actual };
+    uint8_t* kept[2] = { &record->value.s.expectedKept, &record->value.s.actualKept };
+    for (int i = 0; i < 2; i++) {
+        size_t bytes = 0;
+        if (texts[i] != nullptr && lengths[i] > start) {
+            bytes = lengths[i] - start < ENHANCED_UNITY_RECORD_STRING_LENGTH ? lengths[i] - start
+                                                                             : ENHANCED_UNITY_RECORD_STRING_LENGTH;
+            // End before a UTF-8 sequence the window would cut
+            while (bytes > record->value.s.lead && start + bytes < lengths[i] &&
+                   isUtf8Continuation(texts[i][start + bytes])) {
+                bytes--;
+            }
+            memcpy(windows[i], texts[i] + start, bytes);
+        }
+        *kept[i] = (uint8_t)bytes;
+    }
+}
+
+#if ENHANCED_UNITY_TEXT_DIFF && defined(CONFIGMGR_NATIVE)
+
+struct TextLine {
+    const char* text;
+    size_t length;
+};
+
+inline bool sameLine(const TextLine& a, const TextLine& b) {
+    return a.length == b.length && memcmp(a.text, b.text, a.length) == 0;
+}
+
+// Lines of text, each without its '\n'; false once `limit` lines are exceeded
+inline bool splitLines(const char* text, size_t length, size_t limit, std::vector<TextLine>& lines) {
+    size_t start = 0;
+    while (start < length) {
+        if (lines.size() >= limit) {
+            return false;
+        }
+        const void* newline = memchr(text + start, '\n', length - start);
+        size_t end = newline != nullptr ? (size_t)(static_cast<const char*>(newline) - text) : length;
+        lines.push_back(TextLine{ text + start, end - start });
+        start = end + 1;
+    }
+    return true;
+}
+
+// One diff line: ' ' context, '-' expected only, '+' actual only. Long lines are cut.
+inline void printDiffLine(char marker, const TextLine& line) {
+    int shown = line.length > 120 ? 117 : (int)line.length;
+    ENHANCED_UNITY_PRINT("    %c%.*s%s\n", marker, shown, line.text, line.length > 120 ? "..." : "");
+}
+
+// Myers' shortest edit script of expected[0, n) to actual[0, m), appended as
+// one marker per output line; false when more than `maxEdits` edits are needed.
+// The trace keeps the diagonals of every round, 2d + 1 of them in round d.
+inline bool shortestEditScript(const TextLine* expected, long n, const TextLine* actual, long m, long maxEdits,
+                               std::vector<char>& script) {
+    long offset = maxEdits + 1;
+    std::vector<long> v((size_t)(2 * offset + 1), 0);
+    std::vector<long> trace;
+    trace.reserve((size_t)((maxEdits + 1) * (maxEdits + 1)));
+    long d = 0;
+    bool found = false;
+    for (; d <= maxEdits && !found; d++) {
+        for (long k = -d; k <= d; k += 2) {
+            long x = k == -d || (k != d && v[(size_t)(offset + k - 1)] < v[(size_t)(offset + k + 1)])
+                   ? v[(size_t)(offset + k + 1)] : v[(size_t)(offset + k - 1)] + 1;
+            long y = x - k;
+            while (x < n && y < m && sameLine(expected[x], actual[y])) {
+                x++;
+                y++;
+            }
+            v[(size_t)(offset + k)] = x;
+            if (x >= n && y >= m) {
+                found = true;
+            }
+        }
+        trace.insert(trace.end(), v.begin() + (offset - d), v.begin() + (offset + d + 1));
+    }
+    if (!found) {
+        return false;
+    }
+    // Walk back through the rounds; round r starts at r * r in the trace
+    size_t first = script.size();
+    long x = n;
+    long y = m;
+    for (d = d - 1; d >= 0; d--) {
+        long k = x - y;
+        long previousK = k;
+        if (d > 0) {
+            const long* previous = &trace[(size_t)((d - 1) * (d - 1))] + (d - 1);  // indexed by k
+            previousK = k == -d || (k != d && previous[k - 1] < previous[k + 1]) ? k + 1 : k - 1;
+            long previousX = previous[previousK];
+            long previousY = previousX - previousK;
+            while (x > previousX && y > previousY) {
+                script.push_back(' ');
+                x--;
+                y--;
+            }
+            script.push_back(previousK == k + 1 ? '+' : '-');
+            x = previousX;
+            y = previousY;
+        } else {
+            while (x > 0 && y > 0) {
+                script.push_back(' ');
+                x--;
+                y--;
+            }
+        }
+    }
+    std::reverse(script.begin() + (long)first, script.end());
+    return true;
+}
+
+// Line diff of two texts in hunks with two lines of context
+inline void printTextDiff(const char* expected, size_t expectedLength, const char* actual, size_t actualLength) {
+    const size_t budget = ENHANCED_UNITY_TEXT_DIFF_MEMORY;
+    const size_t lineLimit = budget / 2 / sizeof(TextLine);
+    std::vector<TextLine> expectedLines;
+    std::vector<TextLine> actualLines;
+    if (!splitLines(expected, expectedLength, lineLimit / 2, expectedLines) ||
+        !splitLines(actual, actualLength, lineLimit / 2, actualLines)) {
+        ENHANCED_UNITY_PRINT("    [DIFF] skipped: more lines than ENHANCED_UNITY_TEXT_DIFF_MEMORY allows\n");
+        return;
+    }
+    long n = (long)expectedLines.size();
+    long m = (long)actualLines.size();
+    long head = 0;
+    while (head < n && head < m && sameLine(expectedLines[(size_t)head], actualLines[(size_t)head])) {
+        head++;
+    }
+    long tail = 0;
+    while (tail < n - head && tail < m - head &&
+           sameLine(expectedLines[(size_t)(n - 1 - tail)], actualLines[(size_t)(m - 1 - tail)])) {
+        tail++;
+    }
+    // The trace of d rounds holds (d + 1)^2 diagonals
+    size_t traceBudget = (budget - (size_t)(n + m) * sizeof(TextLine)) / sizeof(long);
+    long maxEdits = 0;
+    while ((size_t)((maxEdits + 2) * (maxEdits + 2)) <= traceBudget && maxEdits < (n + m - 2 * head - 2 * tail)) {
+        maxEdits++;
+    }
+    std::vector<char> script(head, ' ');
+    if (!shortestEditScript(expectedLines.data() + head, n - head - tail, actualLines.data() + head,
+                            m - head - tail, maxEdits, script)) {
+        ENHANCED_UNITY_PRINT("    [DIFF] skipped: needs more than %ld line edits, over ENHANCED_UNITY_TEXT_DIFF_MEMORY\n",
+               maxEdits);
+        return;
+    }
+    script.insert(script.end(), (size_t)tail, ' ');
+
+    // Print each change with its context; runs of more than 4 equal lines split hunks
+    const long context = 2;
+    long printed = 0;
+    long omitted = 0;
+    long x = 0;
+    long y = 0;
+    long lastShown = -1;  // script index of the last line printed
+    for (long i = 0; i < (long)script.size(); i++) {
+        bool near = false;
+        for (long j = i - context; j <= i + context && !near; j++) {
+            near = j >= 0 && j < (long)script.size() && script[(size_t)j] != ' ';
+        }
+        if (near) {
+            if (lastShown != i - 1) {
+                if (printed < ENHANCED_UNITY_TEXT_DIFF_LINES) {
+                    ENHANCED_UNITY_PRINT("    @@ expected line %ld, actual line %ld @@\n", x + 1, y + 1);
+                }
+            }
+            char marker = script[(size_t)i];
+            const TextLine& line = marker == '+' ? actualLines[(size_t)y] : expectedLines[(size_t)x];
+            if (printed < ENHANCED_UNITY_TEXT_DIFF_LINES) {
+                printDiffLine(marker, line);
+                printed++;
+            } else if (marker != ' ') {
+                omitted++;
+            }
+            lastShown = i;
+        }
+        char marker = script[(size_t)i];
+        x += marker != '+' ? 1 : 0;
+        y += marker != '-' ? 1 : 0;
+    }
+    if (omitted > 0) {
+        ENHANCED_UNITY_PRINT("    [DIFF] %ld more changed line(s) not shown\n", omitted);
+    }
+}
+
+#endif // ENHANCED_UNITY_TEXT_DIFF && CONFIGMGR_NATIVE
+
+// Two texts of known length compared bytewise, as one assertion. The same
+// buffer (or two NULLs) passes; one NULL fails against anything.
+inline void compareTexts(uint8_t kind, const void* expected, size_t expectedLength,
+                         const void* actual, size_t actualLength, int line, const char* fileName,
+                         bool recordPasses) {
+    const uint8_t* expectedBytes = static_cast<const uint8_t*>(expected);
+    const uint8_t* actualBytes = static_cast<const uint8_t*>(actual);
+    size_t common = expectedLength < actualLength ? expectedLength : actualLength;
+    size_t offset = 0;
+    bool passed;
+    if (expectedBytes == nullptr || actualBytes == nullptr) {
+        passed = expectedBytes == actualBytes;
+    } else {
+        offset = expectedBytes == actualBytes ? common : firstMismatch(expectedBytes, actualBytes, common);
+        passed = offset == common && expectedLength == actualLength;
+    }
+    if (ENHANCED_UNITY_UNLIKELY(countOutcome(passed, recordPasses))) {
+        recordTexts(kind, passed, line, fileName, expectedBytes, expectedLength, actualBytes, actualLength, offset);
+#if ENHANCED_UNITY_TEXT_DIFF && defined(CONFIGMGR_NATIVE)
+        if (!passed && expectedBytes != nullptr && actualBytes != nullptr &&
+            ENHANCED_UNITY_VERBOSITY <= VERBOSITY_FAILING_ASSERTIONS && !ENHANCED_UNITY_WIRE_PROTOCOL &&
+            (memchr(expected, '\n', expectedLength) != nullptr || memchr(actual, '\n', actualLength) != nullptr)) {
+            flushRecords();  // the report line first, the diff under it
+            printTextDiff(static_cast<const char*>(expected), expectedLength,
+                          static_cast<const char*>(actual), actualLength);
+        }
+#endif
+    }
+}
+
+// NUL-terminated strings
+inline void compareStrings(uint8_t kind, const char* expected, const char* actual, int line,
+                           const char* fileName, bool recordPasses) {
+    compareTexts(kind, expected, textLength(expected), actual, textLength(actual), line, fileName, recordPasses);
+}
+
+// Strings compared up to their terminators or `length` bytes, whichever comes first
+inline void compareStrings(uint8_t kind, const char* expected, const char* actual, size_t length, int line,
+                           const char* fileName, bool recordPasses) {
+    compareTexts(kind, expected, textLength(expected, length), actual, textLength(actual, length), line,
+                 fileName, recordPasses);
+}
+
+} // namespace enhanced_unity
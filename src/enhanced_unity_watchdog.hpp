@@ -0,0 +1,286 @@
+#pragma once
+
+// ============================================================================
+// TEST TIMEOUTS AND WATCHDOG
+// ============================================================================
+// A test may get a deadline: ENHANCED_UNITY_TEST_TIMEOUT_MS for every test,
+// RUN_TEST_TIMEOUT_DEBUG(fn, ms) or a "timeout=MS" tag for one. A test that
+// overruns is recorded as an [ABORTED] method with a timeout reason, listed
+// under "Timed-out test methods" in the final summary, and the run goes on.
+//
+//   native, in process   POSIX: the test runs in a forked worker that is
+//                        killed at the deadline, as in the process pool. On
+//                        parallel runner threads and off POSIX it runs on the
+//                        thread's helper with its own counters and output
+//                        capture; an overrunning helper is abandoned: it
+//                        skips tearDown, its state is never read again
+//   native, process pool the parent kills the worker and starts a fresh one
+//   ESP32                the test task is subscribed to the task watchdog,
+//                        which reboots the chip on overrun. The hung test is
+//                        remembered in RTC memory, so the restarted run books
+//                        it as aborted and skips it
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Deadline for every test in ms; 0 = none. On native, the
+// ENHANCED_UNITY_TIMEOUT_MS environment variable overrides it at run time.
+#ifndef ENHANCED_UNITY_TEST_TIMEOUT_MS
+#define ENHANCED_UNITY_TEST_TIMEOUT_MS 0
+#endif
+
+#if (defined(ESP32) || defined(ARDUINO_ARCH_ESP32)) && !defined(CONFIGMGR_NATIVE)
+#define ENHANCED_UNITY_TASK_WATCHDOG 1
+#else
+#define ENHANCED_UNITY_TASK_WATCHDOG 0
+#endif
+
+#ifdef CONFIGMGR_NATIVE
+#include <cstdlib>
+#include <unordered_map>
+#endif
+
+#if ENHANCED_UNITY_TASK_WATCHDOG
+#include <esp_attr.h>
+#include <esp_idf_version.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <string.h>
+
+// Hung tests remembered across watchdog reboots
+#ifndef ENHANCED_UNITY_WATCHDOG_SKIPS
+#define ENHANCED_UNITY_WATCHDOG_SKIPS 8
+#endif
+#endif
+
+namespace enhanced_unity {
+
+// Count the timed-out method and keep it for the summary list
+inline void noteTimedOutMethod(const char* methodName, TimeMicros elapsed) {
+    CounterContext& c = counters();
+    c.methodTimeoutCount++;
+    MethodTiming timing = { methodName, elapsed };
+    c.timedOutMethods.add(timing);
+}
+
+inline void reportTimedOutMethods() {
+    const CounterContext& c = counters();
+    if (ENHANCED_UNITY_TIMED_OUT_METHODS == 0 || c.methodTimeoutCount == 0) {
+        return;
+    }
+    TimedOutMethods timedOut = c.timedOutMethods;
+    timedOut.sortDescending();
+    ENHANCED_UNITY_PRINT("=== Timed-out test methods: %d\n", c.methodTimeoutCount);
+    for (int i = 0; i < timedOut.count; i++) {
+        ENHANCED_UNITY_PRINT("  %2d. [%6lu.%03lu ms] %" ENHANCED_UNITY_FLASH_S "\n", i + 1,
+               wholeMillis(timedOut.entries[i].duration), fractionMillis(timedOut.entries[i].duration),
+               timedOut.entries[i].name);
+    }
+    ENHANCED_UNITY_PRINT("=======================================================\n");
+}
+
+#ifdef CONFIGMGR_NATIVE
+// Deadline of tests without their own: ENHANCED_UNITY_TIMEOUT_MS from the
+// environment, else ENHANCED_UNITY_TEST_TIMEOUT_MS; --timeout=MS sets it
+inline uint32_t& defaultTestTimeout() {
+    static uint32_t millis = []() {
+        const char* text = getenv("ENHANCED_UNITY_TIMEOUT_MS");
+        return text != nullptr && *text != '\0' ? (uint32_t)strtoul(text, nullptr, 10)
+                                                : (uint32_t)ENHANCED_UNITY_TEST_TIMEOUT_MS;
+    }();
+    return millis;
+}
+
+// Per-test deadlines; set from the thread that queues tests, never while a
+// parallel batch is running
+inline std::unordered_map<void (*)(), uint32_t>& testTimeouts() {
+    static std::unordered_map<void (*)(), uint32_t> timeouts;
+    return timeouts;
+}
+
+inline void setTestTimeout(void (*function)(), uint32_t millis) {
+    testTimeouts()[function] = millis;
+}
+
+// Deadline of `function` in ms; 0 = none
+inline uint32_t testTimeout(void (*function)()) {
+    const std::unordered_map<void (*)(), uint32_t>& timeouts = testTimeouts();
+    auto found = timeouts.find(function);
+    return found != timeouts.end() ? found->second : defaultTestTimeout();
+}
+#endif
+
+#if ENHANCED_UNITY_TASK_WATCHDOG
+
+// RTC slow memory is kept across software and watchdog resets
+struct WatchdogMemory {
+    uint32_t magic;
+    uint32_t armed;       // name hash of the running test; 0 = none
+    uint32_t armedLimit;  // its deadline in ms
+    uint32_t hungCount;
+    uint32_t hung[ENHANCED_UNITY_WATCHDOG_SKIPS];
+    uint32_t hungLimit[ENHANCED_UNITY_WATCHDOG_SKIPS];
+    uint8_t hungReset[ENHANCED_UNITY_WATCHDOG_SKIPS];  // esp_reset_reason_t of the reboot
+};
+
+static const uint32_t kWatchdogMagic = 0x44575545;  // "EUWD"
+
+} // namespace enhanced_unity
+
+extern enhanced_unity::WatchdogMemory _enhancedUnityWatchdog;
+
+namespace enhanced_unity {
+
+// FNV-1a (32-bit); never 0, which marks "no test armed"
+inline uint32_t watchdogHash(const char* testName) {
+    uint32_t hash = 0x811c9dc5UL;
+    for (; *testName != '\0'; testName++) {
+        hash = (hash ^ (uint8_t)*testName) * 0x01000193UL;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+// On first use after boot, a test still armed means the chip reset while it
+// ran; it joins the hung list. Power-on and reset-pin boots start clean.
+inline WatchdogMemory& watchdogMemory() {
+    static bool checked = false;
+    WatchdogMemory& memory = _enhancedUnityWatchdog;
+    if (!checked) {
+        checked = true;
+        esp_reset_reason_t reset = esp_reset_reason();
+        if (reset == ESP_RST_POWERON || reset == ESP_RST_EXT || memory.magic != kWatchdogMagic ||
+            memory.hungCount > ENHANCED_UNITY_WATCHDOG_SKIPS) {
+            memset(&memory, 0, sizeof(memory));
+            memory.magic = kWatchdogMagic;
+        } else if (memory.armed != 0) {
+            if (memory.hungCount < ENHANCED_UNITY_WATCHDOG_SKIPS) {
+                memory.hung[memory.hungCount] = memory.armed;
+                memory.hungLimit[memory.hungCount] = memory.armedLimit;
+                memory.hungReset[memory.hungCount] = (uint8_t)reset;
+                memory.hungCount++;
+            }
+            memory.armed = 0;
+        }
+    }
+    return memory;
+}
+
+#ifdef CONFIG_ESP_TASK_WDT_TIMEOUT_S
+#define ENHANCED_UNITY_TASK_WDT_DEFAULT_MS ((uint32_t)CONFIG_ESP_TASK_WDT_TIMEOUT_S * 1000)
+#else
+#define ENHANCED_UNITY_TASK_WDT_DEFAULT_MS 5000
+#endif
+
+#ifdef CONFIG_ESP_TASK_WDT_PANIC
+#define ENHANCED_UNITY_TASK_WDT_DEFAULT_PANIC true
+#else
+#define ENHANCED_UNITY_TASK_WDT_DEFAULT_PANIC false
+#endif
+
+// IDF 4 counts the timeout in whole seconds, so shorter limits round up
+inline void configureTaskWatchdog(uint32_t limitMillis, bool panic) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_task_wdt_config_t config = {};
+    config.timeout_ms = limitMillis;
+    config.idle_core_mask = 0;
+#ifdef CONFIG_ESP_TASK_WDT_CHECK_IDLE_TASK_CPU0
+    config.idle_core_mask |= 1 << 0;
+#endif
+#ifdef CONFIG_ESP_TASK_WDT_CHECK_IDLE_TASK_CPU1
+    config.idle_core_mask |= 1 << 1;
+#endif
+    config.trigger_panic = panic;
+    if (esp_task_wdt_reconfigure(&config) == ESP_ERR_INVALID_STATE) {
+        esp_task_wdt_init(&config);
+    }
+#else
+    esp_task_wdt_init((limitMillis + 999) / 1000, panic);
+#endif
+}
+
+// Book a test that hung (or crashed the chip) on a previous boot as aborted
+inline void recordWatchdogAbort(const char* testName, uint32_t limitMillis, uint8_t reset) {
+    char reason[72];
+    bool watchdog = reset == ESP_RST_TASK_WDT || reset == ESP_RST_INT_WDT || reset == ESP_RST_WDT;
+    if (watchdog) {
+        snprintf(reason, sizeof(reason), "timed out: exceeded %lu ms (task watchdog reset)",
+                 (unsigned long)limitMillis);
+    } else {
+        snprintf(reason, sizeof(reason), "device reset while the test ran (reset reason %d)", (int)reset);
+    }
+    startMethodCounters(testName);
+    stopMethodMeasurements();
+    resolveMethodCounters();
+    CounterContext& c = counters();
+    c.methodFailureCount++;
+    c.methodTotalFailureCount++;
+    c.methodFileFailureCount++;
+    c.extraFailureCount++;
+    c.assertionFileCount += c.assertionCount;
+    c.assertionFileFailureCount += c.assertionFailureCount;
+    foldMethodMeasurements();
+    if (watchdog) {
+        noteTimedOutMethod(testName, (TimeMicros)limitMillis * 1000);
+    }
+    if (ENHANCED_UNITY_VERBOSITY <= VERBOSITY_TEST_METHODS) {
+        ENHANCED_UNITY_PRINT("[ABORTED]     - %s : %s\n", testName, reason);
+    }
+    notifyMethodResult(reason);
+    flushOutput(true);
+}
+
+// False if the test hung on a previous boot (it has been booked and must not
+// run again); otherwise the task watchdog is armed with the test's deadline
+inline bool watchdogBegin(const char* testName, uint32_t limitMillis) {
+    if (limitMillis == 0) {
+        return true;
+    }
+    WatchdogMemory& memory = watchdogMemory();
+    uint32_t hash = watchdogHash(testName);
+    for (uint32_t i = 0; i < memory.hungCount; i++) {
+        if (memory.hung[i] == hash) {
+            recordWatchdogAbort(testName, memory.hungLimit[i], memory.hungReset[i]);
+            return false;
+        }
+    }
+    if (memory.hungCount >= ENHANCED_UNITY_WATCHDOG_SKIPS) {
+        return true;  // another reboot could not be recorded: run unguarded
+    }
+    flushOutput(true);  // what the test printed so far survives the reboot
+    memory.armed = hash;
+    memory.armedLimit = limitMillis;
+    configureTaskWatchdog(limitMillis, true);
+    esp_task_wdt_add(nullptr);
+    return true;
+}
+
+inline void watchdogEnd() {
+    WatchdogMemory& memory = watchdogMemory();
+    if (memory.armed == 0) {
+        return;
+    }
+    esp_task_wdt_delete(nullptr);
+    configureTaskWatchdog(ENHANCED_UNITY_TASK_WDT_DEFAULT_MS, ENHANCED_UNITY_TASK_WDT_DEFAULT_PANIC);
+    memory.armed = 0;
+}
+
+// A completed run forgets its hung tests, so the next one retries them
+inline void watchdogRunFinished() {
+    WatchdogMemory& memory = watchdogMemory();
+    memory.armed = 0;
+    memory.hungCount = 0;
+}
+
+#endif
+
+} // namespace enhanced_unity
+
+// Bracket one test (setUp, body, tearDown): BEGIN is false when the test must
+// be skipped; END disarms the watchdog
+#if ENHANCED_UNITY_TASK_WATCHDOG
+#define ENHANCED_UNITY_WATCHDOG_BEGIN(testName, timeoutMillis) ::enhanced_unity::watchdogBegin((testName), (timeoutMillis))
+#define ENHANCED_UNITY_WATCHDOG_END() ::enhanced_unity::watchdogEnd()
+#else
+#define ENHANCED_UNITY_WATCHDOG_BEGIN(testName, timeoutMillis) ((void)(timeoutMillis), true)
+#define ENHANCED_UNITY_WATCHDOG_END() do { } while(0)
+#endif
@@ -0,0 +1,536 @@
+#pragma once
+
+// ============================================================================
+// BINARY WIRE PROTOCOL
+// ============================================================================
+// With ENHANCED_UNITY_WIRE_PROTOCOL the report leaves the device as frames
+// instead of ASCII: every frame is COBS-encoded and ends in a 0x00 byte, so
+// a reader can join the stream at any point. Decoded, a frame is
+//
+//   type (1 byte) | fields | CRC-8 (polynomial 0x07) of type and fields
+//
+// Integers are LEB128 varints (signed ones zigzag-encoded), strings a varint
+// length and the bytes, reals the IEEE bits little-endian (4 bytes on
+// targets where double is float). File and method names are sent once as
+// string-table entries and referenced by id afterwards.
+//
+//   'H' hello       version, verbosity, flags (WireHelloFlags)
+//   'T' text        report text, as print() would have written it
+//   'S' string      table ('F' files, 'M' methods), id, name
+//   'A' assertion   kind, passed, format, flags, line, file id, values
+//   'f' file start  suite, file
+//   'm' method      method id
+//   'e' method end  method id, file id, flags (WireMethodFlags), assertions,
+//                   failures, micros [, heap delta, heap peak, stack free]
+//                   [, abort reason]
+//   'F' file end    suite, file, methods, method failures, assertions,
+//                   failures, micros
+//   'R' run end     files, file failures, methods, method failures,
+//                   assertions, failures, micros
+//
+// Assertion lines cost a few bytes instead of a formatted line, and failing
+// assertions are always sent, so the host can rebuild the text report and
+// JSON Lines / TAP / JUnit files (tools/enhanced_unity_decode.cpp). Host and
+// device must be built from the same enhanced_unity.hpp, which numbers the
+// assertion kinds.
+//
+// Included from enhanced_unity.hpp; do not include directly.
+// ============================================================================
+
+// Largest event frame before encoding; longer strings are cut to fit
+#ifndef ENHANCED_UNITY_WIRE_FRAME
+#ifdef __AVR__
+#define ENHANCED_UNITY_WIRE_FRAME 64
+#else
+#define ENHANCED_UNITY_WIRE_FRAME 192
+#endif
+#endif
+
+// Method names remembered with their string-table id
+#ifndef ENHANCED_UNITY_WIRE_METHODS
+#ifdef __AVR__
+#define ENHANCED_UNITY_WIRE_METHODS 8
+#else
+#define ENHANCED_UNITY_WIRE_METHODS 32
+#endif
+#endif
+
+namespace enhanced_unity {
+
+static const uint8_t kWireVersion = 2;
+
+enum WireFrameType : uint8_t {
+    WIRE_HELLO = 'H',
+    WIRE_TEXT = 'T',
+    WIRE_STRING = 'S',
+    WIRE_ASSERTION = 'A',
+    WIRE_FILE_START = 'f',
+    WIRE_METHOD_START = 'm',
+    WIRE_METHOD_END = 'e',
+    WIRE_FILE_END = 'F',
+    WIRE_RUN_END = 'R',
+};
+
+enum WireStringTable : uint8_t {
+    WIRE_FILE_NAMES = 'F',
+    WIRE_METHOD_NAMES = 'M',
+};
+
+enum WireHelloFlags : uint8_t {
+    WIRE_HELLO_FLOAT_REALS = 0x01,  // reals are 4 bytes
+    WIRE_HELLO_TIMING = 0x02,
+    WIRE_HELLO_MEMORY = 0x04,
+};
+
+enum WireMethodFlags : uint8_t {
+    WIRE_METHOD_MEMORY = 0x01,
+    WIRE_METHOD_ABORTED = 0x02,
+};
+
+inline uint8_t wireCrc8(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x80) != 0 ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+// Writes one frame at a time: the payload is COBS-encoded straight from
+// the caller's memory through a small staging buffer
+class CobsEncoder {
+public:
+    explicit CobsEncoder(OutputSink& sink) : sink_(sink) {}
+
+    // Frame `type` and `length` bytes of fields, with CRC and delimiter
+    void frame(uint8_t type, const uint8_t* fields, size_t length) {
+        type_ = type;
+        fields_ = fields;
+        length_ = length;
+        crc_ = wireCrc8(0, type);
+        for (size_t i = 0; i < length; i++) {
+            crc_ = wireCrc8(crc_, fields[i]);
+        }
+        size_t total = length + 2;
+        size_t position = 0;
+        for (;;) {
+            size_t run = 0;
+            while (position + run < total && at(position + run) != 0 && run < 254) {
+                run++;
+            }
+            put((uint8_t)(run + 1));
+            for (size_t i = 0; i < run; i++) {
+                put(at(position + i));
+            }
+            position += run;
+            if (position >= total) {
+                break;
+            }
+            if (run == 254) {
+                continue;  // a full block implies no zero
+            }
+            position++;  // the zero this block stands for
+            if (position == total) {
+                put(1);
+                break;
+            }
+        }
+        put(0);
+        flush();
+    }
+
+    // A lone delimiter, so a reader drops whatever partial frame it holds
+    void delimiter() {
+        put(0);
+        flush();
+    }
+
+private:
+    uint8_t at(size_t i) const {
+        return i == 0 ? type_ : i <= length_ ? fields_[i - 1] : crc_;
+    }
+
+    void put(uint8_t byte) {
+        if (staged_ == sizeof(staging_)) {
+            flush();
+        }
+        staging_[staged_++] = byte;
+    }
+
+    void flush() {
+        if (staged_ > 0) {
+            sink_.write(reinterpret_cast<const char*>(staging_), staged_);
+            staged_ = 0;
+        }
+    }
+
+    OutputSink& sink_;
+    uint8_t type_ = 0;
+    const uint8_t* fields_ = nullptr;
+    size_t length_ = 0;
+    uint8_t crc_ = 0;
+    uint8_t staging_[32];
+    size_t staged_ = 0;
+};
+
+// Builds the fields of one event frame (type first)
+class WireWriter {
+public:
+    explicit WireWriter(uint8_t type) { byte(type); }
+
+    WireWriter& byte(uint8_t value) {
+        if (length < sizeof(data)) {
+            data[length++] = value;
+        }
+        return *this;
+    }
+
+    WireWriter& unsignedVarint(uint64_t value) {
+        while (value >= 0x80) {
+            byte((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        return byte((uint8_t)value);
+    }
+
+    WireWriter& signedVarint(int64_t value) {
+        return unsignedVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    WireWriter& real(double value) {
+        uint8_t bits[sizeof(double)];
+        memcpy(bits, &value, sizeof(bits));
+        for (size_t i = 0; i < sizeof(bits); i++) {
+            byte(bits[i]);  // little-endian on every supported target
+        }
+        return *this;
+    }
+
+    // Length-prefixed; cut so at least `reserve` bytes stay free after it
+    WireWriter& string(const char* text, bool inFlash, size_t reserve = 0) {
+        size_t size = 0;
+        if (text != nullptr) {
+            while ((inFlash ? readFlashByte(text + size) : (uint8_t)text[size]) != 0) {
+                size++;
+            }
+        }
+        size_t room = sizeof(data) - length;
+        room = room > reserve + 2 ? room - reserve - 2 : 0;  // 2: the length varint
+        if (size > room) {
+            size = room;
+        }
+        unsignedVarint(size);
+        for (size_t i = 0; i < size; i++) {
+            byte(inFlash ? readFlashByte(text + i) : (uint8_t)text[i]);
+        }
+        return *this;
+    }
+
+    uint8_t data[ENHANCED_UNITY_WIRE_FRAME];
+    size_t length = 0;
+};
+
+#if ENHANCED_UNITY_WIRE_PROTOCOL
+
+inline void writeTextFrame(const char* data, size_t length) {
+    CobsEncoder(outputSink()).frame(WIRE_TEXT, reinterpret_cast<const uint8_t*>(data), length);
+}
+
+// Every write is one event frame from WireWriter; text still buffered goes first
+class WireFrameSink : public OutputSink {
+public:
+    void write(const char* data, size_t length) override {
+        if (length == 0) {
+            return;
+        }
+        OutputBuffer& buffer = _enhancedUnityOutput;
+        SpinLockGuard guard(buffer.lock);
+        drainOutput(buffer);
+        CobsEncoder(outputSink()).frame((uint8_t)data[0], reinterpret_cast<const uint8_t*>(data) + 1, length - 1);
+    }
+    void flush() override { flushOutput(true); }
+};
+
+inline WireFrameSink& wireFrameSink() {
+    static WireFrameSink sink;
+    return sink;
+}
+
+// Turns result events into frames; attached by ENHANCED_UNITY_INIT()
+class WireReporter : public ResultReporter {
+public:
+    WireReporter() : ResultReporter(wireFrameSink()) {}
+
+    void hello() {
+        CobsEncoder(outputSink()).delimiter();
+        uint8_t flags = (sizeof(double) == 4 ? WIRE_HELLO_FLOAT_REALS : 0) |
+                        (ENHANCED_UNITY_TIMING ? WIRE_HELLO_TIMING : 0) |
+                        (ENHANCED_UNITY_MEMORY ? WIRE_HELLO_MEMORY : 0);
+        WireWriter frame(WIRE_HELLO);
+        frame.byte(kWireVersion).byte(ENHANCED_UNITY_VERBOSITY).byte(flags);
+        send(frame);
+    }
+
+    void beginFile(const char* suiteName, const char* fileName) override {
+        WireWriter frame(WIRE_FILE_START);
+        frame.string(suiteName, false, 64).string(fileName, false);
+        send(frame);
+    }
+
+    void beginMethod(const char* methodName) override {
+        methodId_ = methodId(methodName);
+        WireWriter frame(WIRE_METHOD_START);
+        frame.unsignedVarint(methodId_);
+        send(frame);
+    }
+
+    void assertion(const AssertionEvent& event) override {
+        const AssertRecord& record = event.record;
+        uint8_t fileId = announceFile(record.fileId);
+        WireWriter frame(WIRE_ASSERTION);
+        frame.byte(record.kind).byte(record.passed).byte(record.format).byte(record.flags);
+        frame.unsignedVarint(record.line).unsignedVarint(fileId);
+        switch (record.format) {
+        case FORMAT_BOOL:
+        case FORMAT_INT:
+        case FORMAT_HEX32:
+            frame.signedVarint(record.value.i.expected).signedVarint(record.value.i.actual);
+            break;
+        case FORMAT_SCOREBOARD:
+            frame.signedVarint(record.value.i.expected).signedVarint(record.value.i.actual);
+            frame.signedVarint(record.value.i.extra);
+            break;
+        case FORMAT_POINTER:
+            frame.unsignedVarint((uintptr_t)record.value.pointer);
+            break;
+        case FORMAT_STRING:
+            frame.unsignedVarint(record.value.s.expectedLength).unsignedVarint(record.value.s.actualLength);
+            frame.unsignedVarint(record.value.s.offset).unsignedVarint(record.value.s.line);
+            frame.unsignedVarint(record.value.s.column).byte(record.value.s.lead).byte(record.value.s.nulls);
+            frame.byte(record.value.s.expectedKept).byte(record.value.s.actualKept);
+            for (int i = 0; i < record.value.s.expectedKept; i++) {
+                frame.byte((uint8_t)record.value.s.expected[i]);
+            }
+            for (int i = 0; i < record.value.s.actualKept; i++) {
+                frame.byte((uint8_t)record.value.s.actual[i]);
+            }
+            break;
+        case FORMAT_FLOAT:
+            frame.real(record.value.f.expected).real(record.value.f.delta).real(record.value.f.actual);
+            break;
+        case FORMAT_REAL:
+            frame.real(record.value.f.expected).real(record.value.f.actual);
+            break;
+        case FORMAT_VALIDATION:
+            frame.signedVarint(record.value.v.expected).signedVarint(record.value.v.actual);
+            frame.string(record.value.v.operation, false);
+            break;
+        case FORMAT_ARRAY:
+            frame.unsignedVarint(record.value.a.count).unsignedVarint(record.value.a.mismatch);
+            frame.unsignedVarint(record.value.a.mismatches).unsignedVarint(record.value.a.windowStart);
+            frame.byte(record.value.a.elementSize).byte(record.value.a.windowBytes);
+            for (int i = 0; i < record.value.a.windowBytes; i++) {
+                frame.byte(record.value.a.expected[i]);
+            }
+            for (int i = 0; i < record.value.a.windowBytes; i++) {
+                frame.byte(record.value.a.actual[i]);
+            }
+            break;
+        case FORMAT_TOLERANCE:
+            frame.unsignedVarint(record.value.t.count).unsignedVarint(record.value.t.worst);
+            frame.unsignedVarint(record.value.t.outside).byte(record.value.t.mode);
+            frame.real(record.value.t.limit).real(record.value.t.expected).real(record.value.t.actual);
+            frame.real(record.value.t.worstError).real(record.value.t.rms);
+            break;
+        }
+        send(frame);
+    }
+
+    void endMethod(const MethodEvent& event) override {
+        uint8_t fileId = announceFile(internFile(event.fileName));
+        uint8_t flags = (event.memory != nullptr ? WIRE_METHOD_MEMORY : 0) |
+                        (event.abortReason != nullptr ? WIRE_METHOD_ABORTED : 0);
+        WireWriter frame(WIRE_METHOD_END);
+        frame.unsignedVarint(methodId_).unsignedVarint(fileId).byte(flags);
+        frame.unsignedVarint((uint32_t)event.assertions).unsignedVarint((uint32_t)event.failures);
+        frame.unsignedVarint(event.micros);
+        if (event.memory != nullptr) {
+            frame.signedVarint(event.memory->heapDelta).signedVarint(event.memory->heapPeak);
+            frame.signedVarint(event.memory->stackFree);
+        }
+        if (event.abortReason != nullptr) {
+            frame.string(event.abortReason, false);
+        }
+        send(frame);
+    }
+
+    void endFile(const FileEvent& event) override {
+        WireWriter frame(WIRE_FILE_END);
+        frame.string(event.suiteName, false, 96).string(event.fileName, false, 32);
+        frame.unsignedVarint((uint32_t)event.methods).unsignedVarint((uint32_t)event.methodFailures);
+        frame.unsignedVarint((uint32_t)event.assertions).unsignedVarint((uint32_t)event.failures);
+        frame.unsignedVarint(event.micros);
+        send(frame);
+        sink().flush();
+    }
+
+    void endRun(const RunEvent& event) override {
+        WireWriter frame(WIRE_RUN_END);
+        frame.unsignedVarint((uint32_t)event.files).unsignedVarint((uint32_t)event.fileFailures);
+        frame.unsignedVarint((uint32_t)event.methods).unsignedVarint((uint32_t)event.methodFailures);
+        frame.unsignedVarint((uint32_t)event.assertions).unsignedVarint((uint32_t)event.failures);
+        frame.unsignedVarint(event.micros);
+        send(frame);
+        sink().flush();
+    }
+
+private:
+    void send(const WireWriter& frame) { emit(reinterpret_cast<const char*>(frame.data), frame.length); }
+
+    void sendString(uint8_t table, uint32_t id, const char* name) {
+        WireWriter frame(WIRE_STRING);
+        frame.byte(table).unsignedVarint(id).string(name, true);
+        send(frame);
+    }
+
+    // File-table id, sending the name the first time it is used
+    uint8_t announceFile(uint8_t fileId) {
+        if (fileId < ENHANCED_UNITY_MAX_FILES && (filesSent_[fileId / 8] & (1u << (fileId % 8))) == 0) {
+            filesSent_[fileId / 8] |= (uint8_t)(1u << (fileId % 8));
+            sendString(WIRE_FILE_NAMES, fileId, fileNameForId(fileId));
+        }
+        return fileId;
+    }
+
+    // Method names are kept by pointer; a name seen again reuses its id
+    uint32_t methodId(const char* methodName) {
+        for (int i = 0; i < ENHANCED_UNITY_WIRE_METHODS; i++) {
+            if (methodNames_[i] == methodName && methodName != nullptr) {
+                return methodIds_[i];
+            }
+        }
+        uint32_t id = nextMethodId_++;
+        int slot = (int)(id % ENHANCED_UNITY_WIRE_METHODS);
+        methodNames_[slot] = methodName;
+        methodIds_[slot] = id;
+        sendString(WIRE_METHOD_NAMES, id, methodName != nullptr ? methodName : ENHANCED_UNITY_FLASH("<unknown>"));
+        return id;
+    }
+
+    uint8_t filesSent_[(ENHANCED_UNITY_MAX_FILES + 7) / 8] = {};
+    const char* methodNames_[ENHANCED_UNITY_WIRE_METHODS] = {};
+    uint32_t methodIds_[ENHANCED_UNITY_WIRE_METHODS] = {};
+    uint32_t nextMethodId_ = 0;
+    uint32_t methodId_ = 0;
+};
+
+// Attach the wire reporter (once) and announce the stream
+inline void startWireProtocol() {
+    static WireReporter reporter;
+    if (reporter.slot < 0) {
+        addReporter(&reporter);
+    }
+    reporter.hello();
+}
+
+#endif // ENHANCED_UNITY_WIRE_PROTOCOL
+
+#ifdef CONFIGMGR_NATIVE
+
+// ---- host side: used by tools/enhanced_unity_decode.cpp ----
+
+// Decode one COBS frame (without its delimiter) and check the CRC; returns
+// the length of type + fields, or 0 for a damaged frame
+inline size_t decodeWireFrame(const uint8_t* encoded, size_t length, uint8_t* out) {
+    size_t size = 0;
+    size_t i = 0;
+    while (i < length) {
+        uint8_t code = encoded[i++];
+        if (code == 0 || i + code - 1 > length) {
+            return 0;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            out[size++] = encoded[i++];
+        }
+        if (code < 0xFF && i < length) {
+            out[size++] = 0;
+        }
+    }
+    if (size < 2) {
+        return 0;
+    }
+    uint8_t crc = 0;
+    for (size_t k = 0; k + 1 < size; k++) {
+        crc = wireCrc8(crc, out[k]);
+    }
+    return crc == out[size - 1] ? size - 1 : 0;
+}
+
+// Reads the fields of a decoded frame; `ok` turns false on a short frame
+class WireReader {
+public:
+    WireReader(const uint8_t* data, size_t length) : position_(data), end_(data + length) {}
+
+    bool ok = true;
+
+    uint8_t byte() {
+        if (position_ >= end_) {
+            ok = false;
+            return 0;
+        }
+        return *position_++;
+    }
+
+    uint64_t unsignedVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t next = byte();
+            value |= (uint64_t)(next & 0x7F) << shift;
+            if ((next & 0x80) == 0) {
+                break;
+            }
+        }
+        return value;
+    }
+
+    int64_t signedVarint() {
+        uint64_t value = unsignedVarint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    double real(bool floatReals) {
+        uint8_t bits[8] = {};
+        size_t size = floatReals ? 4 : 8;
+        for (size_t i = 0; i < size; i++) {
+            bits[i] = byte();
+        }
+        if (floatReals) {
+            float value;
+            memcpy(&value, bits, sizeof(value));
+            return value;
+        }
+        double value;
+        memcpy(&value, bits, sizeof(value));
+        return value;
+    }
+
+    std::string string() {
+        size_t size = (size_t)unsignedVarint();
+        if (size > (size_t)(end_ - position_)) {
+            ok = false;
+            return std::string();
+        }
+        std::string text(reinterpret_cast<const char*>(position_), size);
+        position_ += size;
+        return text;
+    }
+
+    bool atEnd() const { return position_ >= end_; }
+
+private:
+    const uint8_t* position_;
+    const uint8_t* end_;
+};
+
+#endif // CONFIGMGR_NATIVE
+
+} // namespace enhanced_unity
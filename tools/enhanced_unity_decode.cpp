@@ -0,0 +1,409 @@
+// ============================================================================
+// enhanced_unity_decode: host decoder for ENHANCED_UNITY_WIRE_PROTOCOL
+// ============================================================================
+// Reads the framed byte stream a device built with ENHANCED_UNITY_WIRE_PROTOCOL
+// sends, prints the text report the device would have printed, and writes
+// JSON Lines / TAP / JUnit reports with the framework's own reporters.
+//
+//   enhanced_unity_decode [--baud=N] [--jsonl=PATH] [--junit=PATH] [--tap=PATH] [INPUT]
+//
+// INPUT is a captured byte stream, a serial port or a pty (switched to raw
+// mode at --baud, default ENHANCED_UNITY_SERIAL_BAUD); stdin when omitted or
+// "-". Decoding ends at the device's run-end frame (ENHANCED_UNITY_FINAL_SUMMARY)
+// or at end of input. Damaged frames are skipped and counted on stderr.
+//
+// Exit status: 0 all passed, 1 failures, 2 bad arguments, unreadable input or
+// a stream without run-end frame.
+//
+// Build on the host from the same enhanced_unity.hpp as the device, e.g.
+//   g++ -std=c++17 -DCONFIGMGR_NATIVE -I<unity>/src -Isrc
+//       tools/enhanced_unity_decode.cpp src/enhanced_unity.cpp -o enhanced_unity_decode
+// ============================================================================
+
+#include <enhanced_unity.hpp>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace enhanced_unity;
+
+// Largest encoded frame accepted; longer runs without delimiter are dropped
+const size_t kMaxEncodedFrame = 1 << 16;
+
+class WireDecoder {
+public:
+    // One frame without its delimiter
+    void frame(const std::vector<uint8_t>& encoded) {
+        decoded_.resize(encoded.size());
+        size_t length = decodeWireFrame(encoded.data(), encoded.size(), decoded_.data());
+        if (length == 0) {
+            damaged++;
+            return;
+        }
+        WireReader reader(decoded_.data() + 1, length - 1);
+        switch (decoded_[0]) {
+        case WIRE_HELLO: hello(reader); break;
+        case WIRE_TEXT: writeOutput(reinterpret_cast<const char*>(decoded_.data() + 1), length - 1); break;
+        case WIRE_STRING: string(reader); break;
+        case WIRE_ASSERTION: assertion(reader); break;
+        case WIRE_FILE_START: fileStart(reader); break;
+        case WIRE_METHOD_START: methodStart(reader); break;
+        case WIRE_METHOD_END: methodEnd(reader); break;
+        case WIRE_FILE_END: fileEnd(reader); break;
+        case WIRE_RUN_END: runEnd(reader); break;
+        default: damaged++; return;
+        }
+        if (!reader.ok) {
+            damaged++;
+        }
+    }
+
+    int damaged = 0;
+    bool finished = false;
+    bool failed = false;
+
+private:
+    void hello(WireReader& reader) {
+        uint8_t version = reader.byte();
+        verbosity_ = reader.byte();
+        floatReals_ = (reader.byte() & WIRE_HELLO_FLOAT_REALS) != 0;
+        if (reader.ok && version != kWireVersion) {
+            fprintf(stderr, "enhanced_unity_decode: wire version %u, expected %u\n", version, kWireVersion);
+        }
+    }
+
+    void string(WireReader& reader) {
+        uint8_t table = reader.byte();
+        uint32_t id = (uint32_t)reader.unsignedVarint();
+        std::string name = reader.string();
+        if (reader.ok) {
+            (table == WIRE_METHOD_NAMES ? methods_ : files_)[id] = name;
+        }
+    }
+
+    void assertion(WireReader& reader) {
+        AssertRecord record;
+        memset(&record, 0, sizeof(record));
+        record.kind = reader.byte();
+        record.passed = reader.byte();
+        record.format = reader.byte();
+        record.flags = reader.byte();
+        record.line = (uint16_t)reader.unsignedVarint();
+        uint32_t fileId = (uint32_t)reader.unsignedVarint();
+        record.fileId = (uint8_t)fileId;
+        switch (record.format) {
+        case FORMAT_BOOL:
+        case FORMAT_INT:
+        case FORMAT_HEX32:
+            record.value.i.expected = reader.signedVarint();
+            record.value.i.actual = reader.signedVarint();
+            break;
+        case FORMAT_SCOREBOARD:
+            record.value.i.expected = reader.signedVarint();
+            record.value.i.actual = reader.signedVarint();
+            record.value.i.extra = (int32_t)reader.signedVarint();
+            break;
+        case FORMAT_POINTER:
+            record.value.pointer = reinterpret_cast<const void*>((uintptr_t)reader.unsignedVarint());
+            break;
+        case FORMAT_STRING:
+            record.value.s.expectedLength = (TextLength)reader.unsignedVarint();
+            record.value.s.actualLength = (TextLength)reader.unsignedVarint();
+            record.value.s.offset = (TextLength)reader.unsignedVarint();
+            record.value.s.line = (TextLength)reader.unsignedVarint();
+            record.value.s.column = (TextLength)reader.unsignedVarint();
+            record.value.s.lead = reader.byte();
+            record.value.s.nulls = reader.byte();
+            record.value.s.expectedKept = reader.byte();
+            record.value.s.actualKept = reader.byte();
+            if (record.value.s.expectedKept > ENHANCED_UNITY_RECORD_STRING_LENGTH ||
+                record.value.s.actualKept > ENHANCED_UNITY_RECORD_STRING_LENGTH ||
+                record.value.s.lead > record.value.s.offset || record.value.s.lead > record.value.s.expectedKept ||
+                record.value.s.lead > record.value.s.actualKept) {
+                reader.ok = false;  // built with a longer ENHANCED_UNITY_RECORD_STRING_LENGTH
+                break;
+            }
+            for (int i = 0; i < record.value.s.expectedKept; i++) {
+                record.value.s.expected[i] = (char)reader.byte();
+            }
+            for (int i = 0; i < record.value.s.actualKept; i++) {
+                record.value.s.actual[i] = (char)reader.byte();
+            }
+            break;
+        case FORMAT_FLOAT:
+            record.value.f.expected = reader.real(floatReals_);
+            record.value.f.delta = reader.real(floatReals_);
+            record.value.f.actual = reader.real(floatReals_);
+            break;
+        case FORMAT_REAL:
+            record.value.f.expected = reader.real(floatReals_);
+            record.value.f.actual = reader.real(floatReals_);
+            break;
+        case FORMAT_VALIDATION:
+            record.value.v.expected = (int32_t)reader.signedVarint();
+            record.value.v.actual = (int32_t)reader.signedVarint();
+            copyRecordString(record.value.v.operation, reader.string().c_str());
+            break;
+        case FORMAT_ARRAY:
+            record.value.a.count = (uint32_t)reader.unsignedVarint();
+            record.value.a.mismatch = (uint32_t)reader.unsignedVarint();
+            record.value.a.mismatches = (uint32_t)reader.unsignedVarint();
+            record.value.a.windowStart = (uint32_t)reader.unsignedVarint();
+            record.value.a.elementSize = reader.byte();
+            record.value.a.windowBytes = reader.byte();
+            if (record.value.a.windowBytes > ENHANCED_UNITY_ARRAY_WINDOW) {
+                reader.ok = false;  // built with a wider ENHANCED_UNITY_ARRAY_WINDOW
+                break;
+            }
+            for (int i = 0; i < record.value.a.windowBytes; i++) {
+                record.value.a.expected[i] = reader.byte();
+            }
+            for (int i = 0; i < record.value.a.windowBytes; i++) {
+                record.value.a.actual[i] = reader.byte();
+            }
+            break;
+        case FORMAT_TOLERANCE:
+            record.value.t.count = (uint32_t)reader.unsignedVarint();
+            record.value.t.worst = (uint32_t)reader.unsignedVarint();
+            record.value.t.outside = (uint32_t)reader.unsignedVarint();
+            record.value.t.mode = reader.byte();
+            record.value.t.limit = reader.real(floatReals_);
+            record.value.t.expected = reader.real(floatReals_);
+            record.value.t.actual = reader.real(floatReals_);
+            record.value.t.worstError = reader.real(floatReals_);
+            record.value.t.rms = reader.real(floatReals_);
+            break;
+        default:
+            reader.ok = false;
+            break;
+        }
+        if (!reader.ok || record.kind >= ASSERT_KIND_COUNT) {
+            reader.ok = false;
+            return;
+        }
+        AssertionEvent event(record, name(methods_, methodId_), name(files_, fileId));
+        if (verbosity_ <= VERBOSITY_FAILING_ASSERTIONS) {
+            print(ENHANCED_UNITY_ASSERTION_LINE, statusText(event.passed), event.line, event.detail());
+        }
+        notifyAssertion(event);
+    }
+
+    void fileStart(WireReader& reader) {
+        suite_ = reader.string();
+        file_ = reader.string();
+        if (reader.ok) {
+            notifyFileStart(suite_.c_str(), file_.c_str());
+        }
+    }
+
+    void methodStart(WireReader& reader) {
+        methodId_ = (uint32_t)reader.unsignedVarint();
+        if (reader.ok) {
+            notifyMethodStart(name(methods_, methodId_));
+        }
+    }
+
+    void methodEnd(WireReader& reader) {
+        methodId_ = (uint32_t)reader.unsignedVarint();
+        uint32_t fileId = (uint32_t)reader.unsignedVarint();
+        uint8_t flags = reader.byte();
+        MethodMemory memory = { name(methods_, methodId_), 0, 0, ENHANCED_UNITY_STACK_UNKNOWN };
+        MethodEvent event = { memory.name, name(files_, fileId), 0, 0, 0, nullptr, nullptr };
+        event.assertions = (int)reader.unsignedVarint();
+        event.failures = (int)reader.unsignedVarint();
+        event.micros = (TimeMicros)reader.unsignedVarint();
+        if ((flags & WIRE_METHOD_MEMORY) != 0) {
+            memory.heapDelta = (int32_t)reader.signedVarint();
+            memory.heapPeak = (int32_t)reader.signedVarint();
+            memory.stackFree = (int32_t)reader.signedVarint();
+            event.memory = &memory;
+        }
+        std::string reason;
+        if ((flags & WIRE_METHOD_ABORTED) != 0) {
+            reason = reader.string();
+            event.abortReason = reason.c_str();
+        }
+        if (reader.ok) {
+            notifyMethodEnd(event);
+        }
+    }
+
+    void fileEnd(WireReader& reader) {
+        std::string suite = reader.string();
+        std::string file = reader.string();
+        FileEvent event = { suite.c_str(), file.c_str(), 0, 0, 0, 0, 0 };
+        event.methods = (int)reader.unsignedVarint();
+        event.methodFailures = (int)reader.unsignedVarint();
+        event.assertions = (int)reader.unsignedVarint();
+        event.failures = (int)reader.unsignedVarint();
+        event.micros = (TimeMicros)reader.unsignedVarint();
+        if (reader.ok) {
+            notifyFileEnd(event);
+        }
+    }
+
+    void runEnd(WireReader& reader) {
+        RunEvent event = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+        event.files = (int)reader.unsignedVarint();
+        event.fileFailures = (int)reader.unsignedVarint();
+        event.methods = (int)reader.unsignedVarint();
+        event.methodFailures = (int)reader.unsignedVarint();
+        event.assertions = (int)reader.unsignedVarint();
+        event.failures = (int)reader.unsignedVarint();
+        event.micros = (TimeMicros)reader.unsignedVarint();
+        if (reader.ok) {
+            notifyRunEnd(event);
+            finished = true;
+            failed = event.fileFailures > 0 || event.methodFailures > 0 || event.failures > 0;
+        }
+    }
+
+    static const char* name(const std::map<uint32_t, std::string>& table, uint32_t id) {
+        std::map<uint32_t, std::string>::const_iterator found = table.find(id);
+        return found != table.end() ? found->second.c_str() : "<unknown>";
+    }
+
+    std::vector<uint8_t> decoded_;
+    std::map<uint32_t, std::string> files_;
+    std::map<uint32_t, std::string> methods_;
+    std::string suite_;  // reporters keep the current suite by pointer
+    std::string file_;
+    uint32_t methodId_ = 0;
+    int verbosity_ = VERBOSITY_FAILING_ASSERTIONS;
+    bool floatReals_ = false;
+};
+
+speed_t baudConstant(long baud) {
+    switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+    default: return 0;
+    }
+}
+
+// Raw mode at `baud` for serial ports and ptys; other inputs are left alone
+bool configureTerminal(int fd, long baud) {
+    if (!isatty(fd)) {
+        return true;
+    }
+    speed_t speed = baudConstant(baud);
+    termios settings;
+    if (speed == 0 || tcgetattr(fd, &settings) != 0) {
+        fprintf(stderr, "enhanced_unity_decode: cannot set %ld baud\n", baud);
+        return false;
+    }
+    cfmakeraw(&settings);
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+    return tcsetattr(fd, TCSANOW, &settings) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* jsonLinesPath = nullptr;
+    const char* junitPath = nullptr;
+    const char* tapPath = nullptr;
+    long baud = ENHANCED_UNITY_SERIAL_BAUD;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--baud=", 7) == 0) {
+            baud = atol(argv[i] + 7);
+        } else if (strncmp(argv[i], "--jsonl=", 8) == 0) {
+            jsonLinesPath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--junit=", 8) == 0) {
+            junitPath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--tap=", 6) == 0) {
+            tapPath = argv[i] + 6;
+        } else if (input == nullptr && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+            input = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [--baud=N] [--jsonl=PATH] [--junit=PATH] [--tap=PATH] [INPUT]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int fd = input == nullptr || strcmp(input, "-") == 0 ? STDIN_FILENO : open(input, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "enhanced_unity_decode: cannot open %s\n", input);
+        return 2;
+    }
+    if (!configureTerminal(fd, baud)) {
+        return 2;
+    }
+
+    FileSink jsonLinesFile(jsonLinesPath);
+    FileSink junitFile(junitPath);
+    FileSink tapFile(tapPath);
+    JsonLinesReporter jsonLines(jsonLinesFile);
+    JUnitReporter junit(junitFile);
+    TapReporter tap(tapFile);
+    if ((jsonLinesPath != nullptr && !(jsonLinesFile.isOpen() && addReporter(&jsonLines))) ||
+        (junitPath != nullptr && !(junitFile.isOpen() && addReporter(&junit))) ||
+        (tapPath != nullptr && !(tapFile.isOpen() && addReporter(&tap)))) {
+        fprintf(stderr, "enhanced_unity_decode: cannot write a report file\n");
+        return 2;
+    }
+
+    WireDecoder decoder;
+    std::vector<uint8_t> encoded;
+    bool oversized = false;
+    uint8_t chunk[4096];
+    while (!decoder.finished) {
+        ssize_t received = read(fd, chunk, sizeof(chunk));
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < received && !decoder.finished; i++) {
+            if (chunk[i] != 0) {
+                if (encoded.size() < kMaxEncodedFrame) {
+                    encoded.push_back(chunk[i]);
+                } else {
+                    oversized = true;
+                }
+                continue;
+            }
+            if (oversized) {
+                decoder.damaged++;
+            } else if (!encoded.empty()) {
+                decoder.frame(encoded);
+            }
+            encoded.clear();
+            oversized = false;
+        }
+    }
+
+    flushOutput(true);
+    removeReporters();
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    if (decoder.damaged > 0) {
+        fprintf(stderr, "enhanced_unity_decode: %d damaged frame(s) skipped\n", decoder.damaged);
+    }
+    if (!decoder.finished) {
+        fprintf(stderr, "enhanced_unity_decode: input ended before the run summary\n");
+        return 2;
+    }
+    return decoder.failed ? 1 : 0;
+}
@@ -0,0 +1,441 @@
+// ============================================================================
+// enhanced_unity_merge: combine the result files of a sharded native run
+// ============================================================================
+// Each shard runs with --shard=I/N (or ENHANCED_UNITY_SHARD=I/N) and writes
+// its results with --jsonl=PATH. This tool reads those JSON Lines files and
+// prints the final summary the unsharded run would have printed: distinct
+// test files, method and assertion totals, wall time (the slowest shard),
+// summed method time and the slowest / hungriest methods across all shards.
+// Failed and aborted methods, and tests failed for being slower than their
+// timing history, are listed first.
+//
+//   enhanced_unity_merge [--jsonl=PATH] SHARD.jsonl...
+//
+// --jsonl=PATH writes one merged JSON Lines file: every shard's events in
+// argument order followed by a single run event with the merged totals.
+//
+// Exit status: 0 all passed, 1 failures, 2 bad arguments, an unreadable
+// file, a shard without run event (it did not finish), or shards that do
+// not form one complete 0..N-1 set.
+//
+// Build on the host from the same enhanced_unity.hpp as the tests, e.g.
+//   g++ -std=c++17 -DCONFIGMGR_NATIVE -I<unity>/src -Isrc
+//       tools/enhanced_unity_merge.cpp src/enhanced_unity.cpp -o enhanced_unity_merge
+// ============================================================================
+
+#include <enhanced_unity.hpp>
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace enhanced_unity;
+
+// One flat JSON object as written by JsonLinesReporter: string and integer
+// members only
+class JsonObject {
+public:
+    bool parse(const std::string& text) {
+        text_ = &text;
+        position_ = 0;
+        strings_.clear();
+        numbers_.clear();
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return atEnd();
+        }
+        do {
+            std::string key;
+            if (!string(key) || !consume(':')) {
+                return false;
+            }
+            skipSpace();
+            if (peek() == '"') {
+                if (!string(strings_[key])) {
+                    return false;
+                }
+            } else if (!number(numbers_[key])) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}') && atEnd();
+    }
+
+    std::string text(const char* key) const {
+        std::map<std::string, std::string>::const_iterator found = strings_.find(key);
+        return found != strings_.end() ? found->second : std::string();
+    }
+
+    long long number(const char* key, long long fallback = 0) const {
+        std::map<std::string, long long>::const_iterator found = numbers_.find(key);
+        return found != numbers_.end() ? found->second : fallback;
+    }
+
+    bool has(const char* key) const { return numbers_.count(key) != 0 || strings_.count(key) != 0; }
+
+private:
+    char peek() const { return position_ < text_->size() ? (*text_)[position_] : '\0'; }
+
+    void skipSpace() {
+        while (position_ < text_->size() && isspace((unsigned char)(*text_)[position_])) {
+            position_++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (peek() != c) {
+            return false;
+        }
+        position_++;
+        return true;
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return position_ == text_->size();
+    }
+
+    bool string(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (position_ < text_->size()) {
+            char c = (*text_)[position_++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (position_ >= text_->size()) {
+                return false;
+            }
+            char escape = (*text_)[position_++];
+            switch (escape) {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                if (position_ + 4 > text_->size()) {
+                    return false;
+                }
+                unsigned long code = strtoul(text_->substr(position_, 4).c_str(), nullptr, 16);
+                position_ += 4;
+                appendUtf8(out, code);
+                break;
+            }
+            default: out += escape; break;
+            }
+        }
+        return false;
+    }
+
+    static void appendUtf8(std::string& out, unsigned long code) {
+        if (code < 0x80) {
+            out += (char)code;
+        } else if (code < 0x800) {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        } else {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool number(long long& out) {
+        skipSpace();
+        const char* start = text_->c_str() + position_;
+        char* end = nullptr;
+        out = strtoll(start, &end, 10);
+        if (end == start) {
+            return false;
+        }
+        position_ += (size_t)(end - start);
+        return true;
+    }
+
+    const std::string* text_ = nullptr;
+    size_t position_ = 0;
+    std::map<std::string, std::string> strings_;
+    std::map<std::string, long long> numbers_;
+};
+
+struct FileResult {
+    bool failed = false;
+};
+
+struct ShardResult {
+    std::string path;
+    std::vector<std::string> lines;  // every event but the run event
+    bool finished = false;
+    long long shardIndex = -1;
+    long long shardCount = 0;
+};
+
+class ShardMerger {
+public:
+    // False if the file cannot be read; an unfinished shard is only noted
+    bool read(const char* path) {
+        FILE* file = fopen(path, "r");
+        if (file == nullptr) {
+            fprintf(stderr, "enhanced_unity_merge: cannot read %s\n", path);
+            return false;
+        }
+        clearPending();
+        ShardResult shard;
+        shard.path = path;
+        std::string line;
+        char chunk[4096];
+        while (fgets(chunk, sizeof(chunk), file) != nullptr) {
+            line += chunk;
+            if (line.empty() || line.back() != '\n') {
+                continue;  // longer than one chunk
+            }
+            event(shard, line);
+            line.clear();
+        }
+        if (!line.empty()) {
+            event(shard, line + "\n");  // torn last line of a crashed shard
+        }
+        fclose(file);
+        shards_.push_back(shard);
+        return true;
+    }
+
+    // Report and fold the shards into the counters; false if the set is
+    // incomplete
+    bool merge(OutputSink* mergedLines) {
+        bool complete = checkShards();
+        for (const ShardResult& shard : shards_) {
+            if (mergedLines != nullptr && shard.finished) {
+                for (const std::string& line : shard.lines) {
+                    mergedLines->write(line.data(), line.size());
+                }
+            }
+        }
+        for (const std::string& failure : failures_) {
+            print("%s\n", failure.c_str());
+        }
+        CounterContext& c = counters();
+        c.testCount = (int)files_.size();
+        c.testFailureCount = 0;
+        for (const auto& item : files_) {
+            c.testFailureCount += item.second.failed ? 1 : 0;
+        }
+        c.methodTotalCount = (int)totals_.methods;
+        c.methodTotalFailureCount = (int)totals_.methodFailures;
+        c.mergedAssertions = (int)totals_.assertions;
+        c.mergedAssertionFailures = (int)totals_.failures;
+        c.historyFailureCount = (int)totals_.historyFailures;
+        c.methodTotalMicros = (TimeMicros)methodMicros_;
+        c.runStartMicros = nowMicros() - (TimeMicros)wallMicros_;  // summary prints now - start
+        return complete;
+    }
+
+private:
+    struct Totals {
+        long long methods = 0;
+        long long methodFailures = 0;
+        long long assertions = 0;
+        long long failures = 0;
+        long long historyFailures = 0;
+    };
+
+    void event(ShardResult& shard, const std::string& line) {
+        JsonObject object;
+        if (!object.parse(line)) {
+            damaged_++;
+            return;
+        }
+        std::string kind = object.text("event");
+        if (kind == "run") {
+            shard.finished = true;
+            shard.shardIndex = object.number("shard", -1);
+            shard.shardCount = object.number("shards", 0);
+            pending_.methods += object.number("methods");
+            pending_.methodFailures += object.number("method_failures");
+            pending_.assertions += object.number("assertions");
+            pending_.failures += object.number("failures");
+            pending_.historyFailures += object.number("history_failures");
+            if (object.number("micros") > wallMicros_) {
+                wallMicros_ = object.number("micros");
+            }
+            commit();
+            return;
+        }
+        shard.lines.push_back(line);
+        if (kind == "file") {
+            pendingFiles_.push_back(std::make_pair(object.text("suite") + '\n' + object.text("file"),
+                                                   object.number("method_failures") > 0));
+        } else if (kind == "method") {
+            method(object);
+        } else if (kind == "history" && object.text("status") == "failed") {
+            pendingFailures_.push_back("[FAILED]      - " + object.text("method") + " (timing history) : " +
+                                       object.text("detail"));
+        }
+    }
+
+    void method(const JsonObject& object) {
+        names_.push_back(object.text("method"));
+        const char* name = names_.back().c_str();
+        TimeMicros micros = (TimeMicros)object.number("micros");
+        pendingMicros_ += (long long)micros;
+        MethodTiming timing = { name, micros };
+        pendingSlowest_.push_back(timing);
+        if (object.has("heap_peak")) {
+            MethodMemory memory = { name, (int32_t)object.number("heap_peak"), (int32_t)object.number("heap_delta"),
+                                    (int32_t)object.number("stack_free", ENHANCED_UNITY_STACK_UNKNOWN) };
+            pendingHungriest_.push_back(memory);
+        }
+        std::string status = object.text("status");
+        if (status != "passed") {
+            std::string failure = status == "aborted" ? "[ABORTED]     - " : "[FAILED]      - ";
+            failure += object.text("method") + " (" + object.text("file") + ")";
+            if (status == "aborted") {
+                failure += " : " + object.text("reason");
+            }
+            pendingFailures_.push_back(failure);
+        }
+    }
+
+    // A shard's events count once its run event has been read
+    void commit() {
+        totals_.methods += pending_.methods;
+        totals_.methodFailures += pending_.methodFailures;
+        totals_.assertions += pending_.assertions;
+        totals_.failures += pending_.failures;
+        totals_.historyFailures += pending_.historyFailures;
+        methodMicros_ += pendingMicros_;
+        for (const auto& file : pendingFiles_) {
+            files_[file.first].failed = files_[file.first].failed || file.second;
+        }
+        for (const MethodTiming& timing : pendingSlowest_) {
+            counters().slowestMethods.add(timing);
+        }
+        for (const MethodMemory& memory : pendingHungriest_) {
+            counters().hungriestMethods.add(memory);
+        }
+        failures_.insert(failures_.end(), pendingFailures_.begin(), pendingFailures_.end());
+        clearPending();
+    }
+
+    void clearPending() {
+        pending_ = Totals();
+        pendingMicros_ = 0;
+        pendingFiles_.clear();
+        pendingSlowest_.clear();
+        pendingHungriest_.clear();
+        pendingFailures_.clear();
+    }
+
+    bool checkShards() {
+        bool complete = true;
+        long long count = -1;
+        std::set<long long> seen;
+        for (const ShardResult& shard : shards_) {
+            if (!shard.finished) {
+                fprintf(stderr, "enhanced_unity_merge: %s has no run event; the shard did not finish\n",
+                        shard.path.c_str());
+                complete = false;
+                continue;
+            }
+            if (count >= 0 && shard.shardCount != count) {
+                fprintf(stderr, "enhanced_unity_merge: %s is shard %lld/%lld, others are of %lld\n",
+                        shard.path.c_str(), shard.shardIndex, shard.shardCount, count);
+                complete = false;
+            }
+            count = shard.shardCount;
+            if (shard.shardCount > 0 && !seen.insert(shard.shardIndex).second) {
+                fprintf(stderr, "enhanced_unity_merge: shard %lld/%lld given twice (%s)\n",
+                        shard.shardIndex, shard.shardCount, shard.path.c_str());
+                complete = false;
+            }
+        }
+        for (long long index = 0; index < count; index++) {
+            if (seen.count(index) == 0) {
+                fprintf(stderr, "enhanced_unity_merge: shard %lld/%lld is missing\n", index, count);
+                complete = false;
+            }
+        }
+        if (damaged_ > 0) {
+            fprintf(stderr, "enhanced_unity_merge: %d malformed line(s) skipped\n", damaged_);
+        }
+        return complete;
+    }
+
+    std::vector<ShardResult> shards_;
+    std::map<std::string, FileResult> files_;  // "suite\nfile"
+    std::deque<std::string> names_;            // summary entries keep names by pointer
+    std::vector<std::string> failures_;
+    Totals totals_;
+    long long methodMicros_ = 0;
+    long long wallMicros_ = 0;
+    int damaged_ = 0;
+
+    // Events of the shard being read
+    Totals pending_;
+    long long pendingMicros_ = 0;
+    std::vector<std::pair<std::string, bool>> pendingFiles_;
+    std::vector<MethodTiming> pendingSlowest_;
+    std::vector<MethodMemory> pendingHungriest_;
+    std::vector<std::string> pendingFailures_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* jsonLinesPath = nullptr;
+    std::vector<const char*> inputs;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--jsonl=", 8) == 0) {
+            jsonLinesPath = argv[i] + 8;
+        } else if (argv[i][0] != '-') {
+            inputs.push_back(argv[i]);
+        } else {
+            inputs.clear();
+            break;
+        }
+    }
+    if (inputs.empty()) {
+        fprintf(stderr, "usage: %s [--jsonl=PATH] SHARD.jsonl...\n", argv[0]);
+        return 2;
+    }
+
+    ENHANCED_UNITY_INIT();
+    shardSpec() = ShardSpec();  // the merged report is the whole suite
+    ShardMerger merger;
+    for (const char* input : inputs) {
+        if (!merger.read(input)) {
+            return 2;
+        }
+    }
+
+    FileSink jsonLinesFile(jsonLinesPath);
+    JsonLinesReporter jsonLines(jsonLinesFile);
+    if (jsonLinesPath != nullptr && !(jsonLinesFile.isOpen() && addReporter(&jsonLines))) {
+        fprintf(stderr, "enhanced_unity_merge: cannot write %s\n", jsonLinesPath);
+        return 2;
+    }
+    bool complete = merger.merge(jsonLinesPath != nullptr ? &jsonLinesFile : nullptr);
+    reportFinalSummary();
+    flushOutput(true);
+    removeReporters();
+    if (!complete) {
+        return 2;
+    }
+    const CounterContext& c = counters();
+    return c.testFailureCount > 0 || c.methodTotalFailureCount > 0 || c.totalAssertionFailures() > 0 ||
+                   c.historyFailureCount > 0 ? 1 : 0;
+}